@@ -4,6 +4,7 @@
  */
 
 #include <iostream>
+#include <iomanip>
 #include <fstream>
 #include <nmeaparse/nmea.h>
 
@@ -42,6 +43,11 @@ int main(int argc, char** argv){
 		cout << "\t\t\tPosition: " << gps.fix.latitude << "'N, " << gps.fix.longitude << "'E" << endl << endl;
 	};
 
+	// (optional) - Handle sentences the GPS service could not use, or only partly.
+	gps.onDecodeError += [](const NMEASentence& n, DecodeResult r){
+		cout << "GPS Data Bad Format [$" << n.name << "] :: " << decodeStatusToString(r.status) << endl << endl;
+	};
+
 	// (optional) - Handle events when the parser receives each sentence
 	parser.onSentence += [&gps](const NMEASentence& n){
 		cout << "Received " << (n.checksumOK() ? "good" : "bad") << " GPS Data: " << n.name << endl;
@@ -110,10 +116,10 @@ int main(int argc, char** argv){
 		cout << "Handling $" << n.name << ":" << endl;
 		for (size_t i = 0; i < n.parameters.size(); ++i){
 			cout << "    [" << i << "] \t- " << n.parameters[i];
-			try {
-				double num = parseDouble(n.parameters[i]);
+			double num;
+			if (tryParseDouble(n.parameters[i], num)){
 				cout << "      (number: " << num << ")";
-			} catch (NumberConversionError&){
+			} else {
 				cout << " (string)";
 			}
 			cout << endl;
@@ -158,6 +164,68 @@ int main(int argc, char** argv){
 
 
 
+	// --------------------------------------------------------
+	// ---------------   SCHEMA DECODING  ---------------------
+	// --------------------------------------------------------
+	// Or describe the layout of your sentences in a config file
+	// and let the schema registry decode them. New sentences
+	// need no code, just a line in the config.
+
+	NMEAParser schema_parser;
+	SchemaRegistry schemas;
+	string error;
+	if (!schemas.loadFile("nmea_schemas.txt", &error)){
+		cout << error << endl;
+	}
+	schemas.attachToParser(schema_parser);
+	schemas.onRecord += [](const SchemaRecord& r){
+		cout << "Decoded $" << r.layout->key() << ((r.status == DecodeStatus::OK) ? "" : " (with errors)") << ":" << endl;
+		for (size_t i = 0; i < r.layout->fields.size(); ++i){
+			const SentenceLayout::FieldSpec& f = r.layout->fields[i];
+			cout << "    " << f.name << " \t- ";
+			if (!r.has(i)){
+				cout << "(missing)";
+			}
+			else if (f.type == FieldType::Double){
+				cout << r.getDouble(i);
+			}
+			else if (f.type == FieldType::Text){
+				cout << r.getText(i);
+			}
+			else if (f.type == FieldType::Char){
+				cout << (char)r.getInt(i);
+			}
+			else if (f.type == FieldType::Time){
+				int64_t ms = r.getInt(i) / 1000000;		// hh:mm:ss.sss
+				cout << setfill('0') << setw(2) << ms / 3600000 << ":" << setw(2) << ms / 60000 % 60 << ":"
+					<< setw(2) << ms / 1000 % 60 << "." << setw(3) << ms % 1000 << setfill(' ');
+			}
+			else if (f.type == FieldType::Date){
+				int64_t ddmmyy = r.getInt(i);		// dd/mm/yy
+				cout << setfill('0') << setw(2) << ddmmyy / 10000 << "/" << setw(2) << ddmmyy / 100 % 100 << "/"
+					<< setw(2) << ddmmyy % 100 << setfill(' ');
+			}
+			else {
+				cout << r.getInt(i);
+			}
+			cout << endl;
+		}
+	};
+
+	cout << "-------- Reading NMEA data with schemas --------" << endl;
+
+	schema_parser.readLine("$MYNMEA,1,3,3,7,Hello*7B");
+	schema_parser.readLine("$PSSN,HRP,120010.10,080822,12.3,45.6,78.9,12.3,45.6,78.9,10,0,12.3,E*3F");
+
+
+
+
+
+
+
+
+
+
 	// --------------------------------------------------------
 	// ---------------   NMEA SENTENCE GENERATION  ------------
 	// --------------------------------------------------------
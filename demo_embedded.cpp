@@ -0,0 +1,87 @@
+/*
+ * demo_embedded.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// The header-only parser as on a microcontroller: built with -fno-exceptions -fno-rtti and
+// not linked to the library. The log file stands in for the UART.
+
+#include <cstdio>
+#include <nmeaparse/EmbeddedParser.h>
+
+using namespace nmea;
+
+namespace {
+
+	struct Position {
+		int64_t latitude{0};		// nanominutes
+		int64_t longitude{0};
+		int32_t quality{0};
+		int32_t satellites{0};
+		unsigned updates{0};
+	};
+
+	void print(const char* what, const Position& p){
+		printf("%s  lat %.6f, lon %.6f  quality %d  sats %d\n", what,
+			p.latitude / 60e9, p.longitude / 60e9, (int)p.quality, (int)p.satellites);
+	}
+
+	void onGGA(const EmbeddedSentence& s, void* context){
+		Position& p = *(Position*)context;
+		if (!s.coordinate(1, p.latitude) || !s.coordinate(3, p.longitude)){
+			return;
+		}
+		s.integer(5, p.quality);
+		s.integer(6, p.satellites);
+		p.updates++;
+		print("GGA", p);
+	}
+
+	void onRMC(const EmbeddedSentence& s, void* context){
+		Position& p = *(Position*)context;
+		char status;
+		if (!s.character(1, status) || status != 'A'){
+			return;
+		}
+		if (s.coordinate(2, p.latitude) && s.coordinate(4, p.longitude)){
+			p.updates++;
+			print("RMC", p);
+		}
+	}
+
+}
+
+int main(int argc, char** argv){
+	const char* path = argc > 1 ? argv[1] : "nmea_log.txt";
+	FILE* file = fopen(path, "rb");
+	if (file == nullptr){
+		printf("Could not open file: %s\n", path);
+		return 1;
+	}
+
+	static EmbeddedParser<> parser;		// 96 byte lines, 24 fields, 16 handlers
+	static Position position;
+	parser.setHandler("--GGA", onGGA, &position);		// any talker
+	parser.setHandler("--RMC", onRMC, &position);
+
+	uint8_t chunk[64];
+	size_t n;
+	while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0){
+		parser.readBuffer(chunk, n);
+	}
+	fclose(file);
+
+	static const char* names[] = { "OK", "Pending", "NoStart", "TooLong", "TooManyFields",
+		"BadName", "NoChecksum", "BadChecksum", "Unhandled" };
+	printf("\nParser: %u bytes, %u position updates\n", (unsigned)sizeof(parser), position.updates);
+	for (size_t i = 0; i < (size_t)EmbeddedStatus::COUNT; i++){
+		if (i != (size_t)EmbeddedStatus::Pending){
+			printf("  %-14s %u\n", names[i], (unsigned)parser.statusCount((EmbeddedStatus)i));
+		}
+	}
+
+	return 0;
+}
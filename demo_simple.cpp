@@ -38,6 +38,13 @@ int main(int argc, char** argv){
 
 
 
+	// (optional) - Handle sentences the GPS service could not use, or only partly.
+	gps.onDecodeError += [](const NMEASentence& n, DecodeResult r){
+		cout << "GPS Data Bad Format [$" << n.name << "] :: " << decodeStatusToString(r.status) << endl << endl;
+	};
+
+
+
 	// -- STREAM THE DATA  ---
 
 	// From a buffer in memory...
@@ -0,0 +1,136 @@
+/*
+ * AIS.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// AIS messages from !AIVDM (other vessels) and !AIVDO (own vessel) sentences:
+//
+//     !AIVDM,2,1,7,A,<6 bit armored payload>,0*hh     fragments, sequence id, channel, payload, fill bits
+//
+// Messages split over several sentences are put back together in a fixed set of slots, one
+// per sequence id (0-9) for each of VDM and VDO, so memory stays bounded whatever the feed.
+// A message whose next fragment does not follow in time, or in order, is dropped and counted.
+//
+// Payloads are unpacked with a lookup table, four characters to three bytes, and fields are
+// read with 64 bit loads. Position reports (types 1, 2, 3 for class A, 18 and 19 for class B)
+// are decoded into AISPositionReport; other types are available as bits.
+//
+// The decoder reads the text of the sentences without allocating: feed it from an NMEAParser
+// (attachToParser) or, for busy feeds, straight from a StreamDemultiplexer:
+//
+//     demux.onSentence += [&ais](std::string_view s){ ais.readSentence(s); };
+
+#ifndef AIS_H_
+#define AIS_H_
+
+#include <nmeaparse/NMEAParser.h>
+#include <nmeaparse/Clock.h>
+#include <nmeaparse/Event.h>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+namespace nmea {
+
+	// Values as sent, in their units; each field has a "not available" value.
+	struct AISPositionReport {
+		uint32_t mmsi{0};
+		int32_t longitude{0x6791AC0};	// 1/10000 arc minutes E, 181 degrees if not available
+		int32_t latitude{0x3412140};	// 1/10000 arc minutes N, 91 degrees if not available
+		uint16_t speed{1023};			// 0.1 knots over ground, 1023 n/a
+		uint16_t course{3600};			// 0.1 degrees over ground, 3600 n/a
+		uint16_t heading{511};			// degrees true, 511 n/a
+		int8_t rateOfTurn{-128};		// class A, ROT indicator (4.733 sqrt(degrees/min)), -128 n/a
+		uint8_t type{0};				// 1, 2, 3, 18 or 19
+		uint8_t repeat{0};
+		uint8_t navigationStatus{15};	// class A, 0 under way using engine... 15 not defined
+		uint8_t second{60};				// UTC second of the report, 60 n/a
+		bool accuracy{false};			// better than 10 m
+		bool raim{false};
+		bool own{false};				// from a VDO sentence
+
+		bool classB() const					{ return type == 18 || type == 19; }
+		bool hasPosition() const			{ return longitude != 0x6791AC0 && latitude != 0x3412140; }
+		int64_t latitudeNanoMinutes() const	{ return (int64_t)latitude * 100000; }		// as in GPSFix
+		int64_t longitudeNanoMinutes() const{ return (int64_t)longitude * 100000; }
+		double latitudeDegrees() const		{ return latitude / 600000.; }
+		double longitudeDegrees() const		{ return longitude / 600000.; }
+	};
+
+	// The static part of a type 19 report (class B extended).
+	struct AISVesselInfo {
+		char name[21]{};				// up to the '@' padding, without trailing spaces
+		uint8_t shipType{0};
+		uint16_t toBow{0};				// meters from the position reference
+		uint16_t toStern{0};
+		uint8_t toPort{0};
+		uint8_t toStarboard{0};
+		uint8_t epfd{0};				// position fixing device, 1 GPS...
+	};
+
+
+	class AISDecoder {
+	public:
+		static constexpr size_t MAX_BITS = 1024;		// longer messages are dropped
+		static constexpr size_t MAX_PAYLOAD = MAX_BITS / 6;
+
+	private:
+		struct Slot {
+			char payload[MAX_PAYLOAD];
+			size_t length{0};
+			uint8_t fragments{0};		// of the message, 0 if the slot is free
+			uint8_t next{0};			// the fragment expected
+			char channel{0};
+			int64_t started{0};
+		};
+
+		Slot slots[2][11];				// VDM and VDO, by sequence id, and one for messages without
+		uint8_t bits[MAX_BITS / 8 + 8];	// the payload being decoded, padded for 64 bit loads
+		size_t bitCount{0};
+		const Clock* timeSource{&Clock::system()};
+
+		uint64_t messages{0};
+		uint64_t badSentences{0};
+		uint64_t dropped{0};
+
+		bool decodePayload(const char* payload, size_t length, unsigned fillBits, bool own);
+		uint32_t field(size_t position, unsigned width) const;
+		int32_t signedField(size_t position, unsigned width) const;
+
+	public:
+		int64_t fragmentTimeout{2000000000};	// nanoseconds between the first and the last fragment
+
+		// Every message, as its type and packed bits (most significant first), then the
+		// events of the types decoded.
+		Event<void(uint8_t type, const uint8_t* bits, size_t bitCount, bool own)> onMessage;
+		Event<void(const AISPositionReport&)> onPositionReport;
+		Event<void(const AISPositionReport&, const AISVesselInfo&)> onVesselInfo;	// type 19, after its position report
+
+		AISDecoder();
+		virtual ~AISDecoder();
+
+		// Time source for the fragment timeouts, the system clock by default. It must outlive the decoder.
+		void setClock(const Clock& clock);
+
+		// Handles the VDM and VDO sentences of the usual AIS talkers (AI, AB, AN, AS, BS...).
+		void attachToParser(NMEAParser& parser);
+
+		// A whole sentence, with or without its line end. False if it is not a valid VDM or VDO
+		// sentence; true for fragments, whether or not they complete a message.
+		bool readSentence(std::string_view text);
+
+		uint64_t messageCount() const			{ return messages; }		// complete messages
+		uint64_t badSentenceCount() const		{ return badSentences; }	// checksums, fields, armoring
+		uint64_t droppedCount() const			{ return dropped; }			// incomplete messages, and fragments without their start
+
+		// Packs 6 bit armored characters, 4 to 3 bytes. Returns the bits written, or SIZE_MAX if a
+		// character is not armoring. out needs (length * 6 + 7) / 8 bytes.
+		static size_t unarmor(const char* payload, size_t length, uint8_t* out);
+	};
+
+}
+
+#endif /* AIS_H_ */
@@ -0,0 +1,217 @@
+/*
+ * Archive.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Binary archive of fixes and sentences, a compact replacement for text logs.
+//
+// File layout, all integers little endian:
+//
+//     file header     8 bytes     "NMTA", uint16 version (1), uint16 reserved (0)
+//     block*
+//
+//     block header    40 bytes    uint32 magic "NBLK"
+//                                 uint32 payload size in bytes
+//                                 uint32 fix records
+//                                 uint32 sentence records
+//                                 int64  first time, UTC nanoseconds (earliest dated record,
+//                                        INT64_MAX if none)
+//                                 int64  last time, UTC nanoseconds (latest dated record,
+//                                        INT64_MIN if none)
+//                                 uint32 CRC-32 of the payload
+//                                 uint32 reserved (0)
+//     payload         records, each starting with a tag byte
+//
+// Numbers in records are LEB128 varints, signed ones zigzag encoded, and all of them are
+// deltas from the previous record of the same kind in the block (from 0 for the first one),
+// so each block decodes on its own.
+//
+//     fix (tag 1)         time, receiveTime, latitude, longitude (1e-9 arc minutes),
+//                         altitude (mm), speed (1e-3 km/h), travelAngle, heading, roll,
+//                         pitch (1e-3 degrees), horizontalDilution (1e-2),
+//                         then 4 bytes: status, quality, type, satellites
+//     sentence (tag 2)    time (the fix time when it was received), 1 byte flags
+//                         (bit 0: had a checksum, bit 1: checksum was OK, bit 2: started
+//                         with '!' rather than '$'), the received
+//                         checksum byte if it had one, 1 byte name
+//                         length + name, parameter count, then for each parameter 0 if it
+//                         is the same as in the previous sentence of that name in the block,
+//                         else its length + 1 and its text
+//
+// Fix values other than the times and position are rounded to the resolutions above.
+
+#ifndef ARCHIVE_H_
+#define ARCHIVE_H_
+
+#include <nmeaparse/GPSFix.h>
+#include <nmeaparse/NMEAParser.h>
+#include <nmeaparse/MappedFile.h>
+#include <nmeaparse/Event.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <ostream>
+#include <fstream>
+#include <memory>
+#include <limits>
+
+namespace nmea {
+
+	class GPSService;
+
+	// A sentence read back from an archive. The views point into the mapped file.
+	struct ArchivedSentence {
+		int64_t time{0};
+		char start{'$'};				// or '!', as AIS sentences
+		bool hasChecksum{false};
+		bool checksumOK{false};
+		uint8_t checksum{0};			// as received
+		std::string_view name;
+		std::vector<std::string_view> parameters;
+
+		std::string text() const;		// "$name,p1,p2*hh" (or "!...") as received
+	};
+
+
+	class ArchiveWriter {
+	private:
+		std::unique_ptr<std::ofstream> file;
+		std::ostream* out{nullptr};
+		size_t blockBytes;
+
+		// open block
+		std::string payload;
+		uint32_t fixCount{0};
+		uint32_t sentenceCount{0};
+		int64_t firstTime{std::numeric_limits<int64_t>::max()};
+		int64_t lastTime{std::numeric_limits<int64_t>::min()};
+		int64_t previousFix[11]{};
+		int64_t previousSentenceTime{0};
+		std::unordered_map<std::string, std::vector<std::string>> previousParameters;	// by sentence name
+
+		size_t blocks{0};
+		uint64_t bytes{0};
+
+		// attached sources
+		GPSService* service{nullptr};
+		NMEAParser* parser{nullptr};
+		EventHandler<void()> updateHandler;
+		EventHandler<void(const NMEASentence&)> sentenceHandler;
+		FixRecord pending;
+		bool hasPending{false};
+		int64_t currentTime{NO_TIME};	// time of the latest fix, stamped on sentences
+
+		// records from the attached sources, held while the service has no date yet
+		struct HeldRecord {
+			int64_t time;							// undated, NO_TIME before the first fix
+			FixRecord fix;							// when there is no sentence
+			std::unique_ptr<NMEASentence> sentence;
+		};
+		std::vector<HeldRecord> held;
+		bool dated{false};						// the service has read a date
+		int64_t undatedDays{0};					// midnights passed while waiting for it
+		int64_t lastTimeOfDay{-1};
+
+		void beginRecord(int64_t time, bool timed = true);
+		void endRecord();
+		void writeFix(const FixRecord& fix, bool timed);
+		void writeSentence(const NMEASentence& nmea, int64_t time, bool timed);
+		void holdOrWrite(const FixRecord& fix);
+		void holdOrWrite(const NMEASentence& nmea);
+		void writeHeld(int64_t shift, bool timed);
+		void detachService();
+
+	public:
+		static constexpr int64_t NO_TIME = std::numeric_limits<int64_t>::min();
+
+		// Records held at most while waiting for the date, after which they are written undated.
+		size_t holdLimit{100000};
+
+		explicit ArchiveWriter(size_t blockBytes = 64 * 1024);
+		ArchiveWriter(const ArchiveWriter&) = delete;
+		ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+		virtual ~ArchiveWriter();
+
+		bool open(const std::string& path);		// creates or truncates the file and writes the header
+		bool open(std::ostream& stream);
+		bool good() const;
+
+		void writeFix(const FixRecord& fix);
+		void writeSentence(const NMEASentence& nmea, int64_t time);
+
+		void flush();					// writes the open block, if any
+		void close();					// writes the pending fix and the open block, then detaches
+
+		size_t blocksWritten() const	{ return blocks; }
+		uint64_t bytesWritten() const	{ return bytes; }
+
+		// Writes one fix per receiver epoch: updates with the same UTC time refine the pending fix,
+		// which is written when the next epoch starts or on close().
+		// Until the service reads a date (RMC, ZDA...) its fixes only have a time of day, so they
+		// and the sentences are held, then written back-dated when it comes. Records still undated
+		// on close() or past holdLimit keep their time of day on Jan 1, 1970, and do not count in
+		// the time range of their block.
+		void attachToService(GPSService& gps);
+		// Writes every sentence the parser reads, stamped with the time of the latest fix.
+		// Without a service the sentences are undated.
+		void attachToParser(NMEAParser& parser);
+		void detach();
+	};
+
+
+	class ArchiveReader {
+	public:
+		struct BlockInfo {
+			uint64_t offset;			// of the payload in the file
+			uint32_t payloadBytes;
+			uint32_t fixCount;
+			uint32_t sentenceCount;
+			int64_t firstTime;
+			int64_t lastTime;
+			uint32_t crc;
+		};
+
+		typedef std::function<void(const FixRecord&)> FixHandler;
+		typedef std::function<void(const ArchivedSentence&)> SentenceHandler;
+
+	private:
+		MappedFile file;
+		std::vector<BlockInfo> index;
+		bool truncated{false};
+
+	public:
+		bool verifyChecksums{true};		// check the CRC of each block before decoding it
+
+		ArchiveReader();
+		virtual ~ArchiveReader();
+
+		// Maps the file and reads the block headers. A partly written last block is ignored.
+		bool open(const std::string& path, std::string* error = nullptr);
+		void close();
+
+		const std::vector<BlockInfo>& blocks() const	{ return index; }
+		bool isTruncated() const						{ return truncated; }		// the file ends with a partial block
+
+		// First block that may hold records at or after the time, or blocks().size(). O(log n) for time ordered files.
+		size_t findBlock(int64_t time) const;
+		bool verify(size_t block) const;
+
+		// Decodes one block, calling the handlers for each record (either may be null).
+		// Returns false if the block is corrupt.
+		bool readBlock(size_t block, const FixHandler& onFix, const SentenceHandler& onSentence = nullptr) const;
+
+		// Decodes the records with from <= time <= to, skipping the other blocks.
+		// Returns the number of records passed to the handlers.
+		size_t scan(int64_t from, int64_t to, const FixHandler& onFix, const SentenceHandler& onSentence = nullptr) const;
+	};
+
+}
+
+#endif /* ARCHIVE_H_ */
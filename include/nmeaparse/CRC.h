@@ -0,0 +1,27 @@
+/*
+ * CRC.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Table driven checksums for the binary formats.
+
+#ifndef CRC_H_
+#define CRC_H_
+
+#include <cstdint>
+#include <cstddef>
+
+namespace nmea {
+
+	// CRC-32 (IEEE 802.3, as zlib). Pass the previous result to continue over several buffers.
+	uint32_t crc32(const void* data, size_t size, uint32_t crc = 0);
+
+	// CRC-24Q (Qualcomm, as RTCM3 frames use), in the low 24 bits. Pass the previous result to continue.
+	uint32_t crc24q(const void* data, size_t size, uint32_t crc = 0);
+
+}
+
+#endif /* CRC_H_ */
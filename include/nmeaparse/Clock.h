@@ -0,0 +1,51 @@
+/*
+ * Clock.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#include <cstdint>
+#include <atomic>
+
+namespace nmea {
+
+	// Source of the current time for the GPSService and what is attached to it, so that
+	// recorded data can be replayed faster or slower than real time.
+	// Times are UTC nanoseconds since Jan 1, 1970.
+	class Clock {
+	public:
+		virtual ~Clock(){}
+		virtual int64_t now() const = 0;
+
+		static const Clock& system();		// the shared SystemClock
+	};
+
+
+	// The wall clock of the host.
+	class SystemClock : public Clock {
+	public:
+		int64_t now() const override;
+	};
+
+
+	// A clock that only moves when it is set. Safe to read from other threads.
+	class ManualClock : public Clock {
+	private:
+		std::atomic<int64_t> time;
+
+	public:
+		explicit ManualClock(int64_t start = 0);
+
+		int64_t now() const override;
+		void set(int64_t t);
+		void advance(int64_t nanoseconds);
+	};
+
+}
+
+#endif /* CLOCK_H_ */
@@ -0,0 +1,132 @@
+/*
+ * CommandSequencer.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Sends a queue of commands to one receiver, each as soon as the receiver is ready for it
+// instead of after a fixed sleep:
+//
+//     CommandSequencer sequencer([&port](const char* data, size_t size){ port.write(data, size); });
+//     sequencer.changeBaud = [&port](int32_t baud){ port.setBaud(baud); };
+//     sequencer.attachToParser(parser);
+//
+//     sequencer.add(ggaOff.view(), CommandAck::None);			// a whole profile at once
+//     sequencer.add(rmcRate, CommandAck::OkToSend);
+//     sequencer.add(serial);								// NMEACommandSerialConfiguration, switches the port
+//
+//     while (...){ read the port into the parser; sequencer.poll(); }
+//
+// A command is done when its acknowledgement comes: nothing, the receiver's next "OK to send"
+// ($PSRF150,1), a sentence of a given name, or any sentence (after a baud change). While the
+// receiver says it is not ready ($PSRF150,0), nothing is written. A command not acknowledged
+// in time is written again, up to the retries; after that the rest of the queue is dropped,
+// as later commands usually depend on it. A receiver not ready for as long as the retries
+// would take fails the next command the same way.
+//
+// One sequencer per receiver. It is not thread safe: drive it from the thread reading the port.
+
+#ifndef COMMANDSEQUENCER_H_
+#define COMMANDSEQUENCER_H_
+
+#include <nmeaparse/NMEACommand.h>
+#include <nmeaparse/NMEAParser.h>
+#include <nmeaparse/Clock.h>
+#include <nmeaparse/Event.h>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace nmea {
+
+	enum class CommandAck : uint8_t {
+		None,			// done once written
+		OkToSend,		// the next $PSRF150,1
+		Sentence,		// the next sentence of the name given
+		AnySentence		// the next valid sentence, the usual proof that a new baud rate works
+	};
+
+	class CommandSequencer {
+	private:
+		struct Step {
+			std::string text;
+			std::string reply;		// for CommandAck::Sentence
+			CommandAck ack;
+			int32_t baud;			// the port switches to it once written, 0 if not
+		};
+
+		std::function<void(const char* data, size_t size)> writer;
+		std::deque<Step> queue;
+		const Clock* timeSource{&Clock::system()};
+
+		bool waiting{false};		// the front command was written and waits for its acknowledgement
+		bool ready{true};			// the receiver's last word on flow control
+		bool flowRead{false};		// readSentence took it from the sentence being read
+		int64_t blockedSince{-1};	// the front command waits for the receiver to be ready
+		int attempts{0};
+		int64_t sentAt{0};
+		int32_t baud{0};			// of the port, 0 if not known
+		int32_t previousBaud{0};	// ...before the front command changed it
+
+		uint64_t sent{0};
+		uint64_t retried{0};
+		uint64_t failed{0};
+
+		void pump();
+		void complete();
+		void transmit();
+		void fail();
+		void setReady(bool ok);
+
+	public:
+		int64_t timeout{1000000000};	// nanoseconds for an acknowledgement
+		int retries{2};					// writes after the first, then the command fails
+
+		// Switches the port to another speed, right after the command changing the receiver's is written.
+		std::function<void(int32_t baud)> changeBaud;
+
+		Event<void(std::string_view command)> onAcknowledged;
+		Event<void(std::string_view command)> onFailed;		// the queue is dropped after it
+		Event<void()> onIdle;								// the queue is empty, every command acknowledged
+
+		explicit CommandSequencer(std::function<void(const char* data, size_t size)> write);
+		virtual ~CommandSequencer();
+
+		// Time source for the timeouts, the system clock by default. It must outlive the sequencer.
+		void setClock(const Clock& clock);
+
+		// Feeds the sentences of the receiver to the sequencer. The parser must outlive it.
+		void attachToParser(NMEAParser& parser);
+
+		// The port runs at this speed now, so that a failed baud change can go back to it.
+		void setBaud(int32_t portBaud)				{ baud = portBaud; }
+
+		// Queues a command. Writing starts from the next poll() or sentence, so a whole profile
+		// can be queued first.
+		void add(std::string_view text, CommandAck ack = CommandAck::OkToSend, std::string_view reply = "");
+		void add(const NMEACommand& command, CommandAck ack = CommandAck::OkToSend, std::string_view reply = "");
+		void add(const NMEACommandSerialConfiguration& command);		// switches the port, then waits for a sentence
+
+		void readSentence(const NMEASentence& nmea);	// acknowledgements and flow control
+
+		// Flow control from a GPSService's onOkToSend. When the sequencer is also attached to
+		// the parser, readSentence already took the $PSRF150 and this call is ignored.
+		void okToSend(bool ok);
+		void poll();									// timeouts: call it regularly
+		void clear();									// drops the queue
+
+		bool idle() const							{ return queue.empty(); }
+		size_t pending() const						{ return queue.size(); }
+		uint64_t sentCount() const					{ return sent; }		// writes, retries included
+		uint64_t retryCount() const					{ return retried; }
+		uint64_t failedCount() const				{ return failed; }
+	};
+
+}
+
+#endif /* COMMANDSEQUENCER_H_ */
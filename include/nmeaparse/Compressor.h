@@ -0,0 +1,142 @@
+/*
+ * Compressor.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Lossless compression of raw NMEA streams, for sending device output over slow or metered links.
+//
+// Each line is coded against the previous sentence of the same name:
+// - The name is predicted from the one that followed the last name the time before. Otherwise
+//   it is coded by its place in a dictionary built as the names first appear.
+// - A field equal to the one before costs a bit.
+// - A number with the same layout of digits is coded by the change in its step.
+// - Other fields are coded as text, with digits and the letters of the directions on 4 bits.
+// - A checksum that matches the sentence is left out and recomputed on decoding.
+// Lines that are not plain sentences are kept byte for byte: junk, binary data, bad
+// checksums, lower case hex and missing line ends. Every input decodes to exactly itself.
+//
+// Stream layout, all integers little endian:
+//
+//     header      "NMTZ", uint16 version (1), uint16 reserved (0)
+//     frame       uint32 payload bytes
+//                 uint32 lines
+//                 uint32 CRC-32 of the payload
+//                 payload: the coded lines, bits from the most significant, padded to a byte
+//
+// The coding carries over from frame to frame, so a stream is decoded from its start.
+// The compressor sends a frame when the payload reaches frameSize, and on flush().
+
+#ifndef COMPRESSOR_H_
+#define COMPRESSOR_H_
+
+#include <nmeaparse/TrackStore.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+
+namespace nmea {
+
+	class CompressionModel {
+	public:
+		struct Field {
+			std::string text;
+			bool numeric{false};
+			bool negative{false};
+			bool dot{false};
+			uint8_t intDigits{0};
+			uint8_t decimals{0};
+			uint64_t magnitude{0};		// all the digits as one integer
+			int64_t step{0};			// change of the magnitude at the last update
+		};
+
+		struct Type {
+			std::string name;
+			uint32_t next{UINT32_MAX};		// the type that followed this one the last time
+			uint32_t fieldCount{0};
+			uint8_t checksum{0};			// 0 none, 1 implicit, 2 explicit
+			uint8_t ending{0};				// 0 CRLF, 1 LF, 2 none
+			std::vector<Field> fields;
+		};
+
+		std::vector<Type> types;
+		uint32_t last{UINT32_MAX};		// the type of the last sentence
+	};
+
+
+	class NMEACompressor {
+	public:
+		typedef std::function<void(const uint8_t* data, size_t size)> Output;
+
+	private:
+		Output output;
+		CompressionModel model;
+		BitWriter bits;
+		uint32_t lines{0};
+		bool headerSent{false};
+		std::string partial;			// the start of a line not ended yet
+		std::vector<uint8_t> frame;
+		uint64_t bytesIn{0};
+		uint64_t bytesOut{0};
+
+		void encodeLine(std::string_view line, uint8_t ending);
+		bool encodeSentence(std::string_view line, uint8_t ending);
+		void encodeRaw(std::string_view line, uint8_t ending);
+		void sendHeader();
+
+	public:
+		size_t frameSize{16 * 1024};
+
+		explicit NMEACompressor(Output output);
+		NMEACompressor(const NMEACompressor&) = delete;
+		NMEACompressor& operator=(const NMEACompressor&) = delete;
+		virtual ~NMEACompressor();
+
+		void write(const void* data, size_t size);
+		void flush();			// sends the complete lines written so far
+		void finish();			// ...and the last line without a line end; the stream ends here
+
+		uint64_t inputBytes() const		{ return bytesIn; }
+		uint64_t outputBytes() const	{ return bytesOut; }
+
+		static std::string compress(std::string_view data);
+	};
+
+
+	class NMEADecompressor {
+	public:
+		typedef std::function<void(const uint8_t* data, size_t size)> Output;
+
+	private:
+		Output output;
+		CompressionModel model;
+		std::vector<uint8_t> pending;	// bytes of a frame not complete yet
+		std::vector<uint64_t> words;
+		std::string text;
+		bool headerRead{false};
+		bool failed{false};
+
+		bool decodeFrame(const uint8_t* payload, size_t size, uint32_t lineCount);
+		bool fail(const std::string& message, std::string* error);
+
+	public:
+		explicit NMEADecompressor(Output output);
+		NMEADecompressor(const NMEADecompressor&) = delete;
+		NMEADecompressor& operator=(const NMEADecompressor&) = delete;
+		virtual ~NMEADecompressor();
+
+		// Decodes the frames completed by the data. False if the stream is corrupt, and from then on.
+		bool write(const void* data, size_t size, std::string* error = nullptr);
+		bool finish(std::string* error = nullptr);		// false if the stream stops inside a frame
+
+		static bool decompress(std::string_view data, std::string& out, std::string* error = nullptr);
+	};
+
+}
+
+#endif /* COMPRESSOR_H_ */
@@ -0,0 +1,89 @@
+/*
+ * Demultiplexer.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Splits a port that carries several protocols at once into their frames, in one pass:
+//
+//     NMEA      '$' or '!', printable text up to the line end
+//     RTCM3     0xD3, 6 zero bits, 10 bit length, payload, CRC-24Q
+//     UBX       0xB5 0x62, class, id, length, payload, Fletcher checksum (see UBX.h)
+//     SiRF      0xA0 0xA2, length, payload, checksum, 0xB0 0xB3 (see SiRF.h)
+//
+// Each frame goes to the handlers of its type. Parsers and decoders can be attached directly.
+// Bytes between frames are skipped and counted.
+//
+// A frame is delivered only once its length, end and checksum are right. When a candidate
+// fails, scanning starts again at its second byte, so a frame hidden behind a corrupt or
+// false start (a '$' inside binary data, a damaged length) is still found. Bytes that may
+// belong to a frame not complete yet are kept for the next chunk.
+
+#ifndef DEMULTIPLEXER_H_
+#define DEMULTIPLEXER_H_
+
+#include <nmeaparse/Event.h>
+#include <nmeaparse/NMEAParser.h>
+#include <nmeaparse/UBX.h>
+#include <nmeaparse/SiRF.h>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace nmea {
+
+	class StreamDemultiplexer {
+	public:
+		static constexpr size_t MAX_LINE = 1024;			// longer NMEA lines are dropped
+		static constexpr size_t MAX_RTCM3 = 1023 + 6;
+		static constexpr size_t MAX_FRAME = UBXDecoder::MAX_PAYLOAD + UBXDecoder::OVERHEAD;
+
+		enum class Protocol : uint8_t {
+			NMEA,
+			RTCM3,
+			UBX,
+			SiRF
+		};
+
+	private:
+		std::vector<uint8_t> pending;		// the end of the last chunk, which may start a frame
+		uint64_t counts[4]{};
+		uint64_t skipped{0};
+		uint64_t failed{0};
+
+		// 0 if the data there is not a valid frame, SIZE_MAX if more data is needed, else its size
+		size_t frameAt(const uint8_t* data, size_t size, bool last, Protocol& protocol, size_t& lineEnd) const;
+		size_t scan(const uint8_t* data, size_t size, bool last);
+		void deliver(Protocol protocol, const uint8_t* data, size_t size, size_t lineEnd);
+
+	public:
+		// The frames, whole. NMEA lines come without their line end.
+		Event<void(std::string_view sentence)> onSentence;
+		Event<void(const uint8_t* frame, size_t size)> onRTCM3;
+		Event<void(const uint8_t* frame, size_t size)> onUBX;
+		Event<void(const uint8_t* frame, size_t size)> onSiRF;
+
+		StreamDemultiplexer();
+		virtual ~StreamDemultiplexer();
+
+		// Routes the frames of a type to a parser or a decoder. They must outlive the demultiplexer.
+		// Sentences the parser rejects are skipped.
+		void attach(NMEAParser& parser);
+		void attach(UBXDecoder& decoder);
+		void attach(SiRFDecoder& decoder);
+
+		void readByte(uint8_t b)			{ readBuffer(&b, 1); }
+		void readBuffer(const uint8_t* data, size_t size);
+		void finish();						// the stream ends: delivers a last line without line end, drops the rest
+
+		uint64_t frameCount(Protocol protocol) const	{ return counts[(int)protocol]; }
+		uint64_t skippedBytes() const					{ return skipped; }		// between frames
+		uint64_t failedCandidates() const				{ return failed; }		// starts that were not frames
+	};
+
+}
+
+#endif /* DEMULTIPLEXER_H_ */
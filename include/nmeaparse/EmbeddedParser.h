@@ -0,0 +1,383 @@
+/*
+ * EmbeddedParser.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// A parser for small targets, in this header alone: no heap, no exceptions, no RTTI, and
+// nothing from the library to link. It builds with -fno-exceptions -fno-rtti (see
+// demo_embedded.cpp) and splits sentences with the same NMEATokenizer as NMEAParser.
+//
+// Everything is sized when compiling: the line buffer, the fields of a sentence and the
+// handler table. With the defaults it takes well under 1 KB:
+//
+//     EmbeddedParser<> parser;								// 96 byte lines, 24 fields, 16 handlers
+//     parser.setHandler("--GGA", onGGA, &state);				// '-' matches any character: GPGGA, GNGGA...
+//
+//     void onGGA(const EmbeddedSentence& s, void* context){
+//         int64_t latitude;
+//         if (s.coordinate(1, latitude)){ ... }				// nanominutes, as GPSFix
+//     }
+//
+//     parser.readByte(uart_byte);								// from the receive interrupt or a loop
+//
+// Handlers get the fields as views into the parser's line buffer, valid during the call.
+// Problems come back as an EmbeddedStatus and are counted; sentences with a bad checksum are
+// not handed over.
+
+#ifndef EMBEDDEDPARSER_H_
+#define EMBEDDEDPARSER_H_
+
+#include <nmeaparse/NMEATokenizer.h>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+namespace nmea {
+
+	enum class EmbeddedStatus : uint8_t {
+		OK = 0,
+		Pending,			// the line is not complete yet
+		NoStart,			// no '$' or '!'
+		TooLong,			// longer than the line buffer, dropped
+		TooManyFields,
+		BadName,
+		NoChecksum,			// and acceptMissingChecksum is off
+		BadChecksum,
+		Unhandled,			// valid, but no handler matched
+		COUNT
+	};
+
+
+	// A sentence, as views into the parser's line buffer.
+	class EmbeddedSentence {
+	private:
+		template<size_t, size_t, size_t> friend class EmbeddedParser;
+
+		const std::string_view* fields{nullptr};
+		size_t count{0};
+
+		static bool isDigit(char c)			{ return c >= '0' && c <= '9'; }
+
+	public:
+		char start{'$'};					// '$' or '!'
+		std::string_view name;				// "GPGGA"
+		bool hasChecksum{false};
+
+		size_t fieldCount() const							{ return count; }
+
+		// Empty past the last field.
+		std::string_view field(size_t i) const				{ return i < count ? fields[i] : std::string_view(); }
+
+		bool character(size_t i, char& out) const {
+			std::string_view f = field(i);
+			if (f.size() != 1){
+				return false;
+			}
+			out = f[0];
+			return true;
+		}
+
+		// A whole number, with an optional sign.
+		bool integer(size_t i, int32_t& out) const {
+			int64_t value;
+			if (!fixed(i, value, 0) || value > INT32_MAX || value < INT32_MIN){
+				return false;
+			}
+			out = (int32_t)value;
+			return true;
+		}
+
+		// A decimal number scaled by 10^decimals, extra digits cut: "12.345" with 2 decimals is 1234.
+		bool fixed(size_t i, int64_t& out, unsigned decimals) const {
+			std::string_view f = field(i);
+			size_t p = 0;
+			bool negative = false;
+			if (p < f.size() && (f[p] == '-' || f[p] == '+')){
+				negative = f[p] == '-';
+				p++;
+			}
+			int64_t value = 0;
+			size_t digits = 0;
+			for (; p < f.size() && isDigit(f[p]); p++, digits++){
+				if (value > (INT64_MAX - 9) / 10){
+					return false;
+				}
+				value = value * 10 + (f[p] - '0');
+			}
+			if (p < f.size() && f[p] == '.'){
+				p++;
+			}
+			for (unsigned d = 0; d < decimals; d++){
+				int v = 0;
+				if (p < f.size() && isDigit(f[p])){
+					v = f[p++] - '0';
+					digits++;
+				}
+				if (value > (INT64_MAX - 9) / 10){
+					return false;
+				}
+				value = value * 10 + v;
+			}
+			while (p < f.size() && isDigit(f[p])){
+				p++;
+			}
+			if (p != f.size() || digits == 0){
+				return false;
+			}
+			out = negative ? -value : value;
+			return true;
+		}
+
+		// "ddmm.mmmm" or "dddmm.mmmm" in field i, the hemisphere in field i + 1, as nanominutes
+		// N and E (the same as GPSFix::latitudeNanoMinutes).
+		bool coordinate(size_t i, int64_t& nanominutes) const {
+			std::string_view f = field(i);
+			size_t p = 0;
+			int64_t whole = 0;
+			for (; p < f.size() && isDigit(f[p]); p++){
+				if (p == 5){
+					return false;
+				}
+				whole = whole * 10 + (f[p] - '0');
+			}
+			if (p == 0){
+				return false;
+			}
+			int64_t frac = 0;
+			if (p < f.size()){
+				if (f[p] != '.'){
+					return false;
+				}
+				int64_t scale = 1000000000;
+				for (p++; p < f.size(); p++){
+					if (!isDigit(f[p])){
+						return false;
+					}
+					if (scale > 1){
+						scale /= 10;
+						frac += (f[p] - '0') * scale;
+					}
+				}
+			}
+			int64_t degrees = whole / 100;
+			int64_t minutes = whole % 100;
+			if (minutes >= 60 || degrees > 180){
+				return false;
+			}
+			int64_t value = (degrees * 60 + minutes) * 1000000000 + frac;
+			std::string_view hemisphere = field(i + 1);
+			if (!hemisphere.empty() && (hemisphere[0] == 'S' || hemisphere[0] == 'W')){
+				value = -value;
+			}
+			nanominutes = value;
+			return true;
+		}
+	};
+
+
+	template<size_t MaxLine = 96, size_t MaxFields = 24, size_t MaxHandlers = 16>
+	class EmbeddedParser {
+	public:
+		typedef void (*Handler)(const EmbeddedSentence& sentence, void* context);
+
+		static constexpr size_t MAX_NAME = 8;
+
+	private:
+		struct Entry {
+			char name[MAX_NAME]{};
+			Handler handler{nullptr};
+			void* context{nullptr};
+		};
+
+		char line[MaxLine];
+		size_t length{0};
+		bool filling{false};
+		bool overflow{false};
+
+		std::string_view fields[MaxFields];
+		Entry handlers[MaxHandlers];
+		Entry fallback;							// for any sentence no handler took
+		uint32_t counts[(size_t)EmbeddedStatus::COUNT]{};
+
+		static bool matches(const char* pattern, std::string_view name){
+			size_t i = 0;
+			for (; i < MAX_NAME && pattern[i] != 0; i++){
+				if (i >= name.size() || (pattern[i] != '-' && pattern[i] != name[i])){
+					return false;
+				}
+			}
+			return i == name.size();
+		}
+
+		static bool sameName(const Entry& e, std::string_view name){
+			size_t n = 0;
+			while (n < MAX_NAME && e.name[n] != 0){
+				n++;
+			}
+			return std::string_view(e.name, n) == name;
+		}
+
+		static int hexValue(char c){
+			if (c >= '0' && c <= '9'){
+				return c - '0';
+			}
+			if (c >= 'A' && c <= 'F'){
+				return c - 'A' + 10;
+			}
+			if (c >= 'a' && c <= 'f'){
+				return c - 'a' + 10;
+			}
+			return -1;
+		}
+
+		EmbeddedStatus count(EmbeddedStatus status){
+			counts[(size_t)status]++;
+			return status;
+		}
+
+	public:
+		bool acceptMissingChecksum{false};
+
+		// Sets or replaces the handler of a name, up to MAX_NAME characters; '-' matches any
+		// character. False if the table is full.
+		bool setHandler(const char* name, Handler handler, void* context = nullptr){
+			std::string_view text(name);
+			if (text.empty() || text.size() > MAX_NAME || handler == nullptr){
+				return false;
+			}
+			Entry* slot = nullptr;
+			for (Entry& e : handlers){
+				if (e.handler != nullptr && sameName(e, text)){
+					slot = &e;
+					break;
+				}
+				if (e.handler == nullptr && slot == nullptr){
+					slot = &e;
+				}
+			}
+			if (slot == nullptr){
+				return false;
+			}
+			Entry entry;
+			for (size_t i = 0; i < text.size(); i++){
+				entry.name[i] = text[i];
+			}
+			entry.handler = handler;
+			entry.context = context;
+			*slot = entry;
+			return true;
+		}
+
+		bool removeHandler(const char* name){
+			for (Entry& e : handlers){
+				if (e.handler != nullptr && sameName(e, name)){
+					e = Entry();
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Called for the valid sentences no handler matched.
+		void setFallbackHandler(Handler handler, void* context = nullptr){
+			fallback.handler = handler;
+			fallback.context = context;
+		}
+
+		// Pending until a line ends, then the outcome of its sentence.
+		EmbeddedStatus readByte(uint8_t b){
+			if (b == '$' || (b == '!' && !filling)){		// a '!' can be text inside a '$' sentence
+				filling = true;				// a new start: what came before was cut
+				overflow = false;
+				length = 0;
+			}
+			if (!filling){
+				return EmbeddedStatus::Pending;
+			}
+			if (b == '\n'){
+				filling = false;
+				if (overflow){
+					return count(EmbeddedStatus::TooLong);
+				}
+				size_t n = length > 0 && line[length - 1] == '\r' ? length - 1 : length;
+				return readSentence(std::string_view(line, n));
+			}
+			if (length < MaxLine){
+				line[length++] = (char)b;
+			}
+			else {
+				overflow = true;
+			}
+			return EmbeddedStatus::Pending;
+		}
+
+		void readBuffer(const uint8_t* data, size_t size){
+			for (size_t i = 0; i < size; i++){
+				readByte(data[i]);
+			}
+		}
+
+		// One sentence without its line end. The text must stay valid during the call.
+		EmbeddedStatus readSentence(std::string_view text){
+			NMEATokenizer tokens;
+			if (!tokens.tokenize(text)){
+				return count(EmbeddedStatus::NoStart);
+			}
+			if (tokens.name.empty() || tokens.name.size() > MAX_NAME){
+				return count(EmbeddedStatus::BadName);
+			}
+			for (char c : tokens.name){
+				if (!((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'))){
+					return count(EmbeddedStatus::BadName);
+				}
+			}
+			if (!tokens.checksumSplit){
+				if (!acceptMissingChecksum || tokens.hasChecksum){
+					return count(EmbeddedStatus::NoChecksum);
+				}
+			}
+			else if (tokens.checksum.size() != 2 || hexValue(tokens.checksum[0]) < 0 || hexValue(tokens.checksum[1]) < 0
+				|| hexValue(tokens.checksum[0]) * 16 + hexValue(tokens.checksum[1]) != tokens.calculatedChecksum)
+			{
+				return count(EmbeddedStatus::BadChecksum);
+			}
+
+			size_t n = 0;
+			NMEATokenizer::FieldReader reader = tokens.fieldReader();
+			std::string_view f;
+			while (reader.next(f)){
+				if (n == MaxFields){
+					return count(EmbeddedStatus::TooManyFields);
+				}
+				fields[n++] = f;
+			}
+
+			EmbeddedSentence sentence;
+			sentence.fields = fields;
+			sentence.count = n;
+			sentence.start = tokens.start;
+			sentence.name = tokens.name;
+			sentence.hasChecksum = tokens.checksumSplit;
+
+			for (const Entry& e : handlers){
+				if (e.handler != nullptr && matches(e.name, tokens.name)){
+					e.handler(sentence, e.context);
+					return count(EmbeddedStatus::OK);
+				}
+			}
+			if (fallback.handler != nullptr){
+				fallback.handler(sentence, fallback.context);
+			}
+			return count(EmbeddedStatus::Unhandled);
+		}
+
+		uint32_t statusCount(EmbeddedStatus status) const		{ return counts[(size_t)status]; }
+		void resetCounts()										{ for (uint32_t& c : counts) c = 0; }
+	};
+
+}
+
+#endif /* EMBEDDEDPARSER_H_ */
@@ -13,6 +13,7 @@
 #include <list>
 #include <functional>
 #include <cstdint>
+#include <memory_resource>
 
 
 
@@ -106,13 +107,13 @@ namespace nmea {
 		friend EventHandler<void(Args...)>;
 	private:
 		// Typenames
-		typedef typename std::list<EventHandler<void(Args...)>>::iterator ListIterator;
+		typedef typename std::pmr::list<EventHandler<void(Args...)>>::iterator ListIterator;
 
 		// Static members
 		// (none)
 
 		// Properties
-		std::list<EventHandler<void(Args...)>> handlers;
+		std::pmr::list<EventHandler<void(Args...)>> handlers;
 
 		//Functions
 		void _copy(const Event& ref){
@@ -144,6 +145,10 @@ namespace nmea {
 		Event() : enabled(true)
 		{}
 
+		// Keeps the handler list in the memory resource, which must outlive the event.
+		explicit Event(std::pmr::memory_resource* resource) : handlers(resource), enabled(true)
+		{}
+
 		virtual ~Event() 
 		{}
 
@@ -189,6 +194,16 @@ namespace nmea {
 			return sts;
 		};
 
+		bool removeHandler(uint64_t handlerID)	{
+			for (auto h = handlers.begin(); h != handlers.end(); h++)
+			{
+				if ((*h).ID == handlerID)	{
+					return removeHandler(h);
+				}
+			}
+			return false;
+		};
+
 		void clear(){
 			for (auto h = handlers.begin(); h != handlers.end(); h++)
 			{
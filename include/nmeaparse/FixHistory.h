@@ -0,0 +1,113 @@
+/*
+ * FixHistory.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Bounded history of the fixes, to get the position at any time of the recent past,
+// e.g. to tag camera or lidar frames.
+//
+// The records are kept as a ring of columns (one array per value), with a fixed capacity
+// allocated once. Times must not go backwards, so lookups are binary searches on either
+// the receiver UTC time or the local receive time.
+
+#ifndef FIXHISTORY_H_
+#define FIXHISTORY_H_
+
+#include <nmeaparse/GPSFix.h>
+#include <nmeaparse/Event.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace nmea {
+
+	class GPSService;
+
+	class FixHistory {
+	public:
+		enum class TimeBase {
+			UTC,			// FixRecord::time, from the receiver
+			Receive			// FixRecord::receiveTime, from the local clock
+		};
+
+		enum class Interpolation {
+			Linear,
+			Hermite			// cubic position using the speed and course at both ends, the rest stays linear
+		};
+
+	private:
+		size_t cap;
+		size_t head{0};				// physical index of the oldest record
+		size_t count{0};
+
+		// one column per FixRecord member
+		std::vector<int64_t> time;
+		std::vector<int64_t> receiveTime;
+		std::vector<int64_t> latitude;
+		std::vector<int64_t> longitude;
+		std::vector<double> altitude;
+		std::vector<double> speed;
+		std::vector<double> travelAngle;
+		std::vector<double> heading;
+		std::vector<double> roll;
+		std::vector<double> pitch;
+		std::vector<float> horizontalDilution;
+		std::vector<uint8_t> quality;
+		std::vector<uint8_t> type;
+		std::vector<uint8_t> satellites;
+		std::vector<char> status;
+
+		GPSService* service{nullptr};
+		EventHandler<void()> updateHandler;
+
+		size_t slot(size_t i) const		{ return (head + i) % cap; }
+		const std::vector<int64_t>& times(TimeBase base) const	{ return base == TimeBase::UTC ? time : receiveTime; }
+		void write(size_t s, const FixRecord& r);
+		void blend(size_t a, size_t b, int64_t t, TimeBase base, Interpolation mode, FixRecord& out) const;
+
+	public:
+		explicit FixHistory(size_t capacity = 1024);
+		FixHistory(const FixHistory&) = delete;
+		FixHistory& operator=(const FixHistory&) = delete;
+		virtual ~FixHistory();
+
+		size_t capacity() const		{ return cap; }
+		size_t size() const			{ return count; }
+		bool empty() const			{ return count == 0; }
+		void clear();
+
+		// Appends a record, dropping the oldest one when full. A record with the same UTC time as the
+		// newest one replaces it. Returns false and ignores the record if either time goes backwards.
+		bool push(const FixRecord& record);
+
+		FixRecord at(size_t i) const;			// 0 is the oldest record
+		FixRecord back() const					{ return at(count - 1); }
+		int64_t timeAt(size_t i, TimeBase base = TimeBase::UTC) const	{ return times(base)[slot(i)]; }
+
+		// Index of the first record at or after t, or size() if there is none. O(log n).
+		size_t lowerBound(int64_t t, TimeBase base = TimeBase::UTC) const;
+
+		// Index of the record closest to t, or size() if empty.
+		size_t nearest(int64_t t, TimeBase base = TimeBase::UTC) const;
+
+		// Fix at time t, between the two records around it. Returns false if t is outside the history.
+		// The time, status and discrete values come from the closest record.
+		bool interpolate(int64_t t, FixRecord& out, Interpolation mode = Interpolation::Linear, TimeBase base = TimeBase::UTC) const;
+
+		// Interpolates many times at once. out[i] is only written where ok[i] is true (ok may be null).
+		// Returns the number of times inside the history. Sorted times are walked in one pass.
+		size_t interpolate(const int64_t* t, size_t n, FixRecord* out, bool* ok = nullptr,
+			Interpolation mode = Interpolation::Linear, TimeBase base = TimeBase::UTC) const;
+
+		// Records the fix of the service at each update. Updates within one receiver epoch
+		// (same UTC time) refine the same record. The receive time is read from the clock of the service.
+		void attachToService(GPSService& gps);
+		void detach();
+	};
+
+}
+
+#endif /* FIXHISTORY_H_ */
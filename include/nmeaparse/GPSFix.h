@@ -13,10 +13,12 @@
 #include <cstdint>
 #include <ctime>
 #include <string>
+#include <string_view>
 #include <chrono>
 #include <vector>
 #include <cmath>
 #include <sstream>
+#include <nmeaparse/Clock.h>
 
 namespace nmea {
 
@@ -24,6 +26,7 @@ namespace nmea {
 	class GPSAlmanac;
 	class GPSFix;
 	class GPSService;
+	struct FixRecord;
 
 
 	// =========================== GPS SATELLITE =====================================
@@ -85,9 +88,15 @@ namespace nmea {
 	// =========================== GPS TIMESTAMP =====================================
 
 	// UTC time
+	// Held as integer nanoseconds since Jan 1, 1970: the date stamp is cached as a day
+	// count, the time stamp as nanoseconds since midnight. The calendar fields below are
+	// derived from those and kept for convenience.
 	class GPSTimestamp {
 	private:
 		std::string monthName(uint32_t index);
+
+		int64_t days;		// days since Jan 1, 1970, from the last date stamp
+		int64_t timeOfDay;	// nanoseconds since midnight UTC, from the last time stamp
 	public:
 		GPSTimestamp();
 
@@ -103,15 +112,42 @@ namespace nmea {
 		double rawTime;
 		int32_t rawDate;
 
-		time_t getTime();
+		time_t getTime() const;			// seconds since Jan 1, 1970 UTC
+		int64_t nanos() const;			// nanoseconds since Jan 1, 1970 UTC
 
 		// Set directly from the NMEA time stamp
 		// hhmmss.sss
 		void setTime(double raw_ts);
+		bool setTime(std::string_view raw_ts);		// decodes the text, returns false if malformed (value unchanged)
+		void setTimeOfDay(int64_t nanos);			// nanoseconds since midnight UTC
 
 		// Set directly from the NMEA date stamp
 		// ddmmyy
 		void setDate(int32_t raw_date);
+		bool setDate(std::string_view raw_date);	// decodes the text, returns false if malformed (value unchanged)
+
+		// Days since Jan 1, 1970 of a proleptic Gregorian date. Month and day are 1 based.
+		static constexpr int64_t daysFromCivil(int64_t y, uint32_t m, uint32_t d){
+			y -= (m <= 2);
+			const int64_t era = (y >= 0 ? y : y - 399) / 400;
+			const uint32_t yoe = (uint32_t)(y - era * 400);						// [0, 399]
+			const uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;	// [0, 365]
+			const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;			// [0, 146096]
+			return era * 146097 + (int64_t)doe - 719468;
+		}
+
+		// The proleptic Gregorian date of a count of days since Jan 1, 1970.
+		static constexpr void civilFromDays(int64_t days, int64_t& y, uint32_t& m, uint32_t& d){
+			days += 719468;
+			const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+			const uint32_t doe = (uint32_t)(days - era * 146097);						// [0, 146096]
+			const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;	// [0, 399]
+			const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);				// [0, 365]
+			const uint32_t mp = (5 * doy + 2) / 153;									// [0, 11], from March
+			d = doy - (153 * mp + 2) / 5 + 1;
+			m = mp < 10 ? mp + 3 : mp - 9;
+			y = (int64_t)yoe + era * 400 + (m <= 2);
+		}
 
 		std::string toString();
 	};
@@ -156,6 +192,7 @@ namespace nmea {
 
 		bool haslock{false};
 		bool setlock(bool b);		//returns true if lock status **changed***, false otherwise.
+		const Clock* clock{&Clock::system()};		// set by the GPSService
 
 	public:
 		GPSAlmanac almanac;
@@ -176,9 +213,15 @@ namespace nmea {
 		double horizontalDilution{0.};			// Horizontal dilution of precision, initialized to 100, best =1, worst = >20
 		double verticalDilution{0.};			// Vertical is less accurate
 
+		double latitudeError{0.};		// meters, 1 sigma, from the receiver's error statistics (GST)
+		double longitudeError{0.};		// meters, 1 sigma
+		double altitudeError{0.};		// meters, 1 sigma
+
 		double altitude{0.};		// meters
 		double latitude{0.};		// degrees N
 		double longitude{0.};		// degrees E
+		int64_t latitudeNanoMinutes{0};		// latitude N, exactly as received, in 1e-9 arc minutes
+		int64_t longitudeNanoMinutes{0};	// longitude E, exactly as received, in 1e-9 arc minutes
 		double speed{0.};			// km/h
 		double travelAngle{0.};		// degrees true north (0-360)
 		GPSAttitude attitude;
@@ -190,14 +233,38 @@ namespace nmea {
 		double verticalAccuracy();
 		bool hasEstimate();
 
-		std::chrono::seconds timeSinceLastUpdate();	// Returns seconds difference from last timestamp and right now.
+		std::chrono::seconds timeSinceLastUpdate();	// Returns seconds difference from last timestamp and right now, by the clock of the GPSService.
 
 		std::string toString();
 		operator std::string();
+		FixRecord toRecord(int64_t receiveTime = 0) const;	// flat copy of the fix, see FixRecord
 
 		static std::string travelAngleToCompassDirection(double deg, bool abbrev = false);
 	};
 
+
+
+	// =========================== FIX RECORD =====================================
+
+	// Compact, flat copy of the main fix data, for keeping and streaming many fixes.
+	struct FixRecord {
+		int64_t time{0};				// receiver UTC, nanoseconds since Jan 1, 1970
+		int64_t receiveTime{0};			// time the fix was received by the service clock, nanoseconds
+		int64_t latitude{0};			// 1e-9 arc minutes N
+		int64_t longitude{0};			// 1e-9 arc minutes E
+		double altitude{0.};			// meters
+		double speed{0.};				// km/h
+		double travelAngle{0.};			// degrees true north (0-360)
+		double heading{0.};				// degrees true north (0-360)
+		double roll{0.};				// degrees
+		double pitch{0.};				// degrees
+		float horizontalDilution{0.f};
+		uint8_t quality{0};
+		uint8_t type{1};
+		uint8_t satellites{0};
+		char status{'V'};
+	};
+
 }
 
 #endif /* GPSFIX_H_ */
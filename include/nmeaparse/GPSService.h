@@ -14,35 +14,74 @@
 #include <chrono>
 #include <functional>
 #include <nmeaparse/GPSFix.h>
+#include <nmeaparse/Clock.h>
 #include <nmeaparse/NMEAParser.h>
 #include <nmeaparse/Event.h>
+#include <nmeaparse/SentenceSchema.h>
+#include <nmeaparse/UBX.h>
+#include <nmeaparse/SiRF.h>
 
 namespace nmea {
 
+// Outcome of one sentence handled by the GPSService.
+// For the schema based sentences, bit i of the masks is field i of the schema in
+// StandardSentences.h, e.g. GGASchema::bit<&GGARecord::altitude>().
+// For GSV, bits 0-2 are the page header and bit 3+i the i-th satellite of the page.
+struct DecodeResult {
+	DecodeStatus status{DecodeStatus::OK};
+	uint32_t fields{0};			// present, valid and applied to the fix
+	uint32_t malformed{0};		// present but not readable, the fix keeps its old value
+};
+
 class GPSService {
 private:
+	const Clock* timeSource{&Clock::system()};
+
+	void report(const NMEASentence& nmea, DecodeResult result);
 
-	void read_PSRF150(const NMEASentence& nmea);
-	void read_xxGGA	(const NMEASentence& nmea);
-	void read_xxGSA	(const NMEASentence& nmea);
-	void read_xxGSV	(const NMEASentence& nmea);
-	void read_xxRMC	(const NMEASentence& nmea);
-	void read_xxVTG	(const NMEASentence& nmea);
-	void read_xxHDT	(const NMEASentence& nmea);
-	void read_xxHDG	(const NMEASentence& nmea);
-	void read_PSSN (const NMEASentence& nmea);
-	void read_PSSN_HRP (const NMEASentence& nmea);
+	// Each decoder only updates the fix with the fields the sentence carries. None of them throw.
+	DecodeResult read_PSRF150(const NMEASentence& nmea);
+	DecodeResult read_xxGGA	(const NMEASentence& nmea);
+	DecodeResult read_xxGSA	(const NMEASentence& nmea);
+	DecodeResult read_xxGSV	(const NMEASentence& nmea);
+	DecodeResult read_xxRMC	(const NMEASentence& nmea);
+	DecodeResult read_xxVTG	(const NMEASentence& nmea);
+	DecodeResult read_xxHDT	(const NMEASentence& nmea);
+	DecodeResult read_xxHDG	(const NMEASentence& nmea);
+	DecodeResult read_xxGLL	(const NMEASentence& nmea);
+	DecodeResult read_xxZDA	(const NMEASentence& nmea);
+	DecodeResult read_xxGST	(const NMEASentence& nmea);
+	DecodeResult read_xxGNS	(const NMEASentence& nmea);
+	DecodeResult read_PSSN (const NMEASentence& nmea);
+	DecodeResult read_PSSN_HRP (const NMEASentence& nmea);
+
+	// Binary navigation messages, which replace the sentences carrying the same data
+	void read_UBX_NAV_PVT	(const UBXNavPVT& pvt);
+	void read_UBX_NAV_SAT	(const UBXNavSat& sat);
+	void read_SiRF_41		(const SiRFGeodeticNav& nav);
+	void read_SiRF_4		(const SiRFTrackerData& tracker);
 
 public:
 	GPSFix fix;
 
-	GPSService(NMEAParser& parser);
+	GPSService(NMEAParser& parser);		// its events use the parser's memory resource
 	virtual ~GPSService();
 
 	Event<void(bool)> onLockStateChanged;		// user assignable handler, called whenever lock changes
 	Event<void()> onUpdate;						// user assignable handler, called whenever fix changes
+	Event<void(const NMEASentence&, DecodeResult)> onDecodeError;	// user assignable handler, called when a sentence was rejected or only partly decoded
+	Event<void(bool)> onOkToSend;				// user assignable handler, called on $PSRF150: whether the receiver takes commands (see CommandSequencer.h)
+
+	DecodeResult lastResult;					// outcome of the last sentence handled
 
 	void attachToParser(NMEAParser& parser);			// will attach to this parser's nmea sentence events
+	void attachToDecoder(UBXDecoder& decoder);			// ...to the NAV-PVT and NAV-SAT events of a UBX decoder
+	void attachToDecoder(SiRFDecoder& decoder);			// ...to the message 41 and 4 events of a SiRF decoder
+
+	// Time source for fix ages and receive times, the system clock by default.
+	// Replays set their own (see Replay.h). The clock must outlive the service.
+	void setClock(const Clock& clock);
+	const Clock& clock() const				{ return *timeSource; }
 };
 
 
@@ -0,0 +1,95 @@
+/*
+ * Generator.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Synthetic NMEA streams for benchmarks and load tests.
+//
+// A simulated receiver drives a circle (or a straight line) at a steady speed under a sky of
+// slowly moving satellites, and reports each epoch with the chosen sentences:
+//
+//     GGA GSA GSV RMC VTG HDT PSSN (heading, roll and pitch as $PSSN,HRP)
+//
+// Talkers are drawn for each sentence from a weighted mix, and errors are injected at the
+// given rates: wrong checksums, sentences cut short and bursts of random bytes between them.
+// The same seed and settings give the same bytes on every platform.
+
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+#include <nmeaparse/GPSFix.h>
+#include <nmeaparse/SentenceWriter.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace nmea {
+
+	class NMEAGenerator {
+	private:
+		uint64_t rng[4];				// xoshiro256**
+		FixRecord state;
+		double latitude{0.};			// degrees
+		double longitude{0.};
+		double baseAltitude{0.};
+		int64_t startTime{0};
+		double heading{0.};
+		std::vector<GPSSatellite> satellites;
+		std::vector<double> drifts;		// degrees of elevation per second
+		SentenceWriter writer;
+		uint64_t epochs{0};
+		uint64_t sentences{0};
+		uint64_t errors{0};
+
+		uint64_t next();
+		double uniform();				// [0, 1)
+		double uniform(double low, double high);
+
+		void useTalker();
+		void emit(std::string& out, const char* text, size_t length);		// written sentences, with the errors
+		void drawSky();
+		void move(int64_t nanos);
+
+	public:
+		// Settings, used from the next epoch on
+		double rate{1.};						// epochs per second
+		double speed{10.};						// m/s
+		double turnRate{1.};					// degrees per second, 0 for a straight line
+		unsigned satelliteCount{12};			// in view, up to 32; up to 12 of them used
+		std::vector<std::string> sentenceTypes{ "GGA", "GSA", "GSV", "RMC", "VTG" };
+		std::vector<std::pair<std::string, double>> talkers{ { "GP", 1. } };		// talker ids and weights
+		double badChecksums{0.};				// fraction of the sentences
+		double truncations{0.};					// ...cut short, still ending their line
+		double noise{0.};						// ...followed by 1 to 32 random bytes
+		bool crlf{true};						// line ends, or just '\n'
+
+		// Starts at Dublin, May 10, 2021 12:00 UTC.
+		explicit NMEAGenerator(uint64_t seed = 1);
+
+		// Restarts the trajectory from there, with the satellites drawn again from the seed.
+		void start(double latitude, double longitude, double altitude, int64_t utc, uint64_t seed);
+
+		// Appends the sentences of the next epoch to out, and moves on by one period.
+		void epoch(std::string& out);
+
+		const FixRecord& fix() const						{ return state; }		// of the next epoch
+		const std::vector<GPSSatellite>& sky() const		{ return satellites; }
+
+		uint64_t epochCount() const			{ return epochs; }
+		uint64_t sentenceCount() const		{ return sentences; }
+		uint64_t errorCount() const			{ return errors; }		// sentences corrupted or followed by noise
+
+		// Parses "GP:3,GN:1" into talkers. False if malformed (talkers unchanged).
+		static bool parseTalkers(const std::string& text, std::vector<std::pair<std::string, double>>& talkers);
+
+		// Parses "GGA,RMC" into sentence types. False if a type is not one of those above (types unchanged).
+		static bool parseSentenceTypes(const std::string& text, std::vector<std::string>& types);
+	};
+
+}
+
+#endif /* GENERATOR_H_ */
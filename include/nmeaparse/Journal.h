@@ -0,0 +1,145 @@
+/*
+ * Journal.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Black box journal of the raw bytes received from devices, in a memory mapped ring file.
+//
+// Every chunk given to a tapped parser is appended with its arrival time (steady clock) and
+// the channel of its device. Appending only copies to the mapping: the data is in the file
+// as soon as it is in memory, so it survives a crash of the process, and sync() also guards
+// it against power loss. When the ring is full, the oldest records are overwritten.
+//
+// File layout, all integers little endian:
+//
+//     header      64 bytes    "NMTJ", uint16 version (1), uint16 reserved (0)
+//                             uint64 capacity of the ring in bytes
+//                             uint64 tail: ring bytes used before the oldest record
+//                             uint64 head: ring bytes used before the end of the newest record
+//                             uint64 sequence number of the next record
+//                             24 bytes reserved
+//     ring        records, each starting on a multiple of 8 bytes
+//
+//     record      uint32 payload size
+//                 uint16 channel
+//                 uint16 kind: 0 data, 1 session start, 2 padding up to the end of the ring
+//                 uint64 sequence number, from 1, one more for each record
+//                 int64  arrival time, steady clock nanoseconds
+//                 uint32 CRC-32 of the payload
+//                 uint32 reserved (0)
+//                 payload
+//
+// Less than a record header at the end of the ring is skipped. A session record is written
+// each time the journal is opened; its payload is the system time (int64, UTC nanoseconds)
+// at the steady time of the record, to date the records after it.
+//
+// A record is complete when its CRC matches. Opening the journal again, or reading it,
+// keeps the records from the tail that follow each other and drops a torn last one.
+
+#ifndef JOURNAL_H_
+#define JOURNAL_H_
+
+#include <nmeaparse/NMEAParser.h>
+#include <nmeaparse/MappedFile.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+namespace nmea {
+
+	class Journal {
+	private:
+		class Tap : public RawTap {
+		public:
+			Journal* journal;
+			NMEAParser* parser;
+			uint16_t channel;
+
+			void write(const uint8_t* data, size_t size) override;
+		};
+
+		MappedFile file;
+		uint8_t* ring{nullptr};
+		uint64_t capacity{0};
+		uint64_t tail{0};
+		uint64_t head{0};
+		uint64_t sequence{1};
+
+		// the newest record, while more bytes of the same channel may be added to it
+		bool extendable{false};
+		uint64_t lastRecord{0};
+		uint16_t lastChannel{0};
+		int64_t lastTime{0};
+
+		std::mutex lock;
+		std::vector<std::unique_ptr<Tap>> taps;
+
+		void writeHeader();
+		void makeRoom(uint64_t bytes);
+		void appendRecord(uint16_t channel, uint16_t kind, const uint8_t* data, size_t size, int64_t time);
+		void appendLocked(uint16_t channel, const uint8_t* data, size_t size, int64_t time);
+
+	public:
+		int64_t coalesce{1000000};		// nanoseconds: bytes of a channel arriving this soon after the start of its last record join it
+
+		Journal();
+		Journal(const Journal&) = delete;
+		Journal& operator=(const Journal&) = delete;
+		virtual ~Journal();
+
+		// Creates the journal with a ring of the capacity, or opens an existing one (which keeps
+		// its capacity) and continues after its last complete record.
+		bool open(const std::string& path, size_t capacity = 16 * 1024 * 1024, std::string* error = nullptr);
+		void close();					// detaches the parsers
+		bool isOpen() const				{ return ring != nullptr; }
+		bool sync();					// flushes the mapping to the disk; not needed for crashes of the process
+
+		// Appends a chunk received on the channel, timed now, or at the given steady clock time.
+		// Safe from several threads.
+		void append(uint16_t channel, const void* data, size_t size);
+		void append(uint16_t channel, const void* data, size_t size, int64_t time);
+
+		// Journals everything the parser reads, on the channel. Detach a parser before destroying it.
+		void attachToParser(NMEAParser& parser, uint16_t channel);
+		void detach(NMEAParser& parser);
+
+		static int64_t steadyTime();	// nanoseconds
+	};
+
+
+	struct JournalRecord {
+		uint64_t sequence;
+		uint16_t channel;
+		int64_t time;					// arrival, steady clock nanoseconds
+		int64_t utc;					// arrival, system time of the session, or 0 if unknown
+		const uint8_t* data;			// in the mapped file
+		size_t size;
+	};
+
+
+	class JournalReader {
+	private:
+		MappedFile file;
+		std::vector<JournalRecord> list;
+
+	public:
+		// Maps the journal and collects its complete records, oldest first.
+		bool open(const std::string& path, std::string* error = nullptr);
+		void close();
+
+		const std::vector<JournalRecord>& records() const		{ return list; }
+
+		// Feeds the bytes of the channel (or of all of them, if negative) to the parser exactly as
+		// they were received. Sentences the parser rejects are skipped. Returns the bytes fed.
+		uint64_t replay(NMEAParser& parser, int channel = -1) const;
+	};
+
+}
+
+#endif /* JOURNAL_H_ */
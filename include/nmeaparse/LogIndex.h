@@ -0,0 +1,112 @@
+/*
+ * LogIndex.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Index of raw NMEA log files by UTC time and sentence type, to jump to a time range
+// without parsing the log from the start.
+//
+// The log is scanned once, in parallel chunks, reading only the time and date fields
+// (GGA, RMC, GLL, ZDA, GNS, GST). Each sentence is counted in the time granule of the
+// last time stamp before it, and the index keeps the byte range of every sentence type
+// in every granule. The index is saved next to the log as "<log>.idx".
+//
+// Sentences before the first date in the log get the date of the first one found later,
+// and time stamps that go back by more than 12 hours count as the next day.
+
+#ifndef LOGINDEX_H_
+#define LOGINDEX_H_
+
+#include <nmeaparse/NMEAParser.h>
+#include <nmeaparse/MappedFile.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nmea {
+
+	// Follows the UTC time of a log through the time and date fields of its sentences.
+	// Time stamps that go back by more than 12 hours count as the next day.
+	class LogTime {
+	public:
+		int64_t timeOfDay{-1};			// last one read, nanoseconds since midnight, -1 before the first one
+		int64_t firstTimeOfDay{-1};
+		int64_t day{0};					// days since Jan 1, 1970 once a date was read, else days since the start
+		bool dayKnown{false};
+		int64_t firstDate{0};			// first date read, in days since Jan 1, 1970
+		int64_t daysBeforeDate{0};		// days counted from the start until it was read
+
+		// Reads the sentence on a line of text, if there is one.
+		bool read(std::string_view line);
+		void read(std::string_view name, std::string_view body);
+
+		int64_t time() const;			// UTC nanoseconds of the last time stamp
+
+		// Name and parameters of the sentence on a line, as the parser would find them.
+		static bool split(std::string_view line, std::string_view& name, std::string_view& body);
+	};
+
+
+	class LogIndex {
+	public:
+		struct Entry {
+			int64_t granule;		// start of the granule, UTC nanoseconds since Jan 1, 1970
+			uint64_t first;			// offset of the first line of this type in the granule
+			uint64_t end;			// offset just after the last one
+			uint32_t count;			// lines of this type in the granule
+			uint16_t type;			// index in types
+		};
+
+		int64_t granularity{1000000000};	// nanoseconds
+		uint64_t logSize{0};				// size of the indexed log, to tell if the index is stale
+		std::vector<std::string> types;		// sentence names, e.g. "GPGGA"
+		std::vector<Entry> entries;			// sorted by granule, then type
+
+		// Scans the log. threads = 0 uses every hardware thread.
+		bool build(const std::string& logPath, int64_t granularity = 1000000000, unsigned threads = 0, std::string* error = nullptr);
+		bool build(const uint8_t* data, size_t size, int64_t granularity = 1000000000, unsigned threads = 0);
+
+		bool save(const std::string& path, std::string* error = nullptr) const;
+		bool load(const std::string& path, std::string* error = nullptr);
+
+		static std::string sidecarPath(const std::string& logPath)		{ return logPath + ".idx"; }
+
+		// Byte range covering the lines of the granules that overlap [from, to], only those of
+		// the type if one is given. Returns false if there are none.
+		bool range(int64_t from, int64_t to, uint64_t& first, uint64_t& end, std::string_view type = "") const;
+
+		// Entries of the granules that overlap [from, to]. O(log n) to find the first one.
+		std::vector<Entry> find(int64_t from, int64_t to, std::string_view type = "") const;
+
+		int64_t firstTime() const;		// first granule, or 0 if empty
+		int64_t lastTime() const;		// end of the last granule, or 0 if empty
+	};
+
+
+	// Reads time ranges of an indexed log into a parser.
+	class IndexedLogReader {
+	private:
+		MappedFile file;
+		LogIndex idx;
+
+	public:
+		// Maps the log and loads its index, building and saving it if missing or stale.
+		bool open(const std::string& logPath, std::string* error = nullptr, int64_t granularity = 1000000000);
+		void close();
+
+		const LogIndex& index() const		{ return idx; }
+
+		// Feeds the lines of the granules that overlap [from, to] to the parser, only the
+		// sentences of the type if one is given. Lines the parser rejects are skipped.
+		// Returns the number of lines read.
+		size_t read(int64_t from, int64_t to, NMEAParser& parser, std::string_view type = "") const;
+	};
+
+}
+
+#endif /* LOGINDEX_H_ */
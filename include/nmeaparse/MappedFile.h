@@ -0,0 +1,53 @@
+/*
+ * MappedFile.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Memory mapped file (mmap on POSIX, file mappings on Windows), read-only or read-write.
+
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace nmea {
+
+	class MappedFile {
+	private:
+		uint8_t* bytes{nullptr};
+		size_t length{0};
+		bool opened{false};
+		bool writable{false};
+#ifdef _WIN32
+		void* file{nullptr};
+		void* mapping{nullptr};
+#endif
+
+	public:
+		MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		virtual ~MappedFile();
+
+		// Maps the whole file. An empty file opens with no data.
+		bool open(const std::string& path);
+		// Maps the whole file for reading and writing, creating it or extending it to at least size bytes.
+		// Writes reach the file even if the process crashes; sync() also protects them from power loss.
+		bool create(const std::string& path, size_t size);
+		bool sync();
+		void close();
+
+		bool isOpen() const				{ return opened; }
+		const uint8_t* data() const		{ return bytes; }
+		uint8_t* writableData()			{ return writable ? bytes : nullptr; }
+		size_t size() const				{ return length; }
+	};
+
+}
+
+#endif /* MAPPEDFILE_H_ */
@@ -0,0 +1,70 @@
+/*
+ * MemoryResource.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Memory accounting for a stream: give the parser of each stream its own counting resource,
+// on top of an arena or the heap, and read what it holds.
+//
+//     CountingResource memory;								// upstream: the default resource
+//     NMEAParser parser(&memory);
+//     GPSService gps(parser);									// its events too
+//     ...
+//     memory.bytesInUse(), memory.peakBytes(), memory.allocationCount()
+//
+// Or in a fixed budget:
+//
+//     static std::byte pool[64 * 1024];
+//     std::pmr::monotonic_buffer_resource arena(pool, sizeof(pool), std::pmr::null_memory_resource());
+//     CountingResource memory(&arena);
+//
+// The parser keeps the temporaries of each sentence in an arena (see NMEAParser.h), so once its
+// buffers and handlers are set up the counts only move for unusually long sentences. The
+// NMEASentence it hands to the handlers and the GPSFix of a service hold plain std::strings and
+// vectors: they are on the heap and not counted, but reused, so they stop growing too.
+
+#ifndef MEMORYRESOURCE_H_
+#define MEMORYRESOURCE_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <memory_resource>
+
+namespace nmea {
+
+	// Counts what goes through it to another resource. Not thread safe, like the parser.
+	class CountingResource : public std::pmr::memory_resource {
+	private:
+		std::pmr::memory_resource* upstream;
+		uint64_t allocations{0};
+		uint64_t deallocations{0};
+		uint64_t total{0};
+		size_t inUse{0};
+		size_t peak{0};
+
+	protected:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	public:
+		explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+		virtual ~CountingResource();
+
+		std::pmr::memory_resource* upstreamResource() const		{ return upstream; }
+
+		uint64_t allocationCount() const		{ return allocations; }
+		uint64_t deallocationCount() const		{ return deallocations; }
+		uint64_t totalBytes() const				{ return total; }		// ever allocated
+		size_t bytesInUse() const				{ return inUse; }
+		size_t peakBytes() const				{ return peak; }
+
+		void resetPeak()						{ peak = inUse; }
+	};
+
+}
+
+#endif /* MEMORYRESOURCE_H_ */
@@ -0,0 +1,120 @@
+/*
+ * Multiplexer.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Merges the output of several receivers into one NMEA stream, at close to the speed of a copy.
+//
+// Sentences are relayed whole, in the order they arrive, into a byte ring that the consumer
+// drains with read(), or with peek() and consume() to write straight from the ring. On the way
+// each sentence may get:
+// - the talker id of its source ("$GPGGA" -> "$GNGGA"; proprietary "$P..." and encapsulated
+//   "!AIVDM" sentences keep theirs).
+//   The checksum is adjusted for the two bytes that changed, so it is not recomputed, and a
+//   sentence that came in with a wrong checksum still has one.
+// - an NMEA 4.0 tag block naming its source, and the time it was relayed if asked:
+//       \s:gps2,c:1620648000*5C\$GNGGA,...
+// - the standard line end.
+//
+// A source can be limited to a number of sentences per second (a token bucket: up to burst
+// sentences pass at once after a pause). Sentences over the limit, sentences that do not fit
+// in the ring and lines that are not sentences are dropped and counted. Text before the '$'
+// (or '!') of a line is dropped, as are tag blocks that came with it.
+
+#ifndef MULTIPLEXER_H_
+#define MULTIPLEXER_H_
+
+#include <nmeaparse/Clock.h>
+#include <nmeaparse/NMEATokenizer.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+namespace nmea {
+
+	struct MultiplexSource {
+		// Settings
+		char talker[2]{ 0, 0 };			// replaces the talker ids, if set
+		std::string tag;				// source of the tag blocks, none if empty
+		double rate{0.};				// sentences per second, 0 for no limit
+		double burst{10.};				// sentences
+
+		// Counters
+		uint64_t sentences{0};			// relayed
+		uint64_t limited{0};			// dropped over the rate
+		uint64_t rejected{0};			// not sentences, too long, or with bad checksums if verified
+		uint64_t overflows{0};			// dropped because the ring was full
+	};
+
+
+	class NMEAMultiplexer {
+	public:
+		static constexpr size_t MAX_LINE = 1024;		// longer lines are rejected
+
+	private:
+		struct Input {
+			MultiplexSource settings;
+			std::string partial;		// the start of a line not ended yet
+			bool skipping{false};		// ...too long, dropped up to its end
+			double tokens{0.};
+			int64_t refill{0};			// time of the last refill
+			bool started{false};
+		};
+
+		std::vector<std::unique_ptr<Input>> inputs;
+		std::vector<uint8_t> ring;		// a power of two bytes
+		uint64_t head{0};				// bytes written since the start
+		uint64_t tail{0};				// bytes read since the start
+		NMEATokenizer tokenizer;
+		const Clock* timeSource{&Clock::system()};
+		mutable std::mutex lock;
+
+		void relay(Input& input, const char* line, size_t length);
+		bool admit(Input& input);
+		void put(const void* data, size_t size);
+		void putHex(uint64_t position, uint8_t value);
+
+	public:
+		bool verifyChecksums{false};	// drops sentences with a wrong or missing checksum; costs a pass over each
+		bool timeTags{false};			// adds the relay time (c:, UNIX seconds) to the tag blocks
+		bool crlf{true};				// line ends, or just '\n'
+
+		// The ring holds at least capacity bytes.
+		explicit NMEAMultiplexer(size_t capacity = 64 * 1024);
+		NMEAMultiplexer(const NMEAMultiplexer&) = delete;
+		NMEAMultiplexer& operator=(const NMEAMultiplexer&) = delete;
+		virtual ~NMEAMultiplexer();
+
+		// Time source for rate limits and time tags, the system clock by default. It must outlive the multiplexer.
+		void setClock(const Clock& clock);
+
+		// Returns the index of the new source, for write(). Add the sources before writing.
+		size_t addSource();
+		size_t sourceCount() const							{ return inputs.size(); }
+		MultiplexSource& source(size_t index)				{ return inputs[index]->settings; }
+		const MultiplexSource& source(size_t index) const	{ return inputs[index]->settings; }
+
+		// Relays the complete lines of a chunk received from the source. Sources may be written from
+		// different threads, and while the output is read.
+		void write(size_t source, const void* data, size_t size);
+
+		// The output: bytes available, and up to size of them copied out.
+		size_t available() const;
+		size_t read(void* buffer, size_t size);
+
+		// Zero copy output: the next contiguous bytes in the ring, then how many of them were used.
+		size_t peek(const uint8_t*& data) const;
+		void consume(size_t size);
+
+		uint64_t outputBytes() const;		// since the start
+	};
+
+}
+
+#endif /* MULTIPLEXER_H_ */
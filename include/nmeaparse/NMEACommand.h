@@ -11,19 +11,87 @@
 #define NMEACOMMAND_H_
 
 #include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
 #include <nmeaparse/NMEAParser.h>
 
 namespace nmea {
 
 		class NMEACommand {
+		protected:
+			// Writes the fields after the name and its comma, like std::to_chars: returns the
+			// end of the text, or nullptr if it does not fit. The generic command writes message.
+			virtual char* encodeBody(char* first, char* last) const;
+
+			// For encodeBody: the number, padded on the left with '0' up to the width, like
+			// iostreams with setfill('0') << setw(width). nullptr if it does not fit.
+			static char* encodeInt(char* first, char* last, int64_t value, int width = 0);
+			static char* encodeText(char* first, char* last, std::string_view text);
+
 		public:
 			std::string message;
 			std::string name;
 			char checksum;
 			NMEACommand();
 			virtual ~NMEACommand();
-			virtual std::string toString();
+			virtual std::string toString();			// also updates message and checksum
 			std::string addChecksum(std::string s);
+
+			// Writes "$name,fields*hh\r\n" to the buffer without allocating. Returns its length,
+			// or 0 if the buffer is too small (its content is then undefined). Safe from several
+			// threads for a command that is not being changed.
+			size_t encodeTo(char* buffer, size_t size) const;
+
+			static constexpr size_t MAX_LENGTH = 128;	// enough for the commands here, NMEA allows 82
+		};
+
+
+
+		// XOR checksum of the text between '$' and '*', at compile time when it is constant.
+		constexpr uint8_t commandChecksum(std::string_view text){
+			uint8_t x = 0;
+			for (char c : text){
+				x ^= (uint8_t)c;
+			}
+			return x;
+		}
+
+		// A command known when compiling, built and checksummed by the compiler:
+		//
+		//     static constexpr NMEAConstantCommand ggaOff("PSRF103,00,00,00,01");
+		//     port.write(ggaOff.data(), ggaOff.size());		// "$PSRF103,00,00,00,01*24\r\n"
+		//
+		// The text must not contain '$' or '*'.
+		template<size_t N>
+		class NMEAConstantCommand {
+		private:
+			char text[N + 6];		// '$', the N - 1 characters, "*hh\r\n" and '\0'
+
+		public:
+			constexpr NMEAConstantCommand(const char (&body)[N])
+				: text{}
+			{
+				const char* hex = "0123456789ABCDEF";
+				uint8_t x = 0;
+				text[0] = '$';
+				for (size_t i = 0; i + 1 < N; i++){
+					text[i + 1] = body[i];
+					x ^= (uint8_t)body[i];
+				}
+				text[N] = '*';
+				text[N + 1] = hex[x >> 4];
+				text[N + 2] = hex[x & 0xF];
+				text[N + 3] = '\r';
+				text[N + 4] = '\n';
+				text[N + 5] = '\0';
+			}
+
+			constexpr const char* data() const				{ return text; }
+			constexpr size_t size() const					{ return N + 5; }
+			constexpr std::string_view view() const			{ return std::string_view(text, N + 5); }
+			constexpr uint8_t checksum() const				{ return commandChecksum(std::string_view(text + 1, N - 1)); }
+			std::string toString() const					{ return std::string(text, N + 5); }
 		};
 
 
@@ -57,7 +125,8 @@ namespace nmea {
 				stopbits = 1;
 				parity = 0;
 			};
-			virtual std::string toString();
+		protected:
+			char* encodeBody(char* first, char* last) const override;
 		};
 
 		class NMEACommandQueryRate : public NMEACommand {
@@ -108,7 +177,8 @@ namespace nmea {
 				rate = 0;
 				checksumEnable = 1;
 			};
-			virtual std::string toString();
+		protected:
+			char* encodeBody(char* first, char* last) const override;
 		};
 
 
@@ -13,11 +13,16 @@
 
 #include <nmeaparse/Event.h>
 #include <string>
+#include <string_view>
 #include <functional>
 #include <unordered_map>
+#include <unordered_set>
+#include <deque>
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 #include <exception>
+#include <memory_resource>
 
 
 
@@ -83,28 +88,71 @@ public:
 
 
 
+// Sees the raw bytes given to a parser, before they are parsed (see Journal.h).
+class RawTap {
+public:
+	virtual ~RawTap(){}
+	virtual void write(const uint8_t* data, size_t size) = 0;
+};
+
+
+
+
+// Memory: the parser allocates from the resource given to its constructor (the default
+// resource otherwise): its line buffer, handler table and event lists. The temporaries of each
+// sentence go to an arena, a bump allocator that starts in the parser itself and only asks the
+// resource for more with unusually long sentences; it is released once the handlers return.
+// The NMEASentence handed to the handlers is the parser's own, reused for the next sentence
+// (one per level of handlers injecting sentences): its strings keep their buffers, so once
+// they have grown to the longest sentence read, parsing does not allocate. Handlers that keep
+// a sentence must copy it.
 class NMEAParser {
+public:
+	static constexpr size_t ARENA_SIZE = 2048;		// in the parser, enough for any standard sentence
+
 private:
-	std::unordered_map<std::string, std::function<void(NMEASentence)>> eventTable;
-	std::string buffer;
+	std::pmr::memory_resource* resource;
+	std::pmr::unordered_map<std::pmr::string, std::function<void(const NMEASentence&)>> eventTable;
+	std::pmr::unordered_set<std::pmr::string> passiveHandlers;		// names in eventTable set passive
+	std::pmr::string buffer;
 	bool fillingbuffer;
 	uint32_t maxbuffersize;		//limit the max size if no newline ever comes... Prevents huge buffer string internally
 
-	void parseText	(NMEASentence& nmea, std::string s);		//fills the given NMEA sentence with the results of parsing the string.
+	alignas(std::max_align_t) std::byte arenaBuffer[ARENA_SIZE];
+	std::pmr::monotonic_buffer_resource sentenceArena;
+	int depth{0};				// of readSentence, for handlers that inject sentences
+	std::pmr::deque<NMEASentence> sentences;			// reused, one per depth
+	std::pmr::vector<std::string> spareParameters;		// of the previous sentences, for their buffers
+
+	void dispatch	(std::string_view line);
+	void resetSentence(NMEASentence& nmea);
+	void addParameter(NMEASentence& nmea, std::string_view field);
+	void parseText	(NMEASentence& nmea, std::string_view s);		//fills the given NMEA sentence with the results of parsing the string.
+	void consumeByte(uint8_t b);
 	
-	void onInfo		(NMEASentence& n, std::string s);
-	void onWarning	(NMEASentence& n, std::string s);
-	void onError	(NMEASentence& n, std::string s);
+	void onInfo		(NMEASentence& n, std::string_view s);
+	void onWarning	(NMEASentence& n, std::string_view s);
+	void onError	(NMEASentence& n, std::string_view s);
 public:
 
 	NMEAParser();
+	explicit NMEAParser(std::pmr::memory_resource* resource);		// must outlive the parser
 	virtual ~NMEAParser();
 
+	std::pmr::memory_resource* memoryResource() const		{ return resource; }
+
 	bool log;
+	RawTap* rawTap{nullptr};		// optional, gets every chunk given to readByte, readBuffer and readLine
 
 	Event<void(const NMEASentence&)> onSentence;				// called every time parser receives any NMEA sentence
 	void setSentenceHandler(std::string cmdKey, std::function<void(const NMEASentence&)> handler);	//one handler called for any named sentence where name is the "cmdKey"
+	// The same, for a handler that reads the sentence when it comes but does not ask for it,
+	// like the GPSService's: an OutputRatePruner does not keep the sentence on for it.
+	void setPassiveSentenceHandler(std::string cmdKey, std::function<void(const NMEASentence&)> handler);
+	void removeSentenceHandler(const std::string& cmdKey);
 	std::string getRegisteredSentenceHandlersCSV();                          // show a list of message names that currently have handlers.
+	std::vector<std::string> getRegisteredSentenceHandlers(bool includePassive = true) const;	// ...the same, sorted, without the ones not callable
+	Event<void()> onHandlersChanged;						// called after a handler is set or removed
 
 	// Byte streaming functions
 	void readByte		(uint8_t b);
@@ -114,7 +162,7 @@ public:
 	// This function expects the data to be a single line with an actual sentence in it, else it throws an error.
 	void readSentence	(std::string cmd);				// called when parser receives a sentence from the byte stream. Can also be called by user to inject sentences.
 
-	static uint8_t calculateChecksum(std::string);		// returns checksum of string -- XOR
+	static uint8_t calculateChecksum(std::string_view);		// returns checksum of string -- XOR
 
 };
 
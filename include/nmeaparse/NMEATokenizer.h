@@ -0,0 +1,140 @@
+/*
+ * NMEATokenizer.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Splits the text of a sentence into its parts in place: no copy, no allocation, no exception.
+// The parser and the stream codec share it.
+//
+//     junk$GPGGA,092750.000,5321.6802,N*76
+//          ^name ^fields               ^checksum
+//
+// The sentence starts after the last '$' of the text, or after a later '!' followed by a letter for
+// encapsulated sentences such as AIS (!AIVDM); the start character is kept in start. The name runs up to the first comma
+// and the fields follow it. The checksum is the text after the last '*' when that '*' is in
+// the last field; otherwise the fields run to the end, '*' included.
+
+#ifndef NMEATOKENIZER_H_
+#define NMEATOKENIZER_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+namespace nmea {
+
+	class NMEATokenizer {
+	public:
+		// Reads the comma separated fields one after the other.
+		class FieldReader {
+		private:
+			std::string_view rest;
+			bool done;
+		public:
+			FieldReader(std::string_view fields, bool any) : rest(fields), done(!any) {}
+
+			// The next field, false when there are no more.
+			bool next(std::string_view& field){
+				if (done){
+					return false;
+				}
+				size_t comma = rest.find(',');
+				if (comma == std::string_view::npos){
+					field = rest;
+					done = true;
+				}
+				else {
+					field = rest.substr(0, comma);
+					rest.remove_prefix(comma + 1);
+				}
+				return true;
+			}
+		};
+
+		char start{0};					// '$' or '!'
+		std::string_view sentence;		// after the start character
+		std::string_view name;			// the whole sentence if there is no comma
+		std::string_view fields;		// after the first comma, up to the checksum
+		std::string_view checksum;		// after the '*', if split
+		bool hasFields{false};			// a comma follows the name; "$GPGGA," has one empty field
+		bool hasChecksum{false};		// there is a '*'
+		bool checksumSplit{false};		// ...and it is in the last field, so checksum holds the text after it
+		uint8_t calculatedChecksum{0};	// XOR of the sentence up to the last '*', if any and asked for
+
+		// False if the text has no sentence start. Relays that only patch sentences can skip the checksum.
+		bool tokenize(std::string_view text, bool calculate = true){
+			*this = NMEATokenizer();
+			size_t dollar = lastOf(text, '$');
+			size_t bang = lastOf(text, '!');
+			if (dollar == std::string_view::npos && bang == std::string_view::npos){
+				return false;
+			}
+			// a '!' in the fields of a '$' sentence ("Hello!*hh") does not start one
+			bool encapsulated = bang != std::string_view::npos && (dollar == std::string_view::npos || bang > dollar)
+				&& bang + 1 < text.size() && text[bang + 1] >= 'A' && text[bang + 1] <= 'Z';
+			if (encapsulated){
+				dollar = bang;
+			}
+			else if (dollar == std::string_view::npos){
+				return false;
+			}
+			start = text[dollar];
+			sentence = text.substr(dollar + 1);
+
+			size_t star = sentence.rfind('*');
+			hasChecksum = star != std::string_view::npos;
+			if (hasChecksum && calculate){
+				uint8_t x = 0;
+				for (size_t i = 0; i < star; i++){
+					x ^= (uint8_t)sentence[i];
+				}
+				calculatedChecksum = x;
+			}
+
+			size_t comma = sentence.find(',');
+			if (comma == std::string_view::npos){
+				name = sentence;
+				return true;
+			}
+			name = sentence.substr(0, comma);
+			hasFields = true;
+			fields = sentence.substr(comma + 1);
+			if (hasChecksum && star > comma && fields.find(',', star - comma) == std::string_view::npos){
+				checksumSplit = true;
+				checksum = sentence.substr(star + 1);
+				fields = sentence.substr(comma + 1, star - comma - 1);
+			}
+			return true;
+		}
+
+		// Searched forward: the first is usually the last, and memchr is faster than a backward loop.
+		static size_t lastOf(std::string_view text, char c){
+			size_t last = text.find(c);
+			if (last != std::string_view::npos){
+				for (size_t more = text.find(c, last + 1); more != std::string_view::npos; more = text.find(c, more + 1)){
+					last = more;
+				}
+			}
+			return last;
+		}
+
+		FieldReader fieldReader() const		{ return FieldReader(fields, hasFields); }
+
+		size_t fieldCount() const {
+			if (!hasFields){
+				return 0;
+			}
+			size_t n = 1;
+			for (char c : fields){
+				n += c == ',';
+			}
+			return n;
+		}
+	};
+
+}
+
+#endif /* NMEATOKENIZER_H_ */
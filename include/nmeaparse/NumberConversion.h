@@ -13,6 +13,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <exception>
 
@@ -37,8 +38,42 @@ public:
 
 
 
-double parseDouble(std::string s);
-int64_t parseInt(std::string s, int radix = 10);
+// Throwing conversions. Both return 0 with "" input.
+double parseDouble(std::string_view s);
+int64_t parseInt(std::string_view s, int radix = 10);
+
+// Non-throwing conversions, locale independent and without allocation.
+// Return false if the text is empty or not entirely a number (out unchanged).
+bool tryParseDouble(std::string_view s, double& out);
+bool tryParseInt(std::string_view s, int64_t& out, int radix = 10);
+
+// Decodes exactly 2 hex digits, like the "*hh" checksum of a sentence.
+bool parseHexByte(std::string_view s, uint8_t& out);
+
+
+// Latitude/longitude in fixed point, as an exact count of 1e-9 arc minutes.
+// Decodes the NMEA dddmm.mmmm text and its N/S or E/W field without going through
+// floating point, so the full receiver precision (up to 9 decimals of minutes) is kept.
+// S and W give negative values. Returns false if the text is malformed (out unchanged).
+bool parseLatLong(std::string_view ddmm, std::string_view dir, int64_t& nanominutes);
+
+// Time of day in nanoseconds since midnight from the NMEA hhmmss[.sss] text. Up to
+// 9 fractional digits are kept. Returns false if the text is malformed (out unchanged).
+bool parseTimeOfDay(std::string_view hhmmss, int64_t& nanos);
+
+// Validates the NMEA ddmmyy text and returns it as the integer ddmmyy.
+// Returns false if the text is malformed (out unchanged).
+bool parseDate(std::string_view ddmmyy, int32_t& raw);
+
+// Degrees from 1e-9 arc minutes, the closest double to the exact value.
+inline double nanoMinutesToDegrees(int64_t nanominutes){
+	return (double)nanominutes / 60e9;
+}
+
+// Nanodegrees from 1e-9 arc minutes, rounded half away from zero.
+inline int64_t nanoMinutesToNanoDegrees(int64_t nanominutes){
+	return (nanominutes >= 0 ? nanominutes + 30 : nanominutes - 30) / 60;
+}
 
 //void NumberConversion_test();
 
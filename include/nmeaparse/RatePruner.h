@@ -0,0 +1,81 @@
+/*
+ * RatePruner.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Keeps the output of a SiRF receiver to the sentences the program reads. The sentence types
+// asked for are turned on at their rate, the others off, with $PSRF103 SETRATE commands. A
+// type is asked for by keep(), or by a sentence handler in the parser for any talker
+// ("GPGGA", "GNGGA"...). Passive handlers do not count: a GPSService reads every type it knows
+// without needing them, so keep the ones its users need.
+//
+//     CommandSequencer sequencer(...);
+//     OutputRatePruner pruner(parser, sequencer);
+//     GPSService gps(parser);
+//     pruner.keep(NMEASentence::GGA);					// positions
+//     pruner.keep(NMEASentence::RMC);					// dates and speeds
+//     pruner.setRate(NMEASentence::GSV, 5);			// satellites every 5 s, if asked for
+//
+//     parser.setSentenceHandler("GPVTG", ...);			// ...later: "$PSRF103,05,00,01,01"
+//
+// Changes to the handlers are collected and applied when the parser reads its next sentence,
+// so a burst of registrations sends each type once; update() applies them at once. Only the
+// types whose rate changes are sent. Types read without a handler (through onSentence, by a
+// logger...) must be kept explicitly.
+
+#ifndef RATEPRUNER_H_
+#define RATEPRUNER_H_
+
+#include <nmeaparse/NMEAParser.h>
+#include <nmeaparse/CommandSequencer.h>
+#include <nmeaparse/Event.h>
+#include <string>
+
+namespace nmea {
+
+	class OutputRatePruner {
+	public:
+		static constexpr int TYPES = 9;		// the message numbers of $PSRF103, ZDA is 8
+
+	private:
+		NMEAParser& parser;
+		CommandSequencer& sequencer;
+		uint64_t subscription{0};		// of onHandlersChanged
+		uint64_t sentenceSubscription{0};
+		bool changed{true};				// the handlers changed since the last update
+
+		int rates[TYPES];			// wanted while read, in seconds
+		bool kept[TYPES]{};
+		int device[TYPES];			// last sent, -1 if not known
+
+	public:
+		CommandAck ack{CommandAck::None};	// for each SETRATE command; SiRF receivers do not answer them
+		bool automatic{true};				// updates after the parser's handlers change
+
+		// Both must outlive the pruner.
+		OutputRatePruner(NMEAParser& parser, CommandSequencer& sequencer);
+		virtual ~OutputRatePruner();
+
+		// Seconds between sentences of the type while it is read, 1 by default (1-255).
+		void setRate(NMEASentence::MessageID id, int seconds);
+
+		// Asks for the type, with or without a handler.
+		void keep(NMEASentence::MessageID id, bool on = true);
+
+		// The rate the type should have now, 0 for off.
+		int wantedRate(NMEASentence::MessageID id) const;
+
+		// Queues the commands for the types whose wanted rate differs from what was sent.
+		// Returns their number.
+		int update();
+
+		// Forgets what was sent, e.g. after the receiver reconnected: the next update sets every type.
+		void reset();
+	};
+
+}
+
+#endif /* RATEPRUNER_H_ */
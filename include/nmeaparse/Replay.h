@@ -0,0 +1,106 @@
+/*
+ * Replay.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Replays recorded NMEA logs into parsers, paced like the recording (or faster, or slower)
+// or as fast as possible.
+//
+// Each stream is one log fed to one parser, with its own ManualClock that reads the recorded
+// time of the line being delivered. Give it to the GPSService of the parser (setClock) and
+// fix ages, receive times and fix histories follow the log rather than the wall clock, so
+// runs give the same results at any speed.
+//
+// Line times are either the UTC time of the sentences (see LogTime) or a receive time stamp
+// at the start of each line, in seconds since Jan 1, 1970:
+//
+//     1620648000.125 $GPGGA,...
+//
+// Lines without a time have the time of the line before them.
+// Streams are paced from their own start, so logs recorded at different times play together.
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include <nmeaparse/NMEAParser.h>
+#include <nmeaparse/Clock.h>
+#include <nmeaparse/MappedFile.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+
+namespace nmea {
+
+	class ReplayEngine {
+	public:
+		enum class Pacing {
+			None,				// as fast as possible, in time order across the streams of a thread
+			SentenceTime,		// UTC time fields of the sentences
+			ReceiveTime			// time stamps at the start of the lines
+		};
+
+	private:
+		struct Line {
+			uint64_t offset;
+			uint32_t length;			// without the line end
+			int64_t time;
+		};
+
+		struct Log {
+			std::string path;
+			MappedFile file;
+			std::vector<Line> lines;
+			bool receiveTimes{false};	// what the line times are
+			bool timed{false};
+		};
+
+		struct Stream {
+			Log* log;
+			NMEAParser* parser;
+			ManualClock clock;
+			size_t next{0};
+		};
+
+		std::vector<std::unique_ptr<Log>> logs;
+		std::vector<std::unique_ptr<Stream>> streamList;
+		std::atomic<bool> stopping{false};
+		std::atomic<uint64_t> lines{0};
+		std::atomic<uint64_t> bytes{0};
+
+		void timeLines(Log& log, bool receiveTimes);
+		void work(const std::vector<Stream*>& streams, int64_t start);
+
+	public:
+		Pacing pacing{Pacing::SentenceTime};
+		double speed{1.};			// 10 = ten times faster than recorded
+		int64_t maxGap{60LL * 1000000000};	// longer pauses in the recording are cut to this, and times going back count as no pause
+		unsigned threads{0};		// 0 = one per stream, up to the hardware threads
+
+		ReplayEngine();
+		ReplayEngine(const ReplayEngine&) = delete;
+		ReplayEngine& operator=(const ReplayEngine&) = delete;
+		virtual ~ReplayEngine();
+
+		// Adds a stream of the log into the parser. Each log is mapped once, however many
+		// streams read it. The parser is only used by the thread running its stream.
+		bool add(const std::string& logPath, NMEAParser& parser, std::string* error = nullptr);
+
+		size_t streams() const							{ return streamList.size(); }
+		ManualClock& clock(size_t stream)				{ return streamList.at(stream)->clock; }
+
+		// Replays every stream from the start. Returns when they are all done or on stop().
+		void run();
+		void stop();				// from any thread, including the handlers
+
+		uint64_t linesReplayed() const	{ return lines; }
+		uint64_t bytesReplayed() const	{ return bytes; }
+	};
+
+}
+
+#endif /* REPLAY_H_ */
@@ -0,0 +1,156 @@
+/*
+ * SchemaRegistry.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Runtime sentence layouts, for proprietary sentences that are not known when compiling.
+//
+// Layouts are read from a plain text config, one sentence per line:
+//
+//     # name[,subId]   [fieldName:]type ...
+//     MYNMEA           a:int b:int c:int d:int msg:text
+//     PSSN,HRP         time:time date:date heading:double roll:double pitch:double ...
+//
+// Types: int, double, char, text, time (hhmmss.sss), date (ddmmyy), latlong (2 parameters,
+// dddmm.mmmm,[N/S,E/W]) and skip. A sub-ID keys a family of sentences sharing one name on
+// their first parameter, the fields then start after it.
+//
+// Decoding never throws: the status and the per-field valid bitmask say what was read.
+
+#ifndef SCHEMAREGISTRY_H_
+#define SCHEMAREGISTRY_H_
+
+#include <nmeaparse/NMEAParser.h>
+#include <nmeaparse/SentenceSchema.h>
+#include <nmeaparse/Event.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <functional>
+#include <istream>
+#include <memory>
+
+namespace nmea {
+
+	enum class FieldType : uint8_t {
+		Skip,
+		Int,
+		Double,
+		Char,
+		Text,
+		Time,		// nanoseconds since midnight UTC
+		Date,		// integer ddmmyy
+		LatLong		// 1e-9 arc minutes N,E
+	};
+
+
+	class SentenceLayout {
+	public:
+		struct FieldSpec {
+			std::string name;
+			FieldType type;
+			size_t parameter;		// index of the first parameter, set by the registry
+		};
+
+		std::string name;			// sentence name, e.g. "PSSN"
+		std::string subId;			// first parameter of a sentence family, e.g. "HRP", or empty
+		std::vector<FieldSpec> fields;
+
+		size_t arity() const;						// parameters covered, including the sub-ID
+		size_t fieldIndex(std::string_view fieldName) const;	// index of the named field, or fields.size()
+		std::string key() const;					// "name" or "name,subId"
+	};
+
+
+	// One decoded sentence. Values are indexed like the layout fields.
+	class SchemaRecord {
+	public:
+		union Value {
+			int64_t i;		// Int, Char, Time, Date, LatLong
+			double d;		// Double
+		};
+
+		const SentenceLayout* layout{nullptr};
+		DecodeStatus status{DecodeStatus::UnknownSentence};
+		uint64_t valid{0};				// bit i: field i was present and decoded
+		uint64_t malformed{0};			// bit i: field i was present but not readable
+		std::vector<Value> values;
+		std::vector<std::string_view> texts;	// raw field text, points into the sentence (only valid while handling it)
+
+		bool has(size_t field) const			{ return (valid >> field) & 1; }
+		int64_t getInt(size_t field) const		{ return values[field].i; }
+		double getDouble(size_t field) const	{ return values[field].d; }
+		std::string_view getText(size_t field) const	{ return texts[field]; }
+	};
+
+
+	// Column store of the records of one layout. One column per field, with the valid bitmask of each row.
+	class SchemaColumns {
+	public:
+		const SentenceLayout* layout;
+		std::vector<std::vector<SchemaRecord::Value>> values;	// [field][row]
+		std::vector<std::vector<std::string>> texts;			// [field][row], Text fields only
+		std::vector<uint64_t> valid;							// [row]
+
+		explicit SchemaColumns(const SentenceLayout* l);
+
+		size_t rows() const		{ return valid.size(); }
+		void append(const SchemaRecord& record);
+		void clear();
+	};
+
+
+	class SchemaRegistry {
+	private:
+		// Ordered maps with std::less<>, so lookups take a string_view without building a string.
+		struct Family {
+			SentenceLayout* plain{nullptr};								// layout without a sub-ID
+			std::map<std::string, SentenceLayout*, std::less<>> bySubId;
+		};
+
+		std::vector<std::unique_ptr<SentenceLayout>> layouts;
+		std::map<std::string, Family, std::less<>> families;		// by sentence name
+		SchemaRecord current;										// reused by onSentence, so decoding doesn't allocate
+
+		NMEAParser* parser{nullptr};
+		EventHandler<void(const NMEASentence&)> sentenceHandler;
+
+		void onSentence(const NMEASentence& nmea);
+	public:
+		SchemaRegistry();
+		virtual ~SchemaRegistry();
+
+		Event<void(const SchemaRecord&)> onRecord;			// called for each sentence decoded through attachToParser()
+
+		// Adds or replaces the layout with the same key. Returns false if it covers more than 64 fields.
+		bool add(SentenceLayout layout);
+
+		// Reads layouts from the config text. Returns false and the line in error if anything is malformed.
+		bool load(std::istream& config, std::string* error = nullptr);
+		bool loadFile(const std::string& path, std::string* error = nullptr);
+
+		const SentenceLayout* find(const NMEASentence& nmea) const;
+		const SentenceLayout* find(std::string_view name, std::string_view subId = "") const;
+		std::vector<std::string> keys() const;
+
+		// Fills the record from the sentence, see SchemaRecord. Never throws.
+		DecodeStatus decode(const NMEASentence& nmea, SchemaRecord& record) const;
+		static DecodeStatus decode(const SentenceLayout& layout, const NMEASentence& nmea, SchemaRecord& record);
+
+		// Listens to the parser's onSentence and calls onRecord for the sentences with a layout.
+		// The parser's own sentence handlers are left alone, so it can be shared with a GPSService.
+		// The parser must outlive the registry, or be detached first.
+		void attachToParser(NMEAParser& parser);
+		void detach();
+
+		static bool parseFieldType(std::string_view text, FieldType& type);
+	};
+
+}
+
+#endif /* SCHEMAREGISTRY_H_ */
@@ -0,0 +1,267 @@
+/*
+ * SentenceSchema.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Compile-time typed sentence decoders.
+//
+// A sentence layout is declared once as a list of fields, each one naming a member of a
+// plain record struct and the codec that reads it:
+//
+//     struct MyRecord { int64_t time{0}; double value{0.}; };
+//     typedef SentenceSchema<MyRecord, 3,
+//         Field<&MyRecord::time,	field::Time>,		// [0]
+//         Skip<1>,										// [1]
+//         Field<&MyRecord::value,	field::Double>		// [2]
+//     > MySchema;
+//
+// The parameter offset of every field is computed at compile time and the declared arity
+// must match the field widths, so a layout can't silently drift out of sync. decode()
+// then writes each parameter straight into its member with no index arithmetic at runtime.
+
+#ifndef SENTENCESCHEMA_H_
+#define SENTENCESCHEMA_H_
+
+#include <nmeaparse/NMEAParser.h>
+#include <nmeaparse/NumberConversion.h>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <tuple>
+
+namespace nmea {
+
+	// Outcome of decoding a sentence, reported without exceptions.
+	enum class DecodeStatus : uint8_t {
+		OK = 0,
+		UnknownSentence,		// no layout for this sentence
+		BadChecksum,
+		MissingParameters,		// fewer parameters than the layout
+		MalformedField			// a field was present but not readable, the others were still decoded
+	};
+
+	inline const char* decodeStatusToString(DecodeStatus status){
+		switch (status){
+		case DecodeStatus::OK:
+			return "OK";
+		case DecodeStatus::UnknownSentence:
+			return "Unknown sentence";
+		case DecodeStatus::BadChecksum:
+			return "Checksum is invalid!";
+		case DecodeStatus::MissingParameters:
+			return "GPS data is missing parameters.";
+		case DecodeStatus::MalformedField:
+			return "GPS data has unreadable fields.";
+		default:
+			return "Unknown";
+		}
+	}
+
+	// Which fields of a record were decoded. Bit i is the i-th field of the schema.
+	struct DecodedFields {
+		uint32_t valid{0};		// present and decoded
+		uint32_t malformed{0};	// present but could not be decoded; the member is left untouched
+
+		bool has(uint32_t bits) const	{ return (valid & bits) == bits; }
+	};
+
+
+	// =========================== FIELD CODECS =====================================
+	// A codec reads `width` consecutive parameters into a value of `type`.
+	// A field is absent when its first parameter is empty.
+
+	namespace field {
+
+		struct Double {
+			typedef double type;
+			static constexpr size_t width = 1;
+			template<class S>
+			static bool decode(const S* p, type& out)		{ return tryParseDouble(p[0], out); }
+		};
+
+		template<class T>
+		struct Integer {
+			typedef T type;
+			static constexpr size_t width = 1;
+			template<class S>
+			static bool decode(const S* p, type& out){
+				int64_t v;
+				if (!tryParseInt(p[0], v) || v < (int64_t)std::numeric_limits<T>::min() || v > (int64_t)std::numeric_limits<T>::max()){
+					return false;
+				}
+				out = (T)v;
+				return true;
+			}
+		};
+		typedef Integer<uint8_t>	UInt8;
+		typedef Integer<int8_t>		Int8;
+		typedef Integer<uint16_t>	UInt16;
+		typedef Integer<int32_t>	Int32;
+
+		// First character of the field, e.g. a status or a direction
+		struct Char {
+			typedef char type;
+			static constexpr size_t width = 1;
+			template<class S>
+			static bool decode(const S* p, type& out){
+				std::string_view v = p[0];
+				out = v[0];
+				return true;
+			}
+		};
+
+		// hhmmss.sss as nanoseconds since midnight UTC
+		struct Time {
+			typedef int64_t type;
+			static constexpr size_t width = 1;
+			template<class S>
+			static bool decode(const S* p, type& out)		{ return parseTimeOfDay(p[0], out); }
+		};
+
+		// ddmmyy, validated, as the integer ddmmyy
+		struct Date {
+			typedef int32_t type;
+			static constexpr size_t width = 1;
+			template<class S>
+			static bool decode(const S* p, type& out)		{ return parseDate(p[0], out); }
+		};
+
+		// dddmm.mmmm,[N/S,E/W] as signed 1e-9 arc minutes
+		struct LatLong {
+			typedef int64_t type;
+			static constexpr size_t width = 2;
+			template<class S>
+			static bool decode(const S* p, type& out)		{ return parseLatLong(p[0], p[1], out); }
+		};
+
+	}
+
+
+	// =========================== SCHEMA ENTRIES =====================================
+
+	// Decodes the parameter(s) at the field's offset into Record::*Member.
+	template<auto Member, class Codec>
+	struct Field {
+		static constexpr size_t width = Codec::width;
+
+		template<auto Other>
+		static constexpr bool is(){
+			if constexpr (std::is_same<decltype(Member), decltype(Other)>::value){
+				return Member == Other;
+			}
+			else {
+				return false;
+			}
+		}
+
+		// returns 1 if decoded, 0 if absent, -1 if malformed
+		template<class Record, class S>
+		static int read(const S* p, Record& record){
+			if (std::string_view(p[0]).empty()){
+				return 0;
+			}
+			return Codec::decode(p, record.*Member) ? 1 : -1;
+		}
+	};
+
+	// Parameters that are not decoded, like units that are always the same letter.
+	template<size_t Width>
+	struct Skip {
+		static constexpr size_t width = Width;
+
+		template<auto Other>
+		static constexpr bool is()	{ return false; }
+
+		template<class Record, class S>
+		static int read(const S*, Record&)	{ return 0; }
+	};
+
+
+	// =========================== SENTENCE SCHEMA =====================================
+
+	template<class Record, size_t Arity, class... Fields>
+	class SentenceSchema {
+	private:
+		typedef std::tuple<Fields...> FieldList;
+
+		static constexpr size_t offsetOf(size_t index){
+			constexpr size_t widths[] = { Fields::width... };
+			size_t offset = 0;
+			for (size_t i = 0; i < index; i++){
+				offset += widths[i];
+			}
+			return offset;
+		}
+
+		template<auto Member>
+		static constexpr uint32_t findBit(){
+			uint32_t bits = 0;
+			uint32_t i = 0;
+			((bits |= (Fields::template is<Member>() ? (1u << i) : 0u), i++), ...);
+			return bits;
+		}
+
+		template<class S, size_t... I>
+		static DecodedFields decodeFields(const S* p, size_t size, Record& record, std::index_sequence<I...>){
+			DecodedFields fields;
+			((readField<I>(p, size, record, fields)), ...);
+			return fields;
+		}
+
+		template<size_t I, class S>
+		static void readField(const S* p, size_t size, Record& record, DecodedFields& fields){
+			typedef typename std::tuple_element<I, FieldList>::type F;
+			constexpr size_t offset = offsetOf(I);
+			if (offset + F::width > size){
+				return;		// short sentence, the field is absent
+			}
+			int r = F::read(p + offset, record);
+			if (r > 0){
+				fields.valid |= (1u << I);
+			}
+			else if (r < 0){
+				fields.malformed |= (1u << I);
+			}
+		}
+
+	public:
+		static constexpr size_t fieldCount = sizeof...(Fields);
+		static constexpr size_t arity = (Fields::width + ... + 0);		// parameters covered by the schema
+
+		static_assert(arity == Arity, "The field widths of the schema do not add up to its declared arity.");
+		static_assert(fieldCount <= 32, "A schema can have at most 32 fields.");
+
+		// Mask bit of the field decoding into Record::*Member.
+		template<auto Member>
+		static constexpr uint32_t bit(){
+			constexpr uint32_t b = findBit<Member>();
+			static_assert(b != 0, "The member is not decoded by this schema.");
+			return b;
+		}
+
+		// Parameter index where field `index` starts.
+		static constexpr size_t parameterIndex(size_t index){
+			return offsetOf(index);
+		}
+
+		// Decodes every field present in the parameters. Fields beyond the end of a short
+		// sentence count as absent, extra parameters are ignored.
+		template<class S>
+		static DecodedFields decode(const S* parameters, size_t size, Record& record){
+			return decodeFields(parameters, size, record, std::index_sequence_for<Fields...>());
+		}
+
+		static DecodedFields decode(const NMEASentence& nmea, Record& record){
+			return decode(nmea.parameters.data(), nmea.parameters.size(), record);
+		}
+	};
+
+}
+
+#endif /* SENTENCESCHEMA_H_ */
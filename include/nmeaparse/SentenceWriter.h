@@ -0,0 +1,62 @@
+/*
+ * SentenceWriter.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Writes standard sentences from fix data, for sending positions on to NMEA consumers.
+//
+// Everything is formatted with integer arithmetic into the caller's buffer: no printf, no
+// iostream, no allocation. Positions come from the exact 1e-9 arc minute values of the fix,
+// and times are truncated like receivers do, so a sentence read into a fix is written back
+// with the same digits at the same precision.
+//
+// Each write returns the length of the text, line end included, or 0 if the buffer is too
+// small (its content is then undefined). MAX_LENGTH is always enough for one sentence;
+// GSV writes one sentence per 4 satellites.
+
+#ifndef SENTENCEWRITER_H_
+#define SENTENCEWRITER_H_
+
+#include <nmeaparse/GPSFix.h>
+#include <cstdint>
+#include <cstddef>
+
+namespace nmea {
+
+	class SentenceWriter {
+	public:
+		static constexpr size_t MAX_LENGTH = 128;
+
+		char talker[2]{ 'G', 'P' };
+		unsigned timeDecimals{3};		// hhmmss.sss, up to 9
+		unsigned minuteDecimals{4};		// ddmm.mmmm, up to 9
+		double geoidSeparation{0.};		// meters, for GGA, which fixes do not keep
+		bool crlf{true};
+
+		size_t writeGGA(const FixRecord& fix, char* buffer, size_t size) const;
+		size_t writeRMC(const FixRecord& fix, char* buffer, size_t size) const;
+		size_t writeVTG(const FixRecord& fix, char* buffer, size_t size) const;
+		size_t writeHDT(const FixRecord& fix, char* buffer, size_t size) const;
+
+		// Up to 12 satellites used, and the fix type (1 none, 2 2D, 3 3D).
+		size_t writeGSA(const uint32_t* prns, size_t count, uint8_t type, double pdop, double hdop, double vdop,
+			char* buffer, size_t size) const;
+		// All the pages for the satellites in view. A satellite without an SNR is not tracked.
+		size_t writeGSV(const GPSSatellite* satellites, size_t count, char* buffer, size_t size) const;
+
+		// From the fix of a GPSService. GSA lists the satellites of the almanac with an SNR, as
+		// many as the fix tracks.
+		size_t writeGGA(const GPSFix& fix, char* buffer, size_t size) const		{ return writeGGA(fix.toRecord(), buffer, size); }
+		size_t writeRMC(const GPSFix& fix, char* buffer, size_t size) const		{ return writeRMC(fix.toRecord(), buffer, size); }
+		size_t writeVTG(const GPSFix& fix, char* buffer, size_t size) const		{ return writeVTG(fix.toRecord(), buffer, size); }
+		size_t writeHDT(const GPSFix& fix, char* buffer, size_t size) const		{ return writeHDT(fix.toRecord(), buffer, size); }
+		size_t writeGSA(const GPSFix& fix, char* buffer, size_t size) const;
+		size_t writeGSV(const GPSFix& fix, char* buffer, size_t size) const;
+	};
+
+}
+
+#endif /* SENTENCEWRITER_H_ */
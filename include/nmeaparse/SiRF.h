@@ -0,0 +1,121 @@
+/*
+ * SiRF.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// SiRF binary protocol: frames, and the navigation messages the GPSService reads.
+// Receivers switch to it with NMEACommandSerialConfiguration (protocol 0).
+//
+//     0xA0 0xA2, uint16 payload length, payload (message id first), uint16 checksum, 0xB0 0xB3
+//
+// All integers big endian. The checksum is the sum of the payload bytes, on 15 bits. Frames
+// are found in a byte stream like sentences are: bytes that do not start a frame, and frames
+// with a wrong checksum or end, are skipped and counted.
+//
+// Message 41 (Geodetic Navigation Data) carries time, position, velocity and fix status;
+// message 4 (Measured Tracker Data) the satellites being tracked. Attach a GPSService
+// (attachToDecoder) to update its fix from them, the same way as from the NMEA sentences.
+
+#ifndef SIRF_H_
+#define SIRF_H_
+
+#include <nmeaparse/Event.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace nmea {
+
+	struct SiRFGeodeticNav {
+		uint16_t navValid{0};			// 0 when the fix is valid, else the reasons it is not
+		uint16_t navType{0};			// bits 0-2: 0 none, 1-3 1 to 3 satellites (degraded), 4 3D, 5 2D, 6 3D, 7 dead reckoning; bit 7 DGPS
+		uint16_t week{0};				// GPS week, extended
+		uint32_t tow{0};				// ms, GPS time of week
+		uint16_t year{0};				// UTC
+		uint8_t month{0};
+		uint8_t day{0};
+		uint8_t hour{0};
+		uint8_t minute{0};
+		uint16_t second{0};				// ms
+		uint32_t satellites{0};			// bit n-1 for satellite n used in the solution
+		int32_t latitude{0};			// 1e-7 degrees
+		int32_t longitude{0};			// 1e-7 degrees
+		int32_t altitudeEllipsoid{0};	// cm
+		int32_t altitudeMSL{0};			// cm
+		int8_t datum{0};
+		uint16_t speed{0};				// cm/s, over ground
+		uint16_t course{0};				// 0.01 degrees, over ground
+		int16_t climbRate{0};			// cm/s
+		uint32_t ehpe{0};				// cm, estimated horizontal position error
+		uint32_t evpe{0};				// cm, estimated vertical position error
+		uint16_t ehve{0};				// cm/s, estimated horizontal velocity error
+		uint16_t headingError{0};		// 0.01 degrees
+		uint8_t svCount{0};				// satellites in the solution
+		uint8_t hdop{0};				// 0.2
+		uint8_t modeInfo{0};
+	};
+
+	struct SiRFChannel {
+		uint8_t svId{0};				// 0 for an idle channel
+		double azimuth{0.};				// degrees
+		double elevation{0.};			// degrees
+		uint16_t state{0};				// bit 0 acquired, bits 1-5 locks and synchronization
+		uint8_t cn0[10]{};				// dB-Hz, over the last 10 x 100 ms
+
+		double averageCN0() const;
+	};
+
+	struct SiRFTrackerData {
+		int16_t week{0};				// GPS week
+		uint32_t tow{0};				// 0.01 s, GPS time of week
+		std::vector<SiRFChannel> channels;
+	};
+
+
+	class SiRFDecoder {
+	public:
+		static constexpr size_t MAX_PAYLOAD = 2048;		// longer frames are dropped; the protocol allows 1023
+		static constexpr size_t OVERHEAD = 8;			// start, length, checksum and end
+
+	private:
+		std::vector<uint8_t> frame;		// the frame being received
+		size_t expected{0};				// its full size, once its length is in
+		SiRFGeodeticNav nav;
+		SiRFTrackerData tracker;
+		uint64_t frames{0};
+		uint64_t errors{0};
+
+	public:
+		// Every valid frame, then the events of the messages decoded from it. The payload starts with the id.
+		Event<void(uint8_t messageId, const uint8_t* payload, size_t size)> onMessage;
+		Event<void(const SiRFGeodeticNav&)> onGeodeticNav;
+		Event<void(const SiRFTrackerData&)> onTrackerData;
+
+		SiRFDecoder();
+		virtual ~SiRFDecoder();
+
+		void readByte(uint8_t b);
+		void readBuffer(const uint8_t* data, size_t size);
+
+		// Decodes a complete frame, from its start sequence. False if it is not one.
+		bool readFrame(const uint8_t* data, size_t size);
+
+		uint64_t frameCount() const			{ return frames; }
+		uint64_t errorCount() const			{ return errors; }		// bad checksums, lengths and ends
+
+		static uint16_t checksum(const uint8_t* payload, size_t size);
+
+		// Writes a frame, for sending commands. Returns its size, or 0 if it does not fit.
+		static size_t encodeFrame(const uint8_t* payload, size_t size, uint8_t* buffer, size_t capacity);
+
+		// The payloads, id included. False if too short or another message.
+		static bool decodeGeodeticNav(const uint8_t* payload, size_t size, SiRFGeodeticNav& nav);
+		static bool decodeTrackerData(const uint8_t* payload, size_t size, SiRFTrackerData& tracker);
+	};
+
+}
+
+#endif /* SIRF_H_ */
@@ -0,0 +1,72 @@
+/*
+ * SpatialIndex.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Index of the blocks of a fix archive (see Archive.h) by place and time, to find every
+// fix in a bounding box and time range without decoding the whole archive.
+//
+// The globe is cut in a quadtree of 2^level x 2^level cells of equal latitude and longitude
+// span (level 12 is about 5 x 10 km at mid latitudes), numbered in Morton order like a
+// geohash, and time is cut in windows. The index keeps, for each window and cell, the
+// blocks holding fixes there. It is saved next to the archive as "<archive>.sidx".
+
+#ifndef SPATIALINDEX_H_
+#define SPATIALINDEX_H_
+
+#include <nmeaparse/Archive.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nmea {
+
+	// Degrees. A box with west > east crosses the 180th meridian.
+	struct BoundingBox {
+		double south{-90.};
+		double west{-180.};
+		double north{90.};
+		double east{180.};
+	};
+
+
+	class SpatialIndex {
+	public:
+		struct Entry {
+			int64_t window;			// start of the time window, UTC nanoseconds since Jan 1, 1970
+			uint64_t cell;			// Morton code of the cell
+			uint32_t block;			// in the archive
+		};
+
+		uint32_t level{12};						// 1 to 26
+		int64_t window{3600LL * 1000000000};	// nanoseconds
+		uint32_t blockCount{0};					// blocks of the indexed archive, to tell if the index is stale
+		std::vector<Entry> entries;				// sorted by window, cell, then block
+
+		// Decodes every block of the archive. threads = 0 uses every hardware thread.
+		void build(const ArchiveReader& archive, uint32_t level = 12, int64_t window = 3600LL * 1000000000, unsigned threads = 0);
+
+		bool save(const std::string& path, std::string* error = nullptr) const;
+		bool load(const std::string& path, std::string* error = nullptr);
+
+		static std::string sidecarPath(const std::string& archivePath)		{ return archivePath + ".sidx"; }
+
+		// Blocks that may hold fixes in the box between from and to, in file order.
+		std::vector<uint32_t> blocks(const BoundingBox& box, int64_t from, int64_t to) const;
+
+		// Decodes only those blocks and passes the fixes in the box with from <= time <= to
+		// to the handler. Returns the number of fixes passed.
+		size_t scan(const ArchiveReader& archive, const BoundingBox& box, int64_t from, int64_t to, const ArchiveReader::FixHandler& onFix) const;
+
+		// Cell column and row of a position in 1e-9 arc minutes, and their Morton code.
+		static uint32_t column(int64_t longitude, uint32_t level);
+		static uint32_t row(int64_t latitude, uint32_t level);
+		static uint64_t morton(uint32_t column, uint32_t row);
+	};
+
+}
+
+#endif /* SPATIALINDEX_H_ */
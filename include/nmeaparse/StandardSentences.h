@@ -0,0 +1,242 @@
+/*
+ * StandardSentences.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Typed records and schemas of the standard sentences, see SentenceSchema.h.
+// Times are nanoseconds since midnight UTC, positions are 1e-9 arc minutes N,E.
+
+#ifndef STANDARDSENTENCES_H_
+#define STANDARDSENTENCES_H_
+
+#include <nmeaparse/SentenceSchema.h>
+
+namespace nmea {
+
+	// $GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47
+	struct GGARecord {
+		int64_t time{0};
+		int64_t latitude{0};
+		int64_t longitude{0};
+		uint8_t quality{0};
+		uint8_t satellites{0};
+		double hdop{0.};
+		double altitude{0.};			// meters above mean sea level
+		double geoidSeparation{0.};		// meters
+		double dgpsAge{0.};				// seconds
+	};
+	typedef SentenceSchema<GGARecord, 14,
+		Field<&GGARecord::time,				field::Time>,		// [0]
+		Field<&GGARecord::latitude,			field::LatLong>,	// [1-2]
+		Field<&GGARecord::longitude,		field::LatLong>,	// [3-4]
+		Field<&GGARecord::quality,			field::UInt8>,		// [5]
+		Field<&GGARecord::satellites,		field::UInt8>,		// [6]
+		Field<&GGARecord::hdop,				field::Double>,		// [7]
+		Field<&GGARecord::altitude,			field::Double>,		// [8]
+		Skip<1>,												// [9] M
+		Field<&GGARecord::geoidSeparation,	field::Double>,		// [10]
+		Skip<1>,												// [11] M
+		Field<&GGARecord::dgpsAge,			field::Double>,		// [12]
+		Skip<1>													// [13] DGPS station ID
+	> GGASchema;
+
+	// $GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39
+	struct GSARecord {
+		char selection{'A'};
+		uint8_t fixType{1};
+		double pdop{0.};
+		double hdop{0.};
+		double vdop{0.};
+	};
+	typedef SentenceSchema<GSARecord, 17,
+		Field<&GSARecord::selection,	field::Char>,		// [0]
+		Field<&GSARecord::fixType,		field::UInt8>,		// [1]
+		Skip<12>,											// [2-13] PRNs used for the fix
+		Field<&GSARecord::pdop,			field::Double>,		// [14]
+		Field<&GSARecord::hdop,			field::Double>,		// [15]
+		Field<&GSARecord::vdop,			field::Double>		// [16]
+	> GSASchema;
+
+	// $GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A
+	struct RMCRecord {
+		int64_t time{0};
+		char status{'V'};
+		int64_t latitude{0};
+		int64_t longitude{0};
+		double speed{0.};				// knots
+		double course{0.};				// degrees true
+		int32_t date{0};				// ddmmyy
+		double magneticVariation{0.};	// degrees
+		char magneticDirection{'E'};
+	};
+	typedef SentenceSchema<RMCRecord, 11,
+		Field<&RMCRecord::time,					field::Time>,		// [0]
+		Field<&RMCRecord::status,				field::Char>,		// [1]
+		Field<&RMCRecord::latitude,				field::LatLong>,	// [2-3]
+		Field<&RMCRecord::longitude,			field::LatLong>,	// [4-5]
+		Field<&RMCRecord::speed,				field::Double>,		// [6]
+		Field<&RMCRecord::course,				field::Double>,		// [7]
+		Field<&RMCRecord::date,					field::Date>,		// [8]
+		Field<&RMCRecord::magneticVariation,	field::Double>,		// [9]
+		Field<&RMCRecord::magneticDirection,	field::Char>		// [10]
+	> RMCSchema;
+
+	// $GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48
+	struct VTGRecord {
+		double trueCourse{0.};			// degrees
+		double magneticCourse{0.};		// degrees
+		double speedKnots{0.};
+		double speedKmh{0.};
+	};
+	typedef SentenceSchema<VTGRecord, 8,
+		Field<&VTGRecord::trueCourse,		field::Double>,		// [0]
+		Skip<1>,												// [1] T
+		Field<&VTGRecord::magneticCourse,	field::Double>,		// [2]
+		Skip<1>,												// [3] M
+		Field<&VTGRecord::speedKnots,		field::Double>,		// [4]
+		Skip<1>,												// [5] N
+		Field<&VTGRecord::speedKmh,			field::Double>,		// [6]
+		Skip<1>													// [7] K
+	> VTGSchema;
+
+	// $GPHDT,123.456,T*00
+	struct HDTRecord {
+		double heading{0.};				// degrees true
+	};
+	typedef SentenceSchema<HDTRecord, 2,
+		Field<&HDTRecord::heading,	field::Double>,		// [0]
+		Skip<1>											// [1] T
+	> HDTSchema;
+
+	// $GPHDG,123.456,123.456,E,123.456,E*00
+	struct HDGRecord {
+		double heading{0.};				// degrees magnetic
+		double deviation{0.};
+		char deviationDirection{'E'};
+		double variation{0.};
+		char variationDirection{'E'};
+	};
+	typedef SentenceSchema<HDGRecord, 5,
+		Field<&HDGRecord::heading,				field::Double>,		// [0]
+		Field<&HDGRecord::deviation,			field::Double>,		// [1]
+		Field<&HDGRecord::deviationDirection,	field::Char>,		// [2]
+		Field<&HDGRecord::variation,			field::Double>,		// [3]
+		Field<&HDGRecord::variationDirection,	field::Char>		// [4]
+	> HDGSchema;
+
+	// $GPGLL,4916.45,N,12311.12,W,225444,A*31
+	struct GLLRecord {
+		int64_t latitude{0};
+		int64_t longitude{0};
+		int64_t time{0};
+		char status{'V'};
+	};
+	typedef SentenceSchema<GLLRecord, 6,
+		Field<&GLLRecord::latitude,		field::LatLong>,	// [0-1]
+		Field<&GLLRecord::longitude,	field::LatLong>,	// [2-3]
+		Field<&GLLRecord::time,			field::Time>,		// [4]
+		Field<&GLLRecord::status,		field::Char>		// [5]
+	> GLLSchema;
+
+	// $GPZDA,201530.00,04,07,2002,00,00*60
+	struct ZDARecord {
+		int64_t time{0};
+		uint8_t day{0};
+		uint8_t month{0};
+		uint16_t year{0};
+		int8_t zoneHours{0};
+		uint8_t zoneMinutes{0};
+	};
+	typedef SentenceSchema<ZDARecord, 6,
+		Field<&ZDARecord::time,			field::Time>,		// [0]
+		Field<&ZDARecord::day,			field::UInt8>,		// [1]
+		Field<&ZDARecord::month,		field::UInt8>,		// [2]
+		Field<&ZDARecord::year,			field::UInt16>,		// [3]
+		Field<&ZDARecord::zoneHours,	field::Int8>,		// [4]
+		Field<&ZDARecord::zoneMinutes,	field::UInt8>		// [5]
+	> ZDASchema;
+
+	// $GPGST,172814.0,0.006,0.023,0.020,273.6,0.023,0.020,0.031*6A
+	struct GSTRecord {
+		int64_t time{0};
+		double rmsRange{0.};			// meters
+		double majorDeviation{0.};		// meters, error ellipse
+		double minorDeviation{0.};		// meters, error ellipse
+		double orientation{0.};			// degrees true, error ellipse
+		double latitudeDeviation{0.};	// meters
+		double longitudeDeviation{0.};	// meters
+		double altitudeDeviation{0.};	// meters
+	};
+	typedef SentenceSchema<GSTRecord, 8,
+		Field<&GSTRecord::time,					field::Time>,		// [0]
+		Field<&GSTRecord::rmsRange,				field::Double>,		// [1]
+		Field<&GSTRecord::majorDeviation,		field::Double>,		// [2]
+		Field<&GSTRecord::minorDeviation,		field::Double>,		// [3]
+		Field<&GSTRecord::orientation,			field::Double>,		// [4]
+		Field<&GSTRecord::latitudeDeviation,	field::Double>,		// [5]
+		Field<&GSTRecord::longitudeDeviation,	field::Double>,		// [6]
+		Field<&GSTRecord::altitudeDeviation,	field::Double>		// [7]
+	> GSTSchema;
+
+	// $GNGNS,014035.00,4332.69262,S,17235.48549,E,RR,13,0.9,25.63,11.24,,*70
+	struct GNSRecord {
+		int64_t time{0};
+		int64_t latitude{0};
+		int64_t longitude{0};
+		char mode{'N'};					// first constellation: N=no fix, A=autonomous, D=differential, R=RTK, F=float RTK, E=estimated
+		uint8_t satellites{0};
+		double hdop{0.};
+		double altitude{0.};			// meters above mean sea level
+		double geoidSeparation{0.};		// meters
+		double dgpsAge{0.};				// seconds
+	};
+	typedef SentenceSchema<GNSRecord, 12,
+		Field<&GNSRecord::time,				field::Time>,		// [0]
+		Field<&GNSRecord::latitude,			field::LatLong>,	// [1-2]
+		Field<&GNSRecord::longitude,		field::LatLong>,	// [3-4]
+		Field<&GNSRecord::mode,				field::Char>,		// [5]
+		Field<&GNSRecord::satellites,		field::UInt8>,		// [6]
+		Field<&GNSRecord::hdop,				field::Double>,		// [7]
+		Field<&GNSRecord::altitude,			field::Double>,		// [8]
+		Field<&GNSRecord::geoidSeparation,	field::Double>,		// [9]
+		Field<&GNSRecord::dgpsAge,			field::Double>,		// [10]
+		Skip<1>													// [11] DGPS station ID
+	> GNSSchema;
+
+	// $PSSN,HRP,120010.10,080822,12.3,45.6,78.9,12.3,45.6,78.9,10,0,12.3,E*42
+	struct PSSNHRPRecord {
+		int64_t time{0};
+		int32_t date{0};				// ddmmyy
+		double heading{0.};				// degrees true
+		double roll{0.};
+		double pitch{0.};
+		double headingDeviation{0.};
+		double rollDeviation{0.};
+		double pitchDeviation{0.};
+		int32_t satellites{0};
+		int8_t mode{0};
+		double magneticVariation{0.};
+		char magneticDirection{'E'};
+	};
+	typedef SentenceSchema<PSSNHRPRecord, 13,
+		Skip<1>,														// [0] HRP
+		Field<&PSSNHRPRecord::time,					field::Time>,		// [1]
+		Field<&PSSNHRPRecord::date,					field::Date>,		// [2]
+		Field<&PSSNHRPRecord::heading,				field::Double>,		// [3]
+		Field<&PSSNHRPRecord::roll,					field::Double>,		// [4]
+		Field<&PSSNHRPRecord::pitch,				field::Double>,		// [5]
+		Field<&PSSNHRPRecord::headingDeviation,		field::Double>,		// [6]
+		Field<&PSSNHRPRecord::rollDeviation,		field::Double>,		// [7]
+		Field<&PSSNHRPRecord::pitchDeviation,		field::Double>,		// [8]
+		Field<&PSSNHRPRecord::satellites,			field::Int32>,		// [9]
+		Field<&PSSNHRPRecord::mode,					field::Int8>,		// [10]
+		Field<&PSSNHRPRecord::magneticVariation,	field::Double>,		// [11]
+		Field<&PSSNHRPRecord::magneticDirection,	field::Char>		// [12]
+	> PSSNHRPSchema;
+
+}
+
+#endif /* STANDARDSENTENCES_H_ */
@@ -0,0 +1,183 @@
+/*
+ * TrackStore.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Compressed in-memory store of fix tracks, one track per device.
+//
+// Each track is a list of append-only blocks of FixRecords, compressed the way time series
+// databases do (Gorilla), but aware that NMEA values are decimals:
+//  - the UTC time and the position as delta-of-deltas, so a steady rate or speed costs
+//    1 bit, in units of their decimal resolution (e.g. 10 ms, 1e-5 arc minutes),
+//  - the receive time as the change of its latency to the UTC time,
+//  - floating point values with few decimals as deltas of the scaled integer, others as
+//    the XOR with the previous value (repeats cost 1 bit either way),
+//  - status, quality, type and satellites as one word, stored only when it changes.
+// The first record of a block is stored whole, so every block decodes on its own. All of
+// it is lossless.
+
+#ifndef TRACKSTORE_H_
+#define TRACKSTORE_H_
+
+#include <nmeaparse/GPSFix.h>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <unordered_map>
+
+namespace nmea {
+
+	// Bit stream, most significant bit first.
+	class BitWriter {
+	public:
+		std::vector<uint64_t> words;
+		size_t bits{0};
+
+		// Writes the low n bits of v (n <= 64).
+		void write(uint64_t v, unsigned n){
+			if (n == 0){
+				return;
+			}
+			if (n < 64){
+				v &= (1ULL << n) - 1;
+			}
+			unsigned used = bits & 63;
+			if (used == 0){
+				words.push_back(0);
+			}
+			unsigned free = 64 - used;
+			if (n <= free){
+				words.back() |= v << (free - n);
+			}
+			else {
+				words.back() |= v >> (n - free);
+				words.push_back(v << (64 - (n - free)));
+			}
+			bits += n;
+		}
+		void writeBit(bool b)	{ write(b ? 1 : 0, 1); }
+		void clear()			{ words.clear(); bits = 0; }
+	};
+
+	class BitReader {
+	public:
+		const uint64_t* words{nullptr};
+		size_t bits{0};
+		size_t pos{0};
+
+		BitReader(){}
+		BitReader(const uint64_t* w, size_t n) : words(w), bits(n) {}
+
+		bool atEnd() const	{ return pos >= bits; }
+
+		// Reads n bits (n <= 64). Reading past the end is the caller's error.
+		uint64_t read(unsigned n){
+			if (n == 0){
+				return 0;
+			}
+			size_t w = pos >> 6;
+			unsigned used = pos & 63;
+			unsigned avail = 64 - used;
+			uint64_t r = (words[w] << used) >> (64 - n);
+			if (n > avail){
+				r |= words[w + 1] >> (64 - (n - avail));
+			}
+			pos += n;
+			return r;
+		}
+		bool readBit(){
+			bool b = (words[pos >> 6] >> (63 - (pos & 63))) & 1;
+			pos++;
+			return b;
+		}
+	};
+
+
+	class TrackStore {
+	public:
+		// Values carried from one record to the next by the codecs.
+		struct CodecState {
+			static constexpr size_t INTEGERS = 4;		// time, receiveTime, latitude, longitude
+			static constexpr size_t FLOATS = 7;			// altitude, speed, travelAngle, heading, roll, pitch, horizontalDilution
+
+			int64_t previous[INTEGERS]{};
+			int64_t delta[INTEGERS]{};
+			uint8_t unit[INTEGERS]{};			// differences are counted in 10^unit
+			uint64_t previousBits[FLOATS]{};
+			int64_t scaled[FLOATS]{};			// value * 10^decimals
+			uint8_t decimals[FLOATS]{};			// RAW when the value is not a short decimal
+			uint8_t leading[FLOATS]{};
+			uint8_t trailing[FLOATS]{};
+			uint32_t flags{0};
+
+			static constexpr uint8_t RAW = 15;
+		};
+
+		struct Block {
+			int64_t firstTime{0};
+			int64_t lastTime{0};
+			uint32_t count{0};
+			BitWriter data;
+		};
+
+		struct Track {
+			std::vector<Block> blocks;
+			CodecState state;			// encoder state after the last record
+			size_t count{0};
+		};
+
+		// Sequential decoder of one track, in time order. Appending to the same track while
+		// reading invalidates the reader.
+		class Reader {
+			friend TrackStore;
+		private:
+			const Track* track{nullptr};
+			size_t block{0};
+			uint32_t index{0};			// record index in the block
+			BitReader in;
+			CodecState state;
+			int64_t from{std::numeric_limits<int64_t>::min()};
+			int64_t to{std::numeric_limits<int64_t>::max()};
+
+			bool openBlock();
+		public:
+			bool next(FixRecord& record);		// false at the end of the track or the time range
+		};
+
+	private:
+		size_t blockSize;
+		std::unordered_map<uint32_t, Track> tracks;
+
+	public:
+		explicit TrackStore(size_t recordsPerBlock = 1024);
+		virtual ~TrackStore();
+
+		// Appends a record to the device track. Returns false and ignores it if its UTC time
+		// is before the last record of the track.
+		bool append(uint32_t device, const FixRecord& record);
+
+		// Reads the records with from <= time <= to (UTC), skipping the blocks outside the range.
+		Reader read(uint32_t device, int64_t from = std::numeric_limits<int64_t>::min(),
+			int64_t to = std::numeric_limits<int64_t>::max()) const;
+
+		std::vector<uint32_t> devices() const;
+		size_t size(uint32_t device) const;			// records of the device
+		size_t size() const;						// records of all devices
+		size_t memoryUsage() const;					// bytes used by the compressed data and the blocks
+		void erase(uint32_t device);
+		void clear();
+
+		// Releases the spare capacity of the open blocks, e.g. when recording stops.
+		void shrink();
+
+		static void encode(BitWriter& out, CodecState& state, const FixRecord& record, bool first);
+		static void decode(BitReader& in, CodecState& state, FixRecord& record, bool first);
+	};
+
+}
+
+#endif /* TRACKSTORE_H_ */
@@ -0,0 +1,131 @@
+/*
+ * UBX.h
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// u-blox UBX binary protocol: frames, and the navigation messages the GPSService reads.
+//
+//     0xB5 0x62, class, id, uint16 payload length, payload, CK_A CK_B
+//
+// All integers little endian. The checksum is the 8 bit Fletcher sum over class, id, length
+// and payload. Frames are found in a byte stream like sentences are: bytes that do not
+// start a frame, and frames with a wrong checksum, are skipped and counted. A rejected frame
+// is searched again from its second byte, so a false sync in noise hides no real frame.
+//
+// NAV-PVT (0x01 0x07) carries time, position, velocity and fix status; NAV-SAT (0x01 0x35)
+// the satellites in view. Attach a GPSService (attachToDecoder) to update its fix from them,
+// the same way as from the NMEA sentences.
+
+#ifndef UBX_H_
+#define UBX_H_
+
+#include <nmeaparse/Event.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace nmea {
+
+	struct UBXNavPVT {
+		uint32_t iTOW{0};			// ms, GPS time of week of the epoch
+		uint16_t year{0};			// UTC
+		uint8_t month{0};
+		uint8_t day{0};
+		uint8_t hour{0};
+		uint8_t min{0};
+		uint8_t sec{0};
+		uint8_t valid{0};			// bit 0 date valid, bit 1 time valid, bit 2 fully resolved
+		uint32_t tAcc{0};			// ns
+		int32_t nano{0};			// ns, -1e9..1e9, added to the time
+		uint8_t fixType{0};			// 0 none, 1 dead reckoning, 2 2D, 3 3D, 4 GNSS + dead reckoning, 5 time only
+		uint8_t flags{0};			// bit 0 fix OK, bit 1 differential, bit 5 vehicle heading valid, bits 6-7 carrier phase (1 float, 2 fixed)
+		uint8_t flags2{0};
+		uint8_t numSV{0};			// used in the solution
+		int32_t lon{0};				// 1e-7 degrees
+		int32_t lat{0};				// 1e-7 degrees
+		int32_t height{0};			// mm above the ellipsoid
+		int32_t hMSL{0};			// mm above mean sea level
+		uint32_t hAcc{0};			// mm
+		uint32_t vAcc{0};			// mm
+		int32_t velN{0};			// mm/s
+		int32_t velE{0};			// mm/s
+		int32_t velD{0};			// mm/s
+		int32_t gSpeed{0};			// mm/s, ground speed
+		int32_t headMot{0};			// 1e-5 degrees, heading of motion
+		uint32_t sAcc{0};			// mm/s
+		uint32_t headAcc{0};		// 1e-5 degrees
+		uint16_t pDOP{0};			// 0.01
+		int32_t headVeh{0};			// 1e-5 degrees, heading of the vehicle (protocol 15+, 0 before)
+	};
+
+	struct UBXSatellite {
+		uint8_t gnssId{0};			// 0 GPS, 1 SBAS, 2 Galileo, 3 BeiDou, 5 QZSS, 6 GLONASS
+		uint8_t svId{0};
+		uint8_t cno{0};				// dBHz
+		int8_t elev{0};				// degrees
+		int16_t azim{0};			// degrees
+		int16_t prRes{0};			// 0.1 m
+		uint32_t flags{0};			// bits 0-2 signal quality, bit 3 used in the solution
+
+		bool used() const			{ return (flags & 0x8) != 0; }
+		uint32_t nmeaId() const;	// the satellite number of NMEA 4.0 (extended), 0 if it has none
+	};
+
+	struct UBXNavSat {
+		uint32_t iTOW{0};			// ms
+		uint8_t version{0};
+		std::vector<UBXSatellite> satellites;
+	};
+
+
+	class UBXDecoder {
+	public:
+		static constexpr size_t MAX_PAYLOAD = 8192;		// longer frames are dropped
+		static constexpr size_t OVERHEAD = 8;			// sync, class, id, length and checksum
+
+	private:
+		std::vector<uint8_t> frame;		// the frame being received
+		size_t expected{0};				// its full size, once its length is in
+		UBXNavPVT pvt;
+		UBXNavSat sat;
+		uint64_t frames{0};
+		uint64_t errors{0};
+		std::vector<uint8_t> rescan;	// bytes of a rejected frame, read again
+
+		bool step(uint8_t b);			// false if the frame being received turned out not to be one
+
+	public:
+		// Every valid frame, then the events of the messages decoded from it.
+		Event<void(uint8_t msgClass, uint8_t msgId, const uint8_t* payload, size_t size)> onMessage;
+		Event<void(const UBXNavPVT&)> onNavPVT;
+		Event<void(const UBXNavSat&)> onNavSat;
+
+		UBXDecoder();
+		virtual ~UBXDecoder();
+
+		void readByte(uint8_t b);
+		void readBuffer(const uint8_t* data, size_t size);
+
+		// Decodes a complete frame, from its sync characters. False if it is not one.
+		bool readFrame(const uint8_t* data, size_t size);
+
+		uint64_t frameCount() const			{ return frames; }
+		uint64_t errorCount() const			{ return errors; }		// bad checksums and lengths
+
+		// The checksum over class, id, length and payload: CK_A | CK_B << 8.
+		static uint16_t checksum(const uint8_t* data, size_t size);
+
+		// Writes a frame, for sending commands. Returns its size, or 0 if it does not fit.
+		static size_t encodeFrame(uint8_t msgClass, uint8_t msgId, const uint8_t* payload, size_t size, uint8_t* buffer, size_t capacity);
+
+		// The payloads, false if too short. The NAV-PVT of protocols before 15 lacks headVeh.
+		static bool decodeNavPVT(const uint8_t* payload, size_t size, UBXNavPVT& pvt);
+		static bool decodeNavSat(const uint8_t* payload, size_t size, UBXNavSat& sat);
+	};
+
+}
+
+#endif /* UBX_H_ */
@@ -23,6 +23,27 @@
 #include <nmeaparse/GPSService.h>
 
 #include <nmeaparse/NumberConversion.h>
+#include <nmeaparse/StandardSentences.h>
+#include <nmeaparse/SchemaRegistry.h>
+#include <nmeaparse/FixHistory.h>
+#include <nmeaparse/TrackStore.h>
+#include <nmeaparse/Archive.h>
+#include <nmeaparse/SpatialIndex.h>
+#include <nmeaparse/LogIndex.h>
+#include <nmeaparse/Replay.h>
+#include <nmeaparse/Journal.h>
+#include <nmeaparse/Compressor.h>
+#include <nmeaparse/SentenceWriter.h>
+#include <nmeaparse/Generator.h>
+#include <nmeaparse/Multiplexer.h>
+#include <nmeaparse/UBX.h>
+#include <nmeaparse/SiRF.h>
+#include <nmeaparse/Demultiplexer.h>
+#include <nmeaparse/AIS.h>
+#include <nmeaparse/CommandSequencer.h>
+#include <nmeaparse/RatePruner.h>
+#include <nmeaparse/MemoryResource.h>
+#include <nmeaparse/EmbeddedParser.h>
 
 
 
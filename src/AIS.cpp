@@ -0,0 +1,285 @@
+/*
+ * AIS.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/AIS.h>
+#include <nmeaparse/NMEATokenizer.h>
+#include <cstring>
+#include <string>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	const char* const AIS_TALKERS[] = { "AB", "AD", "AI", "AN", "AR", "AS", "AT", "AX", "BS", "SA" };
+	const size_t NO_SEQUENCE = 10;
+
+	// The 6 bit values of the armoring characters: '0'-'W' are 0-39, '`'-'w' are 40-63.
+	// Other characters have the 0x80 bit set.
+	struct ArmorTable {
+		uint8_t entries[256];
+
+		constexpr ArmorTable() : entries() {
+			for (int c = 0; c < 256; c++){
+				entries[c] = 0x80;
+			}
+			for (int c = '0'; c <= 'W'; c++){
+				entries[c] = (uint8_t)(c - '0');
+			}
+			for (int c = '`'; c <= 'w'; c++){
+				entries[c] = (uint8_t)(c - '`' + 40);
+			}
+		}
+	};
+
+	constexpr ArmorTable ARMOR;
+
+	int hexValue(char c){
+		if (c >= '0' && c <= '9'){
+			return c - '0';
+		}
+		if (c >= 'A' && c <= 'F'){
+			return c - 'A' + 10;
+		}
+		if (c >= 'a' && c <= 'f'){
+			return c - 'a' + 10;
+		}
+		return -1;
+	}
+
+	// A single digit field, or -1.
+	int digit(string_view field){
+		return field.size() == 1 && field[0] >= '0' && field[0] <= '9' ? field[0] - '0' : -1;
+	}
+}
+
+
+
+// ------------- AIS DECODER ----------------
+
+AISDecoder::AISDecoder(){
+}
+
+AISDecoder::~AISDecoder(){
+}
+
+void AISDecoder::setClock(const Clock& clock){
+	timeSource = &clock;
+}
+
+void AISDecoder::attachToParser(NMEAParser& parser){
+	for (const char* talker : AIS_TALKERS){
+		for (const char* type : { "VDM", "VDO" }){
+			parser.setSentenceHandler(string(talker) + type, [this](const NMEASentence& nmea){
+				this->readSentence(nmea.text);
+			});
+		}
+	}
+}
+
+bool AISDecoder::readSentence(string_view text){
+	while (!text.empty() && (text.back() == '\n' || text.back() == '\r')){
+		text.remove_suffix(1);
+	}
+	NMEATokenizer tokens;
+	if (!tokens.tokenize(text) || tokens.start != '!' || tokens.name.size() != 5
+		|| tokens.name[2] != 'V' || tokens.name[3] != 'D' || (tokens.name[4] != 'M' && tokens.name[4] != 'O')
+		|| !tokens.checksumSplit || tokens.checksum.size() != 2
+		|| hexValue(tokens.checksum[0]) * 16 + hexValue(tokens.checksum[1]) != tokens.calculatedChecksum)
+	{
+		badSentences++;
+		return false;
+	}
+
+	// fragments, fragment, sequence id, channel, payload, fill bits
+	string_view field[6];
+	size_t n = 0;
+	NMEATokenizer::FieldReader reader = tokens.fieldReader();
+	while (n < 6 && reader.next(field[n])){
+		n++;
+	}
+	int count = digit(field[0]);
+	int number = digit(field[1]);
+	int sequence = field[2].empty() ? (int)NO_SEQUENCE : digit(field[2]);
+	int fill = digit(field[5]);
+	string_view payload = field[4];
+	if (n < 6 || count < 1 || number < 1 || number > count || sequence < 0 || fill < 0 || fill > 5){
+		badSentences++;
+		return false;
+	}
+	bool own = tokens.name[4] == 'O';
+
+	if (count == 1){
+		if (payload.size() > MAX_PAYLOAD){
+			badSentences++;
+			return false;
+		}
+		decodePayload(payload.data(), payload.size(), (unsigned)fill, own);
+		return true;
+	}
+
+	Slot& slot = slots[own][sequence];
+	char channel = field[3].empty() ? 0 : field[3][0];
+	int64_t now = timeSource->now();
+	if (number == 1){
+		if (slot.fragments != 0){
+			dropped++;			// its next fragment never came
+		}
+		slot.fragments = (uint8_t)count;
+		slot.next = 1;
+		slot.channel = channel;
+		slot.started = now;
+		slot.length = 0;
+	}
+	else if (slot.fragments != count || slot.next != number || slot.channel != channel || now - slot.started > fragmentTimeout){
+		dropped++;				// the message, or this fragment if it has no start
+		slot.fragments = 0;
+		return true;
+	}
+
+	if (slot.length + payload.size() > MAX_PAYLOAD){
+		dropped++;
+		slot.fragments = 0;
+		return true;
+	}
+	memcpy(slot.payload + slot.length, payload.data(), payload.size());
+	slot.length += payload.size();
+	slot.next++;
+	if (number == count){
+		slot.fragments = 0;
+		decodePayload(slot.payload, slot.length, (unsigned)fill, own);
+	}
+	return true;
+}
+
+size_t AISDecoder::unarmor(const char* payload, size_t length, uint8_t* out){
+	const uint8_t* p = (const uint8_t*)payload;
+	uint8_t invalid = 0;
+	size_t i = 0;
+	for (; i + 4 <= length; i += 4){
+		uint8_t a = ARMOR.entries[p[i]];
+		uint8_t b = ARMOR.entries[p[i + 1]];
+		uint8_t c = ARMOR.entries[p[i + 2]];
+		uint8_t d = ARMOR.entries[p[i + 3]];
+		invalid |= a | b | c | d;
+		uint32_t v = (uint32_t)a << 18 | (uint32_t)b << 12 | (uint32_t)c << 6 | d;
+		*out++ = (uint8_t)(v >> 16);
+		*out++ = (uint8_t)(v >> 8);
+		*out++ = (uint8_t)v;
+	}
+	uint32_t v = 0;
+	size_t rest = length - i;
+	for (; i < length; i++){
+		uint8_t a = ARMOR.entries[p[i]];
+		invalid |= a;
+		v = v << 6 | a;
+	}
+	if (rest > 0){
+		v <<= 6 * (4 - rest);
+		for (size_t k = 0; k < (rest * 6 + 7) / 8; k++){
+			*out++ = (uint8_t)(v >> (16 - 8 * k));
+		}
+	}
+	return invalid & 0x80 ? SIZE_MAX : length * 6;
+}
+
+uint32_t AISDecoder::field(size_t position, unsigned width) const {
+	const uint8_t* p = bits + position / 8;
+	uint64_t v = 0;
+	for (int i = 0; i < 8; i++){
+		v = v << 8 | p[i];
+	}
+	return (uint32_t)(v << (position % 8) >> (64 - width));
+}
+
+int32_t AISDecoder::signedField(size_t position, unsigned width) const {
+	uint32_t v = field(position, width);
+	return (int32_t)(v << (32 - width)) >> (32 - width);
+}
+
+bool AISDecoder::decodePayload(const char* payload, size_t length, unsigned fillBits, bool own){
+	size_t count = unarmor(payload, length, bits);
+	if (count == SIZE_MAX || count < 6 + fillBits){
+		badSentences++;
+		return false;
+	}
+	memset(bits + (count + 7) / 8, 0, 8);		// for the loads past the end
+	bitCount = count - fillBits;
+	messages++;
+
+	uint8_t type = (uint8_t)field(0, 6);
+	onMessage(type, bits, bitCount, own);
+
+	AISPositionReport report;
+	report.type = type;
+	report.own = own;
+	switch (type){
+	case 1:
+	case 2:
+	case 3:
+		if (bitCount < 149){
+			return false;
+		}
+		report.navigationStatus = (uint8_t)field(38, 4);
+		report.rateOfTurn = (int8_t)signedField(42, 8);
+		report.speed = (uint16_t)field(50, 10);
+		report.accuracy = field(60, 1);
+		report.longitude = signedField(61, 28);
+		report.latitude = signedField(89, 27);
+		report.course = (uint16_t)field(116, 12);
+		report.heading = (uint16_t)field(128, 9);
+		report.second = (uint8_t)field(137, 6);
+		report.raim = field(148, 1);
+		break;
+
+	case 18:
+	case 19:
+		if (bitCount < (type == 18 ? 148u : 306u)){
+			return false;
+		}
+		report.speed = (uint16_t)field(46, 10);
+		report.accuracy = field(56, 1);
+		report.longitude = signedField(57, 28);
+		report.latitude = signedField(85, 27);
+		report.course = (uint16_t)field(112, 12);
+		report.heading = (uint16_t)field(124, 9);
+		report.second = (uint8_t)field(133, 6);
+		report.raim = field(type == 18 ? 147 : 305, 1);
+		break;
+
+	default:
+		return true;
+	}
+	report.repeat = (uint8_t)field(6, 2);
+	report.mmsi = field(8, 30);
+	onPositionReport(report);
+
+	if (type == 19){
+		AISVesselInfo info;
+		size_t end = 0;
+		for (size_t i = 0; i < 20; i++){
+			uint8_t c = (uint8_t)field(143 + 6 * i, 6);
+			if (c == 0){
+				break;			// '@', the padding
+			}
+			info.name[i] = (char)(c < 32 ? c + 64 : c);
+			if (c != 32){
+				end = i + 1;
+			}
+		}
+		info.name[end] = 0;
+		info.shipType = (uint8_t)field(263, 8);
+		info.toBow = (uint16_t)field(271, 9);
+		info.toStern = (uint16_t)field(280, 9);
+		info.toPort = (uint8_t)field(289, 6);
+		info.toStarboard = (uint8_t)field(295, 6);
+		info.epfd = (uint8_t)field(301, 4);
+		onVesselInfo(report, info);
+	}
+	return true;
+}
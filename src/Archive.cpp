@@ -0,0 +1,674 @@
+/*
+ * Archive.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/Archive.h>
+#include <nmeaparse/GPSService.h>
+#include <nmeaparse/CRC.h>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	const char FILE_MAGIC[4] = { 'N', 'M', 'T', 'A' };
+	const char BLOCK_MAGIC[4] = { 'N', 'B', 'L', 'K' };
+	const uint16_t VERSION = 1;
+	const size_t FILE_HEADER_SIZE = 8;
+	const size_t BLOCK_HEADER_SIZE = 40;
+
+	const uint8_t TAG_FIX = 1;
+	const uint8_t TAG_SENTENCE = 2;
+
+	const int64_t DAY = 86400LL * 1000000000;
+
+	const uint8_t FLAG_HAS_CHECKSUM = 1;
+	const uint8_t FLAG_CHECKSUM_OK = 2;
+	const uint8_t FLAG_BANG = 4;		// '!' start
+
+	// Fixed point resolution of the fix values, in the order they are stored after the position
+	const double ALTITUDE_SCALE = 1000.0;		// mm
+	const double SPEED_SCALE = 1000.0;			// 1e-3 km/h
+	const double ANGLE_SCALE = 1000.0;			// 1e-3 degrees
+	const double DILUTION_SCALE = 100.0;
+
+	void putU16(string& s, uint16_t v){
+		s.push_back((char)(v & 0xFF));
+		s.push_back((char)(v >> 8));
+	}
+
+	void putU32(string& s, uint32_t v){
+		for (int i = 0; i < 4; i++){
+			s.push_back((char)((v >> (8 * i)) & 0xFF));
+		}
+	}
+
+	void putU64(string& s, uint64_t v){
+		for (int i = 0; i < 8; i++){
+			s.push_back((char)((v >> (8 * i)) & 0xFF));
+		}
+	}
+
+	void putVarint(string& s, uint64_t v){
+		while (v >= 0x80){
+			s.push_back((char)((v & 0x7F) | 0x80));
+			v >>= 7;
+		}
+		s.push_back((char)v);
+	}
+
+	void putSigned(string& s, int64_t v){
+		putVarint(s, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+	}
+
+	uint32_t getU32(const uint8_t* p){
+		return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+	}
+
+	uint64_t getU64(const uint8_t* p){
+		return (uint64_t)getU32(p) | ((uint64_t)getU32(p + 4) << 32);
+	}
+
+	// Bounds checked cursor over a block payload
+	struct Cursor {
+		const uint8_t* p;
+		const uint8_t* end;
+		bool ok{true};
+
+		uint8_t byte(){
+			if (p >= end){
+				ok = false;
+				return 0;
+			}
+			return *p++;
+		}
+		uint64_t varint(){
+			uint64_t v = 0;
+			for (unsigned shift = 0; shift < 64; shift += 7){
+				if (p >= end){
+					ok = false;
+					return 0;
+				}
+				uint8_t b = *p++;
+				v |= (uint64_t)(b & 0x7F) << shift;
+				if ((b & 0x80) == 0){
+					return v;
+				}
+			}
+			ok = false;
+			return 0;
+		}
+		int64_t svarint(){
+			uint64_t v = varint();
+			return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+		}
+		string_view text(size_t n){
+			if ((size_t)(end - p) < n){
+				ok = false;
+				return string_view();
+			}
+			string_view s((const char*)p, n);
+			p += n;
+			return s;
+		}
+	};
+
+	int64_t fixed(double v, double scale){
+		double x = v * scale;
+		if (!(x > -9.2e18 && x < 9.2e18)){
+			return 0;		// NaN or out of range
+		}
+		return llround(x);
+	}
+
+	// the fix as the integers stored in a record, before the delta
+	void fixValues(const FixRecord& f, int64_t v[11]){
+		v[0] = f.time;
+		v[1] = f.receiveTime;
+		v[2] = f.latitude;
+		v[3] = f.longitude;
+		v[4] = fixed(f.altitude, ALTITUDE_SCALE);
+		v[5] = fixed(f.speed, SPEED_SCALE);
+		v[6] = fixed(f.travelAngle, ANGLE_SCALE);
+		v[7] = fixed(f.heading, ANGLE_SCALE);
+		v[8] = fixed(f.roll, ANGLE_SCALE);
+		v[9] = fixed(f.pitch, ANGLE_SCALE);
+		v[10] = fixed(f.horizontalDilution, DILUTION_SCALE);
+	}
+}
+
+
+
+// ------------- ARCHIVED SENTENCE ----------------
+
+string ArchivedSentence::text() const {
+	string body(name);
+	for (auto& p : parameters){
+		body += ',';
+		body += p;
+	}
+	if (!hasChecksum){
+		return start + body;
+	}
+	char cs[4];
+	snprintf(cs, sizeof(cs), "*%02X", checksum);
+	return start + body + cs;
+}
+
+
+
+// ------------- ARCHIVE WRITER ----------------
+
+ArchiveWriter::ArchiveWriter(size_t blockBytes)
+	: blockBytes(blockBytes == 0 ? 1 : blockBytes)
+	, updateHandler([](){})
+	, sentenceHandler([](const NMEASentence&){})
+{}
+
+ArchiveWriter::~ArchiveWriter(){
+	close();
+}
+
+bool ArchiveWriter::open(const string& path){
+	close();
+	file.reset(new ofstream(path, ios::binary | ios::trunc));
+	if (!file->is_open()){
+		file.reset();
+		return false;
+	}
+	return open(*file);
+}
+
+bool ArchiveWriter::open(ostream& stream){
+	if (&stream != file.get()){
+		close();
+	}
+	out = &stream;
+	string header(FILE_MAGIC, sizeof(FILE_MAGIC));
+	putU16(header, VERSION);
+	putU16(header, 0);
+	out->write(header.data(), header.size());
+	bytes = header.size();
+	blocks = 0;
+	return out->good();
+}
+
+bool ArchiveWriter::good() const {
+	return out != nullptr && out->good();
+}
+
+void ArchiveWriter::beginRecord(int64_t time, bool timed){
+	if (!timed){
+		return;		// undated: its time would stretch the block range over decades
+	}
+	if (time < firstTime){
+		firstTime = time;
+	}
+	if (time > lastTime){
+		lastTime = time;
+	}
+}
+
+void ArchiveWriter::endRecord(){
+	if (payload.size() >= blockBytes){
+		flush();
+	}
+}
+
+void ArchiveWriter::writeFix(const FixRecord& fix){
+	writeFix(fix, true);
+}
+
+void ArchiveWriter::writeFix(const FixRecord& fix, bool timed){
+	if (out == nullptr){
+		return;
+	}
+	beginRecord(fix.time, timed);
+
+	int64_t v[11];
+	fixValues(fix, v);
+	payload.push_back((char)TAG_FIX);
+	for (size_t i = 0; i < 11; i++){
+		putSigned(payload, (int64_t)((uint64_t)v[i] - (uint64_t)previousFix[i]));
+		previousFix[i] = v[i];
+	}
+	payload.push_back(fix.status);
+	payload.push_back((char)fix.quality);
+	payload.push_back((char)fix.type);
+	payload.push_back((char)fix.satellites);
+	fixCount++;
+
+	endRecord();
+}
+
+void ArchiveWriter::writeSentence(const NMEASentence& nmea, int64_t time){
+	writeSentence(nmea, time, true);
+}
+
+void ArchiveWriter::writeSentence(const NMEASentence& nmea, int64_t time, bool timed){
+	if (out == nullptr){
+		return;
+	}
+	beginRecord(time, timed);
+
+	uint8_t flags = 0;
+	if (!nmea.text.empty() && nmea.text[0] == '!'){
+		flags |= FLAG_BANG;
+	}
+	if (nmea.checksumIsCalculated){
+		flags |= FLAG_HAS_CHECKSUM;
+		if (nmea.checksumOK()){
+			flags |= FLAG_CHECKSUM_OK;
+		}
+	}
+	size_t nameLength = min(nmea.name.size(), (size_t)255);
+
+	payload.push_back((char)TAG_SENTENCE);
+	putSigned(payload, (int64_t)((uint64_t)time - (uint64_t)previousSentenceTime));
+	previousSentenceTime = time;
+	payload.push_back((char)flags);
+	if (flags & FLAG_HAS_CHECKSUM){
+		payload.push_back((char)nmea.parsedChecksum);
+	}
+	payload.push_back((char)nameLength);
+	payload.append(nmea.name, 0, nameLength);
+	putVarint(payload, nmea.parameters.size());
+	vector<string>& previous = previousParameters[nmea.name];
+	previous.resize(max(previous.size(), nmea.parameters.size()));
+	for (size_t i = 0; i < nmea.parameters.size(); i++){
+		const string& p = nmea.parameters[i];
+		if (p == previous[i] && !p.empty()){
+			putVarint(payload, 0);
+			continue;
+		}
+		putVarint(payload, p.size() + 1);
+		payload += p;
+		previous[i] = p;
+	}
+	sentenceCount++;
+
+	endRecord();
+}
+
+void ArchiveWriter::flush(){
+	if (out == nullptr || (fixCount == 0 && sentenceCount == 0)){
+		return;
+	}
+
+	string header(BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+	putU32(header, (uint32_t)payload.size());
+	putU32(header, fixCount);
+	putU32(header, sentenceCount);
+	putU64(header, (uint64_t)firstTime);
+	putU64(header, (uint64_t)lastTime);
+	putU32(header, crc32(payload.data(), payload.size()));
+	putU32(header, 0);
+
+	out->write(header.data(), header.size());
+	out->write(payload.data(), payload.size());
+	out->flush();
+	bytes += header.size() + payload.size();
+	blocks++;
+
+	payload.clear();
+	fixCount = 0;
+	sentenceCount = 0;
+	firstTime = numeric_limits<int64_t>::max();
+	lastTime = numeric_limits<int64_t>::min();
+	memset(previousFix, 0, sizeof(previousFix));
+	previousSentenceTime = 0;
+	previousParameters.clear();
+}
+
+void ArchiveWriter::close(){
+	detach();
+	if (hasPending){
+		writeFix(pending);
+		hasPending = false;
+	}
+	flush();
+	out = nullptr;
+	file.reset();
+}
+
+void ArchiveWriter::holdOrWrite(const FixRecord& fix){
+	if (service == nullptr || dated){
+		writeFix(fix, true);
+		return;
+	}
+	if (out == nullptr){
+		return;
+	}
+	if (held.size() >= holdLimit){
+		writeHeld(0, false);
+	}
+	held.push_back({ fix.time, fix, nullptr });
+}
+
+void ArchiveWriter::holdOrWrite(const NMEASentence& nmea){
+	if (service == nullptr || dated){
+		bool timed = currentTime != NO_TIME;
+		writeSentence(nmea, timed ? currentTime : 0, timed);
+		return;
+	}
+	if (out == nullptr){
+		return;
+	}
+	if (held.size() >= holdLimit){
+		writeHeld(0, false);
+	}
+	held.push_back({ currentTime, FixRecord(), unique_ptr<NMEASentence>(new NMEASentence(nmea)) });
+}
+
+// Writes the held records moved by shift, or undated. The sentences held before the first
+// fix get its time.
+void ArchiveWriter::writeHeld(int64_t shift, bool timed){
+	int64_t first = currentTime;
+	for (const HeldRecord& h : held){
+		if (h.time != NO_TIME){
+			first = h.time;
+			break;
+		}
+	}
+	for (const HeldRecord& h : held){
+		int64_t time = h.time != NO_TIME ? h.time : first;
+		bool known = timed && time != NO_TIME;
+		time = known ? time + shift : (time == NO_TIME ? 0 : time);
+		if (h.sentence){
+			writeSentence(*h.sentence, time, known);
+		}
+		else {
+			FixRecord f = h.fix;
+			f.time = time;
+			writeFix(f, known);
+		}
+	}
+	held.clear();
+}
+
+void ArchiveWriter::attachToService(GPSService& gps){
+	detachService();
+	service = &gps;
+	dated = false;
+	undatedDays = 0;
+	lastTimeOfDay = -1;
+	updateHandler = gps.onUpdate += [this](){
+		FixRecord r = service->fix.toRecord(service->clock().now());
+		if (!dated){
+			// only the time of day is known: count the midnights until the date comes
+			int64_t timeOfDay = ((r.time % DAY) + DAY) % DAY;
+			const GPSTimestamp& ts = service->fix.timestamp;
+			if (lastTimeOfDay < 0 && ts.rawTime == 0 && ts.rawDate == 0){
+				r.time = NO_TIME;		// no time stamp read yet (GSA, GSV...): gets the first one
+			}
+			else if (ts.rawDate == 0){
+				if (lastTimeOfDay >= 0 && timeOfDay < lastTimeOfDay - DAY / 2){
+					undatedDays++;
+				}
+				lastTimeOfDay = timeOfDay;
+				r.time = undatedDays * DAY + timeOfDay;
+			}
+			else {
+				// back-date what was held, the pending fix and the time of the held sentences
+				if (lastTimeOfDay >= 0 && timeOfDay < lastTimeOfDay - DAY / 2){
+					undatedDays++;
+				}
+				int64_t shift = (r.time - timeOfDay) - undatedDays * DAY;
+				dated = true;
+				if (currentTime == NO_TIME){
+					currentTime = r.time - shift;		// for sentences before any fix
+				}
+				writeHeld(shift, true);
+				if (hasPending){
+					pending.time = pending.time == NO_TIME ? r.time : pending.time + shift;
+				}
+			}
+		}
+		if (hasPending && r.time != pending.time){
+			holdOrWrite(pending);
+		}
+		pending = r;
+		hasPending = true;
+		currentTime = r.time;
+	};
+}
+
+void ArchiveWriter::attachToParser(NMEAParser& p){
+	if (parser != nullptr){
+		parser->onSentence.removeHandler(sentenceHandler);
+	}
+	parser = &p;
+	sentenceHandler = p.onSentence += [this](const NMEASentence& nmea){
+		holdOrWrite(nmea);
+	};
+}
+
+void ArchiveWriter::detachService(){
+	if (service == nullptr){
+		return;
+	}
+	service->onUpdate.removeHandler(updateHandler);
+	if (!dated){
+		// the date never came: the pending fix joins the held records, all undated
+		if (hasPending){
+			held.push_back({ pending.time, pending, nullptr });
+			hasPending = false;
+		}
+		writeHeld(0, false);
+		currentTime = NO_TIME;		// the sentences read after are undated too
+	}
+	service = nullptr;
+}
+
+void ArchiveWriter::detach(){
+	detachService();
+	if (parser != nullptr){
+		parser->onSentence.removeHandler(sentenceHandler);
+		parser = nullptr;
+	}
+}
+
+
+
+// ------------- ARCHIVE READER ----------------
+
+ArchiveReader::ArchiveReader()
+{}
+
+ArchiveReader::~ArchiveReader()
+{}
+
+bool ArchiveReader::open(const string& path, string* error){
+	close();
+	if (!file.open(path)){
+		if (error){
+			*error = "Cannot open " + path;
+		}
+		return false;
+	}
+
+	const uint8_t* d = file.data();
+	size_t size = file.size();
+	if (size < FILE_HEADER_SIZE || memcmp(d, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0){
+		if (error){
+			*error = path + " is not a NemaTode archive.";
+		}
+		close();
+		return false;
+	}
+	if ((d[4] | (d[5] << 8)) != VERSION){
+		if (error){
+			*error = path + " has an unsupported archive version.";
+		}
+		close();
+		return false;
+	}
+
+	size_t pos = FILE_HEADER_SIZE;
+	while (pos < size){
+		if (size - pos < BLOCK_HEADER_SIZE || memcmp(d + pos, BLOCK_MAGIC, sizeof(BLOCK_MAGIC)) != 0){
+			truncated = true;
+			break;
+		}
+		const uint8_t* h = d + pos;
+		BlockInfo b;
+		b.payloadBytes = getU32(h + 4);
+		b.fixCount = getU32(h + 8);
+		b.sentenceCount = getU32(h + 12);
+		b.firstTime = (int64_t)getU64(h + 16);
+		b.lastTime = (int64_t)getU64(h + 24);
+		b.crc = getU32(h + 32);
+		b.offset = pos + BLOCK_HEADER_SIZE;
+		if (size - b.offset < b.payloadBytes){
+			truncated = true;
+			break;
+		}
+		index.push_back(b);
+		pos = b.offset + b.payloadBytes;
+	}
+	return true;
+}
+
+void ArchiveReader::close(){
+	file.close();
+	index.clear();
+	truncated = false;
+}
+
+size_t ArchiveReader::findBlock(int64_t time) const {
+	size_t lo = 0;
+	size_t hi = index.size();
+	while (lo < hi){
+		size_t mid = lo + (hi - lo) / 2;
+		if (index[mid].lastTime < time){
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+bool ArchiveReader::verify(size_t block) const {
+	const BlockInfo& b = index.at(block);
+	return crc32(file.data() + b.offset, b.payloadBytes) == b.crc;
+}
+
+bool ArchiveReader::readBlock(size_t block, const FixHandler& onFix, const SentenceHandler& onSentence) const {
+	if (verifyChecksums && !verify(block)){
+		return false;
+	}
+	const BlockInfo& b = index.at(block);
+	Cursor c{ file.data() + b.offset, file.data() + b.offset + b.payloadBytes };
+
+	int64_t v[11] = {};
+	int64_t sentenceTime = 0;
+	FixRecord fix;
+	ArchivedSentence sentence;
+	unordered_map<string_view, vector<string_view>> previousParameters;
+
+	while (c.ok && c.p < c.end){
+		uint8_t tag = c.byte();
+		if (tag == TAG_FIX){
+			for (size_t i = 0; i < 11; i++){
+				v[i] = (int64_t)((uint64_t)v[i] + (uint64_t)c.svarint());
+			}
+			fix.status = (char)c.byte();
+			fix.quality = c.byte();
+			fix.type = c.byte();
+			fix.satellites = c.byte();
+			if (!c.ok){
+				break;
+			}
+			if (onFix){
+				fix.time = v[0];
+				fix.receiveTime = v[1];
+				fix.latitude = v[2];
+				fix.longitude = v[3];
+				fix.altitude = (double)v[4] / ALTITUDE_SCALE;
+				fix.speed = (double)v[5] / SPEED_SCALE;
+				fix.travelAngle = (double)v[6] / ANGLE_SCALE;
+				fix.heading = (double)v[7] / ANGLE_SCALE;
+				fix.roll = (double)v[8] / ANGLE_SCALE;
+				fix.pitch = (double)v[9] / ANGLE_SCALE;
+				fix.horizontalDilution = (float)((double)v[10] / DILUTION_SCALE);
+				onFix(fix);
+			}
+		}
+		else if (tag == TAG_SENTENCE){
+			sentenceTime = (int64_t)((uint64_t)sentenceTime + (uint64_t)c.svarint());
+			uint8_t flags = c.byte();
+			sentence.checksum = (flags & FLAG_HAS_CHECKSUM) ? c.byte() : 0;
+			sentence.name = c.text(c.byte());
+			uint64_t count = c.varint();
+			if (count > b.payloadBytes){
+				return false;
+			}
+			vector<string_view>& previous = previousParameters[sentence.name];
+			if (previous.size() < count){
+				previous.resize(count);
+			}
+			sentence.parameters.resize(count);
+			for (uint64_t i = 0; i < count && c.ok; i++){
+				uint64_t length = c.varint();
+				if (length > 0){
+					previous[i] = c.text(length - 1);
+				}
+				sentence.parameters[i] = previous[i];
+			}
+			if (!c.ok){
+				break;
+			}
+			if (onSentence){
+				sentence.time = sentenceTime;
+				sentence.start = (flags & FLAG_BANG) ? '!' : '$';
+				sentence.hasChecksum = (flags & FLAG_HAS_CHECKSUM) != 0;
+				sentence.checksumOK = (flags & FLAG_CHECKSUM_OK) != 0;
+				onSentence(sentence);
+			}
+		}
+		else {
+			return false;
+		}
+	}
+	return c.ok;
+}
+
+size_t ArchiveReader::scan(int64_t from, int64_t to, const FixHandler& onFix, const SentenceHandler& onSentence) const {
+	size_t count = 0;
+	FixHandler fixes;
+	SentenceHandler sentences;
+	if (onFix){
+		fixes = [&](const FixRecord& f){
+			if (f.time >= from && f.time <= to){
+				onFix(f);
+				count++;
+			}
+		};
+	}
+	if (onSentence){
+		sentences = [&](const ArchivedSentence& s){
+			if (s.time >= from && s.time <= to){
+				onSentence(s);
+				count++;
+			}
+		};
+	}
+
+	// the headers are all in memory, so check every block rather than assume they are in time order
+	for (size_t i = 0; i < index.size(); i++){
+		if (index[i].lastTime < from || index[i].firstTime > to){
+			continue;
+		}
+		readBlock(i, fixes, sentences);
+	}
+	return count;
+}
@@ -0,0 +1,99 @@
+/*
+ * CRC.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/CRC.h>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+
+	// Slicing by 8: entries[k][b] is the CRC of byte b followed by k zero bytes,
+	// so 8 bytes are folded in with 8 lookups.
+	struct Crc32Table {
+		uint32_t entries[8][256];
+
+		constexpr Crc32Table() : entries() {
+			for (uint32_t i = 0; i < 256; i++){
+				uint32_t c = i;
+				for (int k = 0; k < 8; k++){
+					c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+				}
+				entries[0][i] = c;
+			}
+			for (int k = 1; k < 8; k++){
+				for (uint32_t i = 0; i < 256; i++){
+					uint32_t c = entries[k - 1][i];
+					entries[k][i] = (c >> 8) ^ entries[0][c & 0xFF];
+				}
+			}
+		}
+	};
+
+	constexpr Crc32Table CRC32_TABLE;
+
+	// Slicing by 3, most significant bit first: entries[k][b] is the CRC of byte b followed
+	// by k zero bytes, and 3 bytes fill the 24 bit register.
+	struct Crc24qTable {
+		uint32_t entries[3][256];
+
+		constexpr Crc24qTable() : entries() {
+			for (uint32_t i = 0; i < 256; i++){
+				uint32_t c = i << 16;
+				for (int k = 0; k < 8; k++){
+					c = (c & 0x800000) ? ((c << 1) ^ 0x864CFB) : (c << 1);
+				}
+				entries[0][i] = c & 0xFFFFFF;
+			}
+			for (int k = 1; k < 3; k++){
+				for (uint32_t i = 0; i < 256; i++){
+					uint32_t c = entries[k - 1][i];
+					entries[k][i] = ((c << 8) & 0xFFFFFF) ^ entries[0][c >> 16];
+				}
+			}
+		}
+	};
+
+	constexpr Crc24qTable CRC24Q_TABLE;
+
+	uint32_t littleEndian32(const uint8_t* p){
+		return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+	}
+
+}
+
+uint32_t nmea::crc32(const void* data, size_t size, uint32_t crc){
+	const uint32_t (*t)[256] = CRC32_TABLE.entries;
+	const uint8_t* p = (const uint8_t*)data;
+	crc = ~crc;
+	for (; size >= 8; size -= 8, p += 8){
+		uint32_t one = littleEndian32(p) ^ crc;
+		uint32_t two = littleEndian32(p + 4);
+		crc = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF] ^ t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24]
+			^ t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF] ^ t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+	}
+	for (; size > 0; size--, p++){
+		crc = t[0][(crc ^ *p) & 0xFF] ^ (crc >> 8);
+	}
+	return ~crc;
+}
+
+uint32_t nmea::crc24q(const void* data, size_t size, uint32_t crc){
+	const uint32_t (*t)[256] = CRC24Q_TABLE.entries;
+	const uint8_t* p = (const uint8_t*)data;
+	crc &= 0xFFFFFF;
+	for (; size >= 3; size -= 3, p += 3){
+		uint32_t x = crc ^ ((uint32_t)p[0] << 16 | (uint32_t)p[1] << 8 | p[2]);
+		crc = t[2][x >> 16] ^ t[1][(x >> 8) & 0xFF] ^ t[0][x & 0xFF];
+	}
+	for (; size > 0; size--, p++){
+		crc = ((crc << 8) & 0xFFFFFF) ^ t[0][(crc >> 16) ^ *p];
+	}
+	return crc;
+}
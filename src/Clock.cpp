@@ -0,0 +1,41 @@
+/*
+ * Clock.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/Clock.h>
+#include <chrono>
+
+using namespace std;
+using namespace nmea;
+
+
+// ------------- CLOCK ----------------
+
+const Clock& Clock::system(){
+	static const SystemClock clock;
+	return clock;
+}
+
+int64_t SystemClock::now() const {
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::system_clock::now().time_since_epoch()).count();
+}
+
+ManualClock::ManualClock(int64_t start)
+	: time(start)
+{}
+
+int64_t ManualClock::now() const {
+	return time.load(memory_order_relaxed);
+}
+
+void ManualClock::set(int64_t t){
+	time.store(t, memory_order_relaxed);
+}
+
+void ManualClock::advance(int64_t nanoseconds){
+	time.fetch_add(nanoseconds, memory_order_relaxed);
+}
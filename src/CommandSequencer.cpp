@@ -0,0 +1,173 @@
+/*
+ * CommandSequencer.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/CommandSequencer.h>
+#include <utility>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	string encode(const NMEACommand& command){
+		string text(NMEACommand::MAX_LENGTH, '\0');
+		size_t length = command.encodeTo(&text[0], text.size());
+		while (length == 0){		// a long generic message
+			text.resize(text.size() * 2);
+			length = command.encodeTo(&text[0], text.size());
+		}
+		text.resize(length);
+		return text;
+	}
+}
+
+
+
+// ------------- COMMAND SEQUENCER ----------------
+
+CommandSequencer::CommandSequencer(function<void(const char* data, size_t size)> write)
+	: writer(move(write))
+{
+}
+
+CommandSequencer::~CommandSequencer(){
+}
+
+void CommandSequencer::setClock(const Clock& clock){
+	timeSource = &clock;
+}
+
+void CommandSequencer::attachToParser(NMEAParser& parser){
+	parser.onSentence += [this](const NMEASentence& nmea){
+		this->readSentence(nmea);
+	};
+}
+
+void CommandSequencer::add(string_view text, CommandAck ack, string_view reply){
+	queue.push_back(Step{ string(text), string(reply), ack, 0 });
+}
+
+void CommandSequencer::add(const NMEACommand& command, CommandAck ack, string_view reply){
+	queue.push_back(Step{ encode(command), string(reply), ack, 0 });
+}
+
+void CommandSequencer::add(const NMEACommandSerialConfiguration& command){
+	queue.push_back(Step{ encode(command), string(), CommandAck::AnySentence, command.baud });
+}
+
+void CommandSequencer::clear(){
+	queue.clear();
+	waiting = false;
+	blockedSince = -1;
+}
+
+void CommandSequencer::readSentence(const NMEASentence& nmea){
+	flowRead = false;
+	if (!nmea.checksumOK()){
+		return;
+	}
+	if (waiting){
+		const Step& step = queue.front();
+		if (step.ack == CommandAck::AnySentence || (step.ack == CommandAck::Sentence && nmea.name == step.reply)){
+			complete();
+		}
+	}
+	if (nmea.name == "PSRF150" && !nmea.parameters.empty()){
+		setReady(nmea.parameters[0] == "1");
+		flowRead = true;		// the service reads it next: once is enough
+		return;
+	}
+	pump();
+}
+
+void CommandSequencer::okToSend(bool ok){
+	if (flowRead){
+		flowRead = false;
+		return;
+	}
+	setReady(ok);
+}
+
+void CommandSequencer::setReady(bool ok){
+	ready = ok;
+	if (ok && waiting && queue.front().ack == CommandAck::OkToSend){
+		complete();
+	}
+	pump();
+}
+
+void CommandSequencer::poll(){
+	int64_t now = timeSource->now();
+	if (!waiting && blockedSince >= 0 && now - blockedSince > timeout * (retries + 1)){
+		fail();			// the receiver stays not ready
+	}
+	else if (waiting && now - sentAt > timeout){
+		Step& step = queue.front();
+		if (step.baud != 0 && previousBaud != 0 && changeBaud){
+			changeBaud(previousBaud);		// the receiver did not follow: back to where it listens
+			baud = previousBaud;
+		}
+		if (attempts <= retries){
+			retried++;
+			transmit();
+		}
+		else {
+			fail();
+		}
+	}
+	pump();
+}
+
+void CommandSequencer::pump(){
+	while (!queue.empty() && !waiting && ready){
+		attempts = 0;
+		transmit();
+		if (queue.front().ack == CommandAck::None){
+			complete();
+		}
+	}
+	if (queue.empty() || waiting){
+		blockedSince = -1;
+	}
+	else if (blockedSince < 0){
+		blockedSince = timeSource->now();		// held back by the receiver
+	}
+}
+
+void CommandSequencer::fail(){
+	failed++;
+	Step lost = move(queue.front());
+	queue.clear();
+	waiting = false;
+	blockedSince = -1;
+	onFailed(lost.text);
+}
+
+void CommandSequencer::transmit(){
+	const Step& step = queue.front();
+	writer(step.text.data(), step.text.size());
+	sent++;
+	attempts++;
+	sentAt = timeSource->now();
+	waiting = true;
+	if (step.baud != 0 && changeBaud){
+		previousBaud = baud;
+		changeBaud(step.baud);
+		baud = step.baud;
+	}
+}
+
+void CommandSequencer::complete(){
+	Step done = move(queue.front());		// the handlers may change the queue
+	queue.pop_front();
+	waiting = false;
+	onAcknowledged(done.text);
+	if (queue.empty()){
+		onIdle();
+	}
+}
@@ -0,0 +1,697 @@
+/*
+ * Compressor.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/Compressor.h>
+#include <nmeaparse/NMEATokenizer.h>
+#include <nmeaparse/CRC.h>
+#include <cstring>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	const char MAGIC[4] = { 'N', 'M', 'T', 'Z' };
+	const uint16_t VERSION = 1;
+	const size_t HEADER_SIZE = 8;
+	const size_t FRAME_HEADER_SIZE = 12;
+
+	const size_t MAX_NAME = 64;
+	const size_t MAX_LINE = 64 * 1024;		// longer runs without a line end are cut, as lines without one
+	const unsigned MAX_DIGITS = 18;
+
+	const uint8_t CRLF = 0;
+	const uint8_t LF = 1;
+	const uint8_t NO_ENDING = 2;
+
+	const uint8_t NO_CHECKSUM = 0;
+	const uint8_t IMPLICIT_CHECKSUM = 1;
+	const uint8_t EXPLICIT_CHECKSUM = 2;
+
+	const char NIBBLES[] = "0123456789.-NEWS";
+	const char HEX[] = "0123456789ABCDEF";
+
+	struct NibbleTable {
+		int8_t value[256];
+		NibbleTable(){
+			memset(value, -1, sizeof(value));
+			for (int i = 0; i < 16; i++){
+				value[(uint8_t)NIBBLES[i]] = (int8_t)i;
+			}
+		}
+	};
+	const NibbleTable Nibble;
+
+	const uint64_t POW10[MAX_DIGITS + 1] = {
+		1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+		1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+		100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+		1000000000000000000ULL
+	};
+
+	void putU16(vector<uint8_t>& s, uint16_t v){
+		s.push_back((uint8_t)(v & 0xFF));
+		s.push_back((uint8_t)(v >> 8));
+	}
+
+	void putU32(uint8_t* p, uint32_t v){
+		for (int i = 0; i < 4; i++){
+			p[i] = (uint8_t)((v >> (8 * i)) & 0xFF);
+		}
+	}
+
+	uint32_t getU32(const uint8_t* p){
+		return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+	}
+
+	bool isAlphaNum(char c){
+		return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+	}
+
+	// 0 in 1 bit, then 1..16, 17..272 and 273..65808 in 6, 11 and 20 bits, the rest in 68
+	void writeCount(BitWriter& w, uint64_t v){
+		if (v == 0){
+			w.write(0, 1);
+		}
+		else if (v <= 16){
+			w.write((0x2ULL << 4) | (v - 1), 6);
+		}
+		else if (v <= 272){
+			w.write((0x6ULL << 8) | (v - 17), 11);
+		}
+		else if (v <= 65808){
+			w.write((0xEULL << 16) | (v - 273), 20);
+		}
+		else {
+			w.write(0xF, 4);
+			w.write(v, 64);
+		}
+	}
+
+	void writeSigned(BitWriter& w, int64_t v){
+		writeCount(w, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+	}
+
+	// Bounds checked reading of a frame
+	struct Bits {
+		BitReader reader;
+		bool ok{true};
+
+		size_t left() const		{ return reader.pos < reader.bits ? reader.bits - reader.pos : 0; }
+
+		uint64_t read(unsigned n){
+			if (left() < n){
+				ok = false;
+				reader.pos = reader.bits;
+				return 0;
+			}
+			return reader.read(n);
+		}
+		bool bit()				{ return read(1) != 0; }
+
+		uint64_t count(){
+			if (!bit())		return 0;
+			if (!bit())		return read(4) + 1;
+			if (!bit())		return read(8) + 17;
+			if (!bit())		return read(16) + 273;
+			return read(64);
+		}
+		int64_t readSigned(){
+			uint64_t z = count();
+			return (int64_t)(z >> 1) ^ -(int64_t)(z & 1);
+		}
+	};
+
+	struct Number {
+		bool negative{false};
+		bool dot{false};
+		uint8_t intDigits{0};
+		uint8_t decimals{0};
+		uint64_t magnitude{0};
+	};
+
+	// [-]digits[.digits], 1 to MAX_DIGITS digits in all
+	bool parseNumber(string_view s, Number& n){
+		size_t i = 0;
+		if (i < s.size() && s[i] == '-'){
+			n.negative = true;
+			i++;
+		}
+		unsigned digits = 0;
+		for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; i++){
+			n.magnitude = n.magnitude * 10 + (uint64_t)(s[i] - '0');
+			if (++digits > MAX_DIGITS){
+				return false;
+			}
+		}
+		n.intDigits = (uint8_t)digits;
+		if (i < s.size() && s[i] == '.'){
+			n.dot = true;
+			for (i++; i < s.size() && s[i] >= '0' && s[i] <= '9'; i++){
+				n.magnitude = n.magnitude * 10 + (uint64_t)(s[i] - '0');
+				if (++digits > MAX_DIGITS){
+					return false;
+				}
+			}
+			n.decimals = (uint8_t)(digits - n.intDigits);
+		}
+		return i == s.size() && digits > 0;
+	}
+
+	void formatNumber(const CompressionModel::Field& f, string& out){
+		unsigned width = f.intDigits + f.decimals;
+		char buffer[MAX_DIGITS + 2];
+		uint64_t m = f.magnitude;
+		for (unsigned i = width; i > 0; i--){
+			buffer[i - 1] = (char)('0' + m % 10);
+			m /= 10;
+		}
+		out.clear();
+		if (f.negative){
+			out.push_back('-');
+		}
+		out.append(buffer, f.intDigits);
+		if (f.dot){
+			out.push_back('.');
+			out.append(buffer + f.intDigits, f.decimals);
+		}
+	}
+
+	void appendEnding(string& text, uint8_t ending){
+		if (ending == CRLF){
+			text.append("\r\n", 2);
+		}
+		else if (ending == LF){
+			text.push_back('\n');
+		}
+	}
+}
+
+
+
+// ------------- COMPRESSOR ----------------
+
+NMEACompressor::NMEACompressor(Output out)
+: output(out)
+{}
+
+NMEACompressor::~NMEACompressor()
+{}
+
+void NMEACompressor::write(const void* data, size_t size){
+	bytesIn += size;
+	const char* p = (const char*)data;
+	const char* end = p + size;
+	while (p < end){
+		const char* nl = (const char*)memchr(p, '\n', end - p);
+		if (nl == nullptr){
+			partial.append(p, end - p);
+			if (partial.size() >= MAX_LINE){
+				encodeLine(partial, NO_ENDING);
+				partial.clear();
+			}
+			return;
+		}
+		string_view line(p, nl - p);
+		if (!partial.empty()){
+			partial.append(p, nl - p);
+			line = partial;
+		}
+		uint8_t ending = LF;
+		if (!line.empty() && line.back() == '\r'){
+			line.remove_suffix(1);
+			ending = CRLF;
+		}
+		encodeLine(line, ending);
+		partial.clear();
+		p = nl + 1;
+	}
+}
+
+void NMEACompressor::encodeLine(string_view line, uint8_t ending){
+	if (!encodeSentence(line, ending)){
+		encodeRaw(line, ending);
+	}
+	lines++;
+	if (bits.bits >= frameSize * 8){
+		flush();
+	}
+}
+
+bool NMEACompressor::encodeSentence(string_view line, uint8_t ending){
+	if (line.size() < 2 || line[0] != '$'){
+		return false;
+	}
+	NMEATokenizer tokens;
+	tokens.tokenize(line);
+	if (tokens.sentence.size() + 1 != line.size()){
+		return false;		// more than one '$'
+	}
+	if (tokens.name.empty() || tokens.name.size() > MAX_NAME){
+		return false;
+	}
+	for (char c : tokens.name){
+		if (!isAlphaNum(c)){
+			return false;
+		}
+	}
+	uint8_t checksum = NO_CHECKSUM;
+	if (tokens.hasChecksum){
+		if (!tokens.checksumSplit || tokens.checksum.size() != 2){
+			return false;
+		}
+		bool same = tokens.checksum[0] == HEX[tokens.calculatedChecksum >> 4] && tokens.checksum[1] == HEX[tokens.calculatedChecksum & 0xF];
+		checksum = same ? IMPLICIT_CHECKSUM : EXPLICIT_CHECKSUM;
+	}
+	uint32_t fieldCount = tokens.hasFields ? 1 : 0;
+	for (char c : tokens.fields){
+		if (c < 0x20 || c > 0x7E){
+			return false;
+		}
+		fieldCount += c == ',';
+	}
+
+	// the name
+	bits.writeBit(true);
+	vector<CompressionModel::Type>& types = model.types;
+	uint32_t predicted = model.last < types.size() ? types[model.last].next : UINT32_MAX;
+	uint32_t id = UINT32_MAX;
+	if (predicted != UINT32_MAX && types[predicted].name == tokens.name){
+		id = predicted;
+	}
+	else {
+		for (uint32_t i = 0; i < types.size(); i++){
+			if (types[i].name == tokens.name){
+				id = i;
+				break;
+			}
+		}
+	}
+	if (predicted != UINT32_MAX){
+		bits.writeBit(id == predicted);
+	}
+	if (predicted == UINT32_MAX || id != predicted){
+		if (id == UINT32_MAX){
+			id = (uint32_t)types.size();
+			writeCount(bits, id);
+			writeCount(bits, tokens.name.size());
+			for (char c : tokens.name){
+				bits.write((uint8_t)c, 7);
+			}
+			types.emplace_back();
+			types.back().name = string(tokens.name);
+		}
+		else {
+			writeCount(bits, id);
+		}
+	}
+	if (model.last < types.size()){
+		types[model.last].next = id;
+	}
+	model.last = id;
+
+	// its shape
+	CompressionModel::Type& type = types[id];
+	if (type.fieldCount == fieldCount && type.checksum == checksum && type.ending == ending){
+		bits.writeBit(false);
+	}
+	else {
+		bits.writeBit(true);
+		writeCount(bits, fieldCount);
+		bits.write(checksum, 2);
+		bits.write(ending, 2);
+		type.fieldCount = fieldCount;
+		type.checksum = checksum;
+		type.ending = ending;
+	}
+	if (checksum == EXPLICIT_CHECKSUM){
+		bits.write((uint8_t)tokens.checksum[0], 8);
+		bits.write((uint8_t)tokens.checksum[1], 8);
+	}
+
+	// and the fields
+	if (type.fields.size() < fieldCount){
+		type.fields.resize(fieldCount);
+	}
+	NMEATokenizer::FieldReader reader = tokens.fieldReader();
+	string_view field;
+	for (uint32_t i = 0; reader.next(field); i++){
+		CompressionModel::Field& f = type.fields[i];
+		if (field == f.text){
+			bits.writeBit(false);
+			f.step = 0;
+			continue;
+		}
+		Number n;
+		if (parseNumber(field, n)){
+			int64_t change = (int64_t)(n.magnitude - (f.numeric ? f.magnitude : 0));
+			if (f.numeric && f.negative == n.negative && f.dot == n.dot && f.intDigits == n.intDigits && f.decimals == n.decimals){
+				bits.write(0x2, 2);
+				writeSigned(bits, change - f.step);
+				f.step = change;
+			}
+			else {
+				bits.write(0x6, 3);
+				bits.writeBit(n.negative);
+				bits.write(n.intDigits, 5);
+				bits.writeBit(n.dot);
+				bits.write(n.decimals, 5);
+				writeSigned(bits, change);
+				f.step = f.numeric ? change : 0;
+				f.numeric = true;
+				f.negative = n.negative;
+				f.dot = n.dot;
+				f.intDigits = n.intDigits;
+				f.decimals = n.decimals;
+			}
+			f.magnitude = n.magnitude;
+		}
+		else {
+			bits.write(0x7, 3);
+			bool nibbles = true;
+			for (char c : field){
+				if (Nibble.value[(uint8_t)c] < 0){
+					nibbles = false;
+					break;
+				}
+			}
+			bits.writeBit(nibbles);
+			writeCount(bits, field.size());
+			for (char c : field){
+				if (nibbles){
+					bits.write((uint64_t)Nibble.value[(uint8_t)c], 4);
+				}
+				else {
+					bits.write((uint8_t)c, 7);
+				}
+			}
+			f.numeric = false;
+		}
+		f.text.assign(field.data(), field.size());
+	}
+	return true;
+}
+
+void NMEACompressor::encodeRaw(string_view line, uint8_t ending){
+	bits.writeBit(false);
+	bits.write(ending, 2);
+	writeCount(bits, line.size());
+	for (char c : line){
+		bits.write((uint8_t)c, 8);
+	}
+}
+
+void NMEACompressor::sendHeader(){
+	if (headerSent){
+		return;
+	}
+	vector<uint8_t> header(MAGIC, MAGIC + 4);
+	putU16(header, VERSION);
+	putU16(header, 0);
+	output(header.data(), header.size());
+	bytesOut += header.size();
+	headerSent = true;
+}
+
+void NMEACompressor::flush(){
+	if (lines == 0){
+		return;
+	}
+	sendHeader();
+
+	size_t payload = (bits.bits + 7) / 8;
+	frame.resize(FRAME_HEADER_SIZE + payload);
+	uint8_t* p = frame.data() + FRAME_HEADER_SIZE;
+	for (size_t i = 0; i < payload; i++){
+		p[i] = (uint8_t)(bits.words[i >> 3] >> (56 - 8 * (i & 7)));
+	}
+	putU32(frame.data(), (uint32_t)payload);
+	putU32(frame.data() + 4, lines);
+	putU32(frame.data() + 8, crc32(p, payload));
+	output(frame.data(), frame.size());
+	bytesOut += frame.size();
+
+	bits.clear();
+	lines = 0;
+}
+
+void NMEACompressor::finish(){
+	if (!partial.empty()){
+		encodeLine(partial, NO_ENDING);
+		partial.clear();
+	}
+	sendHeader();
+	flush();
+}
+
+string NMEACompressor::compress(string_view data){
+	string out;
+	NMEACompressor compressor([&out](const uint8_t* p, size_t n){
+		out.append((const char*)p, n);
+	});
+	compressor.write(data.data(), data.size());
+	compressor.finish();
+	return out;
+}
+
+
+
+// ------------- DECOMPRESSOR ----------------
+
+NMEADecompressor::NMEADecompressor(Output out)
+: output(out)
+{}
+
+NMEADecompressor::~NMEADecompressor()
+{}
+
+bool NMEADecompressor::fail(const string& message, string* error){
+	failed = true;
+	if (error){
+		*error = message;
+	}
+	return false;
+}
+
+bool NMEADecompressor::write(const void* data, size_t size, string* error){
+	if (failed){
+		return fail("Corrupt compressed stream", error);
+	}
+
+	// frames are decoded from the data itself, the remainder is kept for the next write
+	const uint8_t* p = (const uint8_t*)data;
+	if (!pending.empty()){
+		pending.insert(pending.end(), p, p + size);
+		p = pending.data();
+		size = pending.size();
+	}
+	size_t pos = 0;
+	if (!headerRead){
+		if (size < HEADER_SIZE){
+			if (p != pending.data()){
+				pending.assign(p, p + size);
+			}
+			return true;
+		}
+		if (memcmp(p, MAGIC, 4) != 0 || (p[4] | (p[5] << 8)) != VERSION){
+			return fail("Not a compressed NMEA stream", error);
+		}
+		headerRead = true;
+		pos = HEADER_SIZE;
+	}
+	while (size - pos >= FRAME_HEADER_SIZE){
+		uint32_t payload = getU32(p + pos);
+		uint32_t lineCount = getU32(p + pos + 4);
+		if (size - pos - FRAME_HEADER_SIZE < payload){
+			break;
+		}
+		const uint8_t* bytes = p + pos + FRAME_HEADER_SIZE;
+		if (crc32(bytes, payload) != getU32(p + pos + 8)){
+			return fail("Checksum mismatch in a frame of the compressed stream", error);
+		}
+		if (!decodeFrame(bytes, payload, lineCount)){
+			return fail("Corrupt frame in the compressed stream", error);
+		}
+		pos += FRAME_HEADER_SIZE + payload;
+	}
+	if (p == pending.data()){
+		pending.erase(pending.begin(), pending.begin() + pos);
+	}
+	else {
+		pending.assign(p + pos, p + size);
+	}
+	return true;
+}
+
+bool NMEADecompressor::finish(string* error){
+	if (failed){
+		return fail("Corrupt compressed stream", error);
+	}
+	if (!headerRead){
+		return fail("Not a compressed NMEA stream", error);
+	}
+	if (!pending.empty()){
+		return fail("The compressed stream ends inside a frame", error);
+	}
+	return true;
+}
+
+bool NMEADecompressor::decodeFrame(const uint8_t* payload, size_t size, uint32_t lineCount){
+	if (lineCount > size * 8){
+		return false;
+	}
+	words.assign(size / 8 + 2, 0);
+	for (size_t i = 0; i < size; i++){
+		words[i >> 3] |= (uint64_t)payload[i] << (56 - 8 * (i & 7));
+	}
+	Bits in;
+	in.reader = BitReader(words.data(), size * 8);
+	vector<CompressionModel::Type>& types = model.types;
+	text.clear();
+
+	for (uint32_t l = 0; l < lineCount && in.ok; l++){
+		if (!in.bit()){
+			uint8_t ending = (uint8_t)in.read(2);
+			uint64_t length = in.count();
+			if (ending > NO_ENDING || length > in.left() / 8){
+				return false;
+			}
+			for (uint64_t i = 0; i < length; i++){
+				text.push_back((char)in.read(8));
+			}
+			appendEnding(text, ending);
+			continue;
+		}
+
+		// the name
+		uint32_t predicted = model.last < types.size() ? types[model.last].next : UINT32_MAX;
+		uint64_t id = predicted;
+		if (predicted == UINT32_MAX || !in.bit()){
+			id = in.count();
+			if (id > types.size()){
+				return false;
+			}
+			if (id == types.size()){
+				uint64_t length = in.count();
+				if (length == 0 || length > MAX_NAME || length > in.left() / 7){
+					return false;
+				}
+				types.emplace_back();
+				for (uint64_t i = 0; i < length; i++){
+					types.back().name.push_back((char)in.read(7));
+				}
+			}
+		}
+		if (model.last < types.size()){
+			types[model.last].next = (uint32_t)id;
+		}
+		model.last = (uint32_t)id;
+
+		// its shape
+		CompressionModel::Type& type = types[id];
+		if (in.bit()){
+			uint64_t fieldCount = in.count();
+			type.checksum = (uint8_t)in.read(2);
+			type.ending = (uint8_t)in.read(2);
+			if (fieldCount > in.left() || type.checksum > EXPLICIT_CHECKSUM || type.ending > NO_ENDING){
+				return false;
+			}
+			type.fieldCount = (uint32_t)fieldCount;
+		}
+		char explicitChecksum[2];
+		if (type.checksum == EXPLICIT_CHECKSUM){
+			explicitChecksum[0] = (char)in.read(8);
+			explicitChecksum[1] = (char)in.read(8);
+		}
+
+		// and the fields
+		size_t start = text.size();
+		text.push_back('$');
+		text += type.name;
+		if (type.fields.size() < type.fieldCount){
+			type.fields.resize(type.fieldCount);
+		}
+		for (uint32_t i = 0; i < type.fieldCount; i++){
+			CompressionModel::Field& f = type.fields[i];
+			text.push_back(',');
+			if (!in.bit()){
+				f.step = 0;
+			}
+			else if (!in.bit()){
+				if (!f.numeric){
+					return false;
+				}
+				f.step += in.readSigned();
+				f.magnitude += (uint64_t)f.step;
+				if (f.magnitude >= POW10[f.intDigits + f.decimals]){
+					return false;
+				}
+				formatNumber(f, f.text);
+			}
+			else if (!in.bit()){
+				f.negative = in.bit();
+				f.intDigits = (uint8_t)in.read(5);
+				f.dot = in.bit();
+				f.decimals = (uint8_t)in.read(5);
+				int64_t change = in.readSigned();
+				unsigned width = f.intDigits + f.decimals;
+				if (width == 0 || width > MAX_DIGITS || (!f.dot && f.decimals > 0)){
+					return false;
+				}
+				f.magnitude = (f.numeric ? f.magnitude : 0) + (uint64_t)change;
+				f.step = f.numeric ? change : 0;
+				f.numeric = true;
+				if (f.magnitude >= POW10[width]){
+					return false;
+				}
+				formatNumber(f, f.text);
+			}
+			else {
+				bool nibbles = in.bit();
+				uint64_t length = in.count();
+				if (length > in.left() / (nibbles ? 4 : 7)){
+					return false;
+				}
+				f.text.clear();
+				for (uint64_t c = 0; c < length; c++){
+					f.text.push_back(nibbles ? NIBBLES[in.read(4)] : (char)in.read(7));
+				}
+				f.numeric = false;
+			}
+			text += f.text;
+		}
+
+		if (type.checksum == IMPLICIT_CHECKSUM){
+			uint8_t x = 0;
+			for (size_t i = start + 1; i < text.size(); i++){
+				x ^= (uint8_t)text[i];
+			}
+			text.push_back('*');
+			text.push_back(HEX[x >> 4]);
+			text.push_back(HEX[x & 0xF]);
+		}
+		else if (type.checksum == EXPLICIT_CHECKSUM){
+			text.push_back('*');
+			text.append(explicitChecksum, 2);
+		}
+		appendEnding(text, type.ending);
+	}
+	if (!in.ok){
+		return false;
+	}
+	output((const uint8_t*)text.data(), text.size());
+	return true;
+}
+
+bool NMEADecompressor::decompress(string_view data, string& out, string* error){
+	out.clear();
+	NMEADecompressor decompressor([&out](const uint8_t* p, size_t n){
+		out.append((const char*)p, n);
+	});
+	return decompressor.write(data.data(), data.size(), error) && decompressor.finish(error);
+}
@@ -0,0 +1,253 @@
+/*
+ * Demultiplexer.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/Demultiplexer.h>
+#include <nmeaparse/CRC.h>
+#include <algorithm>
+#include <string>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	const size_t NEED_MORE = SIZE_MAX;
+
+	// The bytes that can start a frame
+	struct StartTable {
+		bool entries[256];
+
+		constexpr StartTable() : entries() {
+			entries[(uint8_t)'$'] = true;
+			entries[(uint8_t)'!'] = true;
+			entries[0xD3] = true;		// RTCM3
+			entries[0xB5] = true;		// UBX
+			entries[0xA0] = true;		// SiRF
+		}
+	};
+
+	constexpr StartTable STARTS;
+}
+
+
+
+// ------------- STREAM DEMULTIPLEXER ----------------
+
+StreamDemultiplexer::StreamDemultiplexer(){
+}
+
+StreamDemultiplexer::~StreamDemultiplexer(){
+}
+
+void StreamDemultiplexer::attach(NMEAParser& parser){
+	onSentence += [&parser](string_view sentence){
+		try {
+			parser.readSentence(string(sentence));
+		}
+		catch (NMEAParseError&){
+			// skipped, as in a byte stream
+		}
+	};
+}
+
+void StreamDemultiplexer::attach(UBXDecoder& decoder){
+	onUBX += [&decoder](const uint8_t* frame, size_t size){
+		decoder.readFrame(frame, size);
+	};
+}
+
+void StreamDemultiplexer::attach(SiRFDecoder& decoder){
+	onSiRF += [&decoder](const uint8_t* frame, size_t size){
+		decoder.readFrame(frame, size);
+	};
+}
+
+size_t StreamDemultiplexer::frameAt(const uint8_t* data, size_t size, bool last, Protocol& protocol, size_t& lineEnd) const {
+	const size_t need = last ? 0 : NEED_MORE;
+	switch (data[0]){
+	case '$':
+	case '!': {
+		protocol = Protocol::NMEA;
+		size_t limit = min(size, MAX_LINE + 2);
+		for (size_t k = 1; k < limit; k++){
+			uint8_t c = data[k];
+			if (c == '\n'){
+				lineEnd = data[k - 1] == '\r' ? k - 1 : k;
+				return k + 1;
+			}
+			if (c == '\r'){
+				if (k + 1 < size && data[k + 1] != '\n'){
+					return 0;
+				}
+			}
+			else if (c < 0x20 || c > 0x7E){
+				return 0;		// binary data, the '$' was not a sentence
+			}
+		}
+		if (limit == size && size < MAX_LINE + 2){
+			if (!last){
+				return NEED_MORE;
+			}
+			lineEnd = data[size - 1] == '\r' ? size - 1 : size;
+			return lineEnd > 1 ? size : 0;
+		}
+		return 0;		// too long
+	}
+
+	case 0xD3: {
+		protocol = Protocol::RTCM3;
+		if (size < 3){
+			return need;
+		}
+		if (data[1] & 0xFC){
+			return 0;		// the reserved bits are 0
+		}
+		size_t length = (size_t)(data[1] & 0x3) << 8 | data[2];
+		size_t total = length + 6;
+		if (size < total){
+			return need;
+		}
+		uint32_t crc = (uint32_t)data[total - 3] << 16 | (uint32_t)data[total - 2] << 8 | data[total - 1];
+		return crc24q(data, length + 3) == crc ? total : 0;
+	}
+
+	case 0xB5: {
+		protocol = Protocol::UBX;
+		if (size < 2){
+			return need;
+		}
+		if (data[1] != 0x62){
+			return 0;
+		}
+		if (size < 6){
+			return need;
+		}
+		size_t length = data[4] | (size_t)data[5] << 8;
+		if (length > UBXDecoder::MAX_PAYLOAD){
+			return 0;
+		}
+		size_t total = length + UBXDecoder::OVERHEAD;
+		if (size < total){
+			return need;
+		}
+		uint16_t ck = (uint16_t)(data[total - 2] | data[total - 1] << 8);
+		return UBXDecoder::checksum(data + 2, length + 4) == ck ? total : 0;
+	}
+
+	case 0xA0: {
+		protocol = Protocol::SiRF;
+		if (size < 2){
+			return need;
+		}
+		if (data[1] != 0xA2){
+			return 0;
+		}
+		if (size < 4){
+			return need;
+		}
+		size_t length = (size_t)data[2] << 8 | data[3];
+		if (length == 0 || length > SiRFDecoder::MAX_PAYLOAD){
+			return 0;
+		}
+		size_t total = length + SiRFDecoder::OVERHEAD;
+		if (size < total){
+			return need;
+		}
+		uint16_t ck = (uint16_t)((data[total - 4] << 8 | data[total - 3]) & 0x7FFF);
+		if (data[total - 2] != 0xB0 || data[total - 1] != 0xB3 || SiRFDecoder::checksum(data + 4, length) != ck){
+			return 0;
+		}
+		return total;
+	}
+
+	default:
+		return 0;
+	}
+}
+
+// The bytes consumed: all of them, or up to a frame that needs more.
+size_t StreamDemultiplexer::scan(const uint8_t* data, size_t size, bool last){
+	size_t i = 0;
+	while (i < size){
+		if (!STARTS.entries[data[i]]){
+			size_t j = i + 1;
+			while (j < size && !STARTS.entries[data[j]]){
+				j++;
+			}
+			skipped += j - i;
+			i = j;
+			continue;
+		}
+
+		Protocol protocol = Protocol::NMEA;
+		size_t lineEnd = 0;
+		size_t n = frameAt(data + i, size - i, last, protocol, lineEnd);
+		if (n == NEED_MORE){
+			return i;
+		}
+		if (n == 0){
+			failed++;			// resynchronizes from the next byte
+			skipped++;
+			i++;
+			continue;
+		}
+		deliver(protocol, data + i, n, lineEnd);
+		i += n;
+	}
+	return size;
+}
+
+void StreamDemultiplexer::deliver(Protocol protocol, const uint8_t* data, size_t size, size_t lineEnd){
+	counts[(int)protocol]++;
+	switch (protocol){
+	case Protocol::NMEA:
+		onSentence(string_view((const char*)data, lineEnd));
+		break;
+	case Protocol::RTCM3:
+		onRTCM3(data, size);
+		break;
+	case Protocol::UBX:
+		onUBX(data, size);
+		break;
+	case Protocol::SiRF:
+		onSiRF(data, size);
+		break;
+	}
+}
+
+void StreamDemultiplexer::readBuffer(const uint8_t* data, size_t size){
+	// Finishes what the last chunk started, with as little of this one as it takes, then
+	// scans the rest in place.
+	size_t step = 256;
+	while (!pending.empty() && size > 0){
+		size_t old = pending.size();
+		size_t take = min(size, step);
+		pending.insert(pending.end(), data, data + take);
+		size_t used = scan(pending.data(), pending.size(), false);
+		if (used >= old){
+			data += used - old;
+			size -= used - old;
+			pending.clear();
+		}
+		else {
+			pending.erase(pending.begin(), pending.begin() + used);
+			data += take;
+			size -= take;
+			step *= 2;
+		}
+	}
+	if (size > 0){
+		size_t used = scan(data, size, false);
+		pending.assign(data + used, data + size);
+	}
+}
+
+void StreamDemultiplexer::finish(){
+	scan(pending.data(), pending.size(), true);
+	pending.clear();
+}
@@ -0,0 +1,298 @@
+/*
+ * FixHistory.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/FixHistory.h>
+#include <nmeaparse/GPSService.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	const double PI = 3.14159265358979323846;
+	const double METERS_PER_MINUTE = 1852.0;			// one arc minute of latitude
+	const int64_t HALF_TURN = 180LL * 60 * 1000000000;	// 180 degrees in 1e-9 arc minutes
+
+	// b - a for longitudes, the short way around
+	int64_t longitudeDelta(int64_t a, int64_t b){
+		int64_t d = b - a;
+		if (d > HALF_TURN){
+			d -= 2 * HALF_TURN;
+		}
+		else if (d < -HALF_TURN){
+			d += 2 * HALF_TURN;
+		}
+		return d;
+	}
+
+	int64_t normalizeLongitude(int64_t l){
+		if (l > HALF_TURN){
+			l -= 2 * HALF_TURN;
+		}
+		else if (l < -HALF_TURN){
+			l += 2 * HALF_TURN;
+		}
+		return l;
+	}
+
+	// degrees, the short way around, result in [0,360)
+	double lerpAngle(double a, double b, double f){
+		double d = fmod(b - a + 540.0, 360.0) - 180.0;
+		double r = fmod(a + d * f, 360.0);
+		return r < 0 ? r + 360.0 : r;
+	}
+
+	double lerp(double a, double b, double f){
+		return a + (b - a) * f;
+	}
+
+	// Cubic Hermite of the offset from p0, with the end slopes in units per second, h in seconds
+	double hermite(double d, double m0, double m1, double h, double s){
+		double s2 = s * s;
+		double s3 = s2 * s;
+		return (s3 - 2 * s2 + s) * h * m0 + (-2 * s3 + 3 * s2) * d + (s3 - s2) * h * m1;
+	}
+}
+
+
+
+// ------------- FIX HISTORY ----------------
+
+FixHistory::FixHistory(size_t capacity)
+	: cap(capacity == 0 ? 1 : capacity)
+	, time(cap), receiveTime(cap), latitude(cap), longitude(cap)
+	, altitude(cap), speed(cap), travelAngle(cap), heading(cap), roll(cap), pitch(cap)
+	, horizontalDilution(cap), quality(cap), type(cap), satellites(cap), status(cap)
+	, updateHandler([](){})
+{}
+
+FixHistory::~FixHistory(){
+	detach();
+}
+
+void FixHistory::clear(){
+	head = 0;
+	count = 0;
+}
+
+void FixHistory::write(size_t s, const FixRecord& r){
+	time[s] = r.time;
+	receiveTime[s] = r.receiveTime;
+	latitude[s] = r.latitude;
+	longitude[s] = r.longitude;
+	altitude[s] = r.altitude;
+	speed[s] = r.speed;
+	travelAngle[s] = r.travelAngle;
+	heading[s] = r.heading;
+	roll[s] = r.roll;
+	pitch[s] = r.pitch;
+	horizontalDilution[s] = r.horizontalDilution;
+	quality[s] = r.quality;
+	type[s] = r.type;
+	satellites[s] = r.satellites;
+	status[s] = r.status;
+}
+
+bool FixHistory::push(const FixRecord& record){
+	if (count > 0){
+		size_t last = slot(count - 1);
+		if (record.time < time[last] || record.receiveTime < receiveTime[last]){
+			return false;
+		}
+		if (record.time == time[last]){
+			write(last, record);
+			return true;
+		}
+	}
+
+	if (count == cap){
+		write(head, record);
+		head = (head + 1) % cap;
+	}
+	else {
+		write(slot(count), record);
+		count++;
+	}
+	return true;
+}
+
+FixRecord FixHistory::at(size_t i) const {
+	size_t s = slot(i);
+	FixRecord r;
+	r.time = time[s];
+	r.receiveTime = receiveTime[s];
+	r.latitude = latitude[s];
+	r.longitude = longitude[s];
+	r.altitude = altitude[s];
+	r.speed = speed[s];
+	r.travelAngle = travelAngle[s];
+	r.heading = heading[s];
+	r.roll = roll[s];
+	r.pitch = pitch[s];
+	r.horizontalDilution = horizontalDilution[s];
+	r.quality = quality[s];
+	r.type = type[s];
+	r.satellites = satellites[s];
+	r.status = status[s];
+	return r;
+}
+
+size_t FixHistory::lowerBound(int64_t t, TimeBase base) const {
+	const vector<int64_t>& ts = times(base);
+	size_t lo = 0;
+	size_t hi = count;
+	while (lo < hi){
+		size_t mid = lo + (hi - lo) / 2;
+		if (ts[slot(mid)] < t){
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+size_t FixHistory::nearest(int64_t t, TimeBase base) const {
+	if (count == 0){
+		return count;
+	}
+	size_t i = lowerBound(t, base);
+	if (i == count){
+		return count - 1;
+	}
+	if (i > 0 && t - timeAt(i - 1, base) < timeAt(i, base) - t){
+		return i - 1;
+	}
+	return i;
+}
+
+void FixHistory::blend(size_t a, size_t b, int64_t t, TimeBase base, Interpolation mode, FixRecord& out) const {
+	const vector<int64_t>& ts = times(base);
+	int64_t span = ts[b] - ts[a];
+	double f = (double)(t - ts[a]) / (double)span;
+
+	// discrete values from the closest record
+	size_t c = f < 0.5 ? a : b;
+	out.horizontalDilution = horizontalDilution[c];
+	out.quality = quality[c];
+	out.type = type[c];
+	out.satellites = satellites[c];
+	out.status = status[c];
+
+	if (base == TimeBase::UTC){
+		out.time = t;
+		out.receiveTime = receiveTime[a] + (int64_t)llround((double)(receiveTime[b] - receiveTime[a]) * f);
+	}
+	else {
+		out.receiveTime = t;
+		out.time = time[a] + (int64_t)llround((double)(time[b] - time[a]) * f);
+	}
+
+	double dLat = (double)(latitude[b] - latitude[a]);
+	double dLon = (double)longitudeDelta(longitude[a], longitude[b]);
+
+	if (mode == Interpolation::Hermite){
+		// slopes in 1e-9 arc minutes per second, from the ground speed and course
+		double h = (double)span / 1e9;
+		double latDegrees = (double)latitude[a] / 60e9;
+		double scale = max(cos(latDegrees * PI / 180.0), 1e-6);
+		double v0 = speed[a] / 3.6;
+		double v1 = speed[b] / 3.6;
+		double c0 = travelAngle[a] * PI / 180.0;
+		double c1 = travelAngle[b] * PI / 180.0;
+		double n0 = v0 * cos(c0) / METERS_PER_MINUTE * 1e9;
+		double n1 = v1 * cos(c1) / METERS_PER_MINUTE * 1e9;
+		double e0 = v0 * sin(c0) / (METERS_PER_MINUTE * scale) * 1e9;
+		double e1 = v1 * sin(c1) / (METERS_PER_MINUTE * scale) * 1e9;
+		dLat = hermite(dLat, n0, n1, h, f);
+		dLon = hermite(dLon, e0, e1, h, f);
+	}
+	else {
+		dLat *= f;
+		dLon *= f;
+	}
+
+	out.latitude = latitude[a] + llround(dLat);
+	out.longitude = normalizeLongitude(longitude[a] + llround(dLon));
+	out.altitude = lerp(altitude[a], altitude[b], f);
+	out.speed = lerp(speed[a], speed[b], f);
+	out.travelAngle = lerpAngle(travelAngle[a], travelAngle[b], f);
+	out.heading = lerpAngle(heading[a], heading[b], f);
+	out.roll = lerp(roll[a], roll[b], f);
+	out.pitch = lerp(pitch[a], pitch[b], f);
+}
+
+bool FixHistory::interpolate(int64_t t, FixRecord& out, Interpolation mode, TimeBase base) const {
+	size_t i = lowerBound(t, base);
+	if (i == count){
+		return false;
+	}
+	if (timeAt(i, base) == t){
+		out = at(i);
+		return true;
+	}
+	if (i == 0){
+		return false;
+	}
+	blend(slot(i - 1), slot(i), t, base, mode, out);
+	return true;
+}
+
+size_t FixHistory::interpolate(const int64_t* t, size_t n, FixRecord* out, bool* ok, Interpolation mode, TimeBase base) const {
+	const vector<int64_t>& ts = times(base);
+	size_t found = 0;
+	size_t i = 0;
+	for (size_t k = 0; k < n; k++){
+		// walk forward from the last position while the times are sorted, search otherwise
+		if (k == 0 || t[k] < t[k - 1]){
+			i = lowerBound(t[k], base);
+		}
+		else {
+			while (i < count && ts[slot(i)] < t[k]){
+				i++;
+			}
+		}
+
+		bool inside = false;
+		if (i < count){
+			if (ts[slot(i)] == t[k]){
+				out[k] = at(i);
+				inside = true;
+			}
+			else if (i > 0){
+				blend(slot(i - 1), slot(i), t[k], base, mode, out[k]);
+				inside = true;
+			}
+		}
+		if (ok != nullptr){
+			ok[k] = inside;
+		}
+		if (inside){
+			found++;
+		}
+	}
+	return found;
+}
+
+void FixHistory::attachToService(GPSService& gps){
+	detach();
+	service = &gps;
+	updateHandler = gps.onUpdate += [this](){
+		push(service->fix.toRecord(service->clock().now()));
+	};
+}
+
+void FixHistory::detach(){
+	if (service != nullptr){
+		service->onUpdate.removeHandler(updateHandler);
+		service = nullptr;
+	}
+}
@@ -8,6 +8,7 @@
  */
 
 #include <nmeaparse/GPSFix.h>
+#include <nmeaparse/NumberConversion.h>
 #include <cmath>
 #include <string>
 #include <sstream>
@@ -136,6 +137,9 @@ GPSTimestamp::GPSTimestamp(){
 
 	rawTime = 0;
 	rawDate = 0;
+
+	days = 0;
+	timeOfDay = 0;
 };
 
 // indexed from 1!
@@ -163,28 +167,57 @@ std::string GPSTimestamp::monthName(uint32_t index){
 	return names[index - 1];
 };
 
+namespace {
+	const int64_t NanosPerSecond = 1000000000LL;
+	const int64_t NanosPerDay = 86400LL * NanosPerSecond;
+}
+
 // Returns seconds since Jan 1, 1970. Classic Epoch time.
-time_t GPSTimestamp::getTime() {
-	struct tm t = { 0 };
-	t.tm_year = year - 1900;	// This is year-1900, so 112 = 2012
-	t.tm_mon = month - 1;		// month from 0:Jan
-	t.tm_mday = day;
-	t.tm_hour = hour;
-	t.tm_min = min;
-	t.tm_sec = (int)sec;
-	return mktime(&t)- timezone; // - timezone required as mktime assume that the tm time is local time not UTC.
+time_t GPSTimestamp::getTime() const {
+	return (time_t)(nanos() / NanosPerSecond);
+}
+
+// Returns nanoseconds since Jan 1, 1970 UTC.
+int64_t GPSTimestamp::nanos() const {
+	return days * NanosPerDay + timeOfDay;
+}
+
+void GPSTimestamp::setTimeOfDay(int64_t nanos){
+	timeOfDay = nanos;
+
+	int64_t s = nanos / NanosPerSecond;
+	hour = (int32_t)(s / 3600);
+	min = (int32_t)((s / 60) % 60);
+	sec = (double)(nanos - (s - s % 60) * NanosPerSecond) / NanosPerSecond;
+	rawTime = (hour * 10000 + min * 100) + sec;
 }
 
 void GPSTimestamp::setTime(double raw_ts){
+	int64_t whole = (int64_t)raw_ts;								// hhmmss
+	int64_t frac = llround((raw_ts - (double)whole) * NanosPerSecond);	// .sss to nanoseconds
+	int64_t hh = whole / 10000;
+	int64_t mm = (whole / 100) % 100;
+	int64_t ss = whole % 100;
+	setTimeOfDay(((hh * 60 + mm) * 60 + ss) * NanosPerSecond + frac);
+
 	rawTime = raw_ts;
+}
 
-	hour = (int32_t)trunc(raw_ts / 10000.0);
-	min = (int32_t)trunc((raw_ts - hour * 10000) / 100.0);
-	sec = raw_ts - min * 100 - hour * 10000;
+bool GPSTimestamp::setTime(std::string_view raw_ts){
+	int64_t nanos;
+	if (!parseTimeOfDay(raw_ts, nanos)){
+		return false;
+	}
+	setTimeOfDay(nanos);
+	return true;
 }
 
 //ddmmyy
 void GPSTimestamp::setDate(int32_t raw_date){
+	if (raw_date == rawDate){
+		return;		// same day, the cached day count is still good
+	}
+
 	rawDate = raw_date;
 	// If uninitialized, use posix time.
 	if(rawDate == 0) {
@@ -193,10 +226,20 @@ void GPSTimestamp::setDate(int32_t raw_date){
 		year = 1970;
 	}
 	else {
-		day = (int32_t)trunc(raw_date / 10000.0);
-		month = (int32_t)trunc((raw_date - 10000 * day) / 100.0);
-		year = raw_date - 10000 * day - 100 * month + 2000;
+		day = raw_date / 10000;
+		month = (raw_date / 100) % 100;
+		year = raw_date % 100 + 2000;
 	}
+	days = daysFromCivil(year, month, day);
+}
+
+bool GPSTimestamp::setDate(std::string_view raw_date){
+	int32_t raw;
+	if (!parseDate(raw_date, raw)){
+		return false;
+	}
+	setDate(raw);
+	return true;
 }
 
 std::string GPSTimestamp::toString(){
@@ -260,19 +303,8 @@ std::string GPSAttitude::toString() {
 
 // Returns the duration since the Host has received information
 seconds GPSFix::timeSinceLastUpdate(){
-	time_t now = time(NULL);
-	struct tm stamp = { 0 };
-
-	stamp.tm_hour = timestamp.hour;
-	stamp.tm_min = timestamp.min;
-	stamp.tm_sec = (int)timestamp.sec;
-	stamp.tm_year = timestamp.year-1900;
-	stamp.tm_mon = timestamp.month-1;
-	stamp.tm_mday = timestamp.day;
-
-	time_t then = mktime(&stamp);
-	uint64_t secs = (uint64_t)difftime(now,then);
-	return seconds((uint64_t)secs);
+	int64_t now = clock->now();
+	return duration_cast<seconds>(nanoseconds(now - timestamp.nanos()));
 }
 
 bool GPSFix::hasEstimate(){
@@ -432,5 +464,25 @@ GPSFix::operator std::string(){
 	return toString();
 }
 
+FixRecord GPSFix::toRecord(int64_t receiveTime) const {
+	FixRecord r;
+	r.time = timestamp.nanos();
+	r.receiveTime = receiveTime;
+	r.latitude = latitudeNanoMinutes;
+	r.longitude = longitudeNanoMinutes;
+	r.altitude = altitude;
+	r.speed = speed;
+	r.travelAngle = travelAngle;
+	r.heading = attitude.heading;
+	r.roll = attitude.roll;
+	r.pitch = attitude.pitch;
+	r.horizontalDilution = (float)horizontalDilution;
+	r.quality = quality;
+	r.type = type;
+	r.satellites = (uint8_t)trackingSatellites;
+	r.status = status;
+	return r;
+}
+
 
 
@@ -10,6 +10,7 @@
 
 #include <nmeaparse/GPSService.h>
 #include <nmeaparse/NumberConversion.h>
+#include <nmeaparse/StandardSentences.h>
 
 #include <iostream>
 #include <cmath>
@@ -25,29 +26,47 @@ namespace {
 }
 
 // ------ Some helpers ----------
-// Takes the NMEA lat/long format (dddmm.mmmm, [N/S,E/W]) and converts to degrees N,E only
-double convertLatLongToDeg(string llstr, string dir){
-
-	double pd = parseDouble(llstr);
-	double deg = trunc(pd / 100);				//get ddd from dddmm.mmmm
-	double mins = pd - deg * 100;
+// Stores a decoded position both as the exact fixed point value and as degrees N,E only.
+void setLatLong(double& deg, int64_t& fixed, int64_t nanominutes){
+	fixed = nanominutes;
+	deg = nanoMinutesToDegrees(nanominutes);
+}
+double convertKnotsToKilometersPerHour(double knots){
+	return knots * 1.852;
+}
 
-	deg = deg + mins / 60.0;
+// Sets the date and time of day from UTC nanoseconds since Jan 1, 1970.
+void setUTC(GPSTimestamp& timestamp, int64_t utc){
+	const int64_t day = 86400LL * 1000000000;
+	int64_t days = utc / day - (utc % day < 0);
+	int64_t y;
+	uint32_t m, d;
+	GPSTimestamp::civilFromDays(days, y, m, d);
+	timestamp.setDate((int32_t)(d * 10000 + m * 100 + (uint32_t)((y % 100 + 100) % 100)));
+	timestamp.setTimeOfDay(utc - days * day);
+}
+// 1e-7 degrees, as the binary protocols send them, to 1e-9 arc minutes
+int64_t degrees7ToNanoMinutes(int32_t value){
+	return (int64_t)value * 6000;
+}
 
-	char hdg = 'x';
-	if (!dir.empty()){
-		hdg = dir[0];
+// Status and field mask of a sentence decoded through a schema. A short sentence still
+// applies the fields it carries.
+template<class Schema>
+DecodeResult makeResult(const NMEASentence& nmea, const DecodedFields& fields){
+	DecodeResult result;
+	result.fields = fields.valid;
+	result.malformed = fields.malformed;
+	if (fields.malformed){
+		result.status = DecodeStatus::MalformedField;
 	}
-
-	//everything should be N/E, so flip S,W
-	if (hdg == 'S' || hdg == 'W'){
-		deg *= -1.0;
+	else if (nmea.parameters.size() < Schema::arity){
+		result.status = DecodeStatus::MissingParameters;
 	}
-
-	return deg;
-}
-double convertKnotsToKilometersPerHour(double knots){
-	return knots * 1.852;
+	else {
+		result.status = DecodeStatus::OK;
+	}
+	return result;
 }
 
 
@@ -57,7 +76,12 @@ double convertKnotsToKilometersPerHour(double knots){
 
 
 
-GPSService::GPSService(NMEAParser& parser) {
+GPSService::GPSService(NMEAParser& parser)
+	: onLockStateChanged(parser.memoryResource())
+	, onUpdate(parser.memoryResource())
+	, onDecodeError(parser.memoryResource())
+	, onOkToSend(parser.memoryResource())
+{
 	attachToParser(parser);		// attach to parser in the GPS object
 }
 
@@ -65,6 +89,18 @@ GPSService::~GPSService() {
 	// TODO Auto-generated destructor stub
 }
 
+void GPSService::setClock(const Clock& clock){
+	timeSource = &clock;
+	fix.clock = &clock;
+}
+
+void GPSService::report(const NMEASentence& nmea, DecodeResult result){
+	lastResult = result;
+	if (result.status != DecodeStatus::OK){
+		onDecodeError(nmea, result);
+	}
+}
+
 void GPSService::attachToParser(NMEAParser& _parser){
 
 	// http://www.gpsinformation.org/dale/nmea.htm
@@ -74,58 +110,103 @@ void GPSService::attachToParser(NMEAParser& _parser){
 	$GPGSV		- number of gps satellites in view, satellite ID, elevation,azimuth, and SNR
 	$GPRMC		- time,date, position,course, and speed data
 	$GPVTG		- course and speed information relative to the ground
+	$GPHDT		- heading, true
+	$GPHDG		- heading, magnetic
+	$GPGLL		- position and time
 	$GPZDA		- 1pps timing message
+	$GPGST		- position error statistics
+	$GPGNS		- multi constellation fix data
+	$PSSN		- Septentrio proprietary, heading roll pitch
 	$PSRF150	- gps module "ok to send"
 	*/
-	_parser.setSentenceHandler("PSRF150", [this](const NMEASentence& nmea){
-		this->read_PSRF150(nmea);
+	// passive: the service reads whatever comes, it does not ask for any of it (see OutputRatePruner)
+	_parser.setPassiveSentenceHandler("PSRF150", [this](const NMEASentence& nmea){
+		this->report(nmea, this->read_PSRF150(nmea));
 	});
 	for (const auto& talker : TalkersId){
 		std::string sentence{talker};
 		sentence.append("GGA");
-		_parser.setSentenceHandler(sentence, [this](const NMEASentence& nmea){
-			this->read_xxGGA(nmea);
+		_parser.setPassiveSentenceHandler(sentence, [this](const NMEASentence& nmea){
+			this->report(nmea, this->read_xxGGA(nmea));
 		});
 		sentence.replace(2, 3, "GSA");
-		_parser.setSentenceHandler(sentence, [this](const NMEASentence& nmea){
-			this->read_xxGSA(nmea);
+		_parser.setPassiveSentenceHandler(sentence, [this](const NMEASentence& nmea){
+			this->report(nmea, this->read_xxGSA(nmea));
 		});
 		sentence.replace(2, 3, "GSV");
-		_parser.setSentenceHandler(sentence, [this](const NMEASentence& nmea){
-			this->read_xxGSV(nmea);
+		_parser.setPassiveSentenceHandler(sentence, [this](const NMEASentence& nmea){
+			this->report(nmea, this->read_xxGSV(nmea));
 		});
 		sentence.replace(2, 3, "RMC");
-		_parser.setSentenceHandler(sentence, [this](const NMEASentence& nmea){
-			this->read_xxRMC(nmea);
+		_parser.setPassiveSentenceHandler(sentence, [this](const NMEASentence& nmea){
+			this->report(nmea, this->read_xxRMC(nmea));
 		});
 		sentence.replace(2, 3, "VTG");
-		_parser.setSentenceHandler(sentence, [this](const NMEASentence& nmea){
-			this->read_xxVTG(nmea);
+		_parser.setPassiveSentenceHandler(sentence, [this](const NMEASentence& nmea){
+			this->report(nmea, this->read_xxVTG(nmea));
 		});
 		sentence.replace(2, 3, "HDT");
-		_parser.setSentenceHandler(sentence, [this](const NMEASentence& nmea){
-			this->read_xxHDT(nmea);
+		_parser.setPassiveSentenceHandler(sentence, [this](const NMEASentence& nmea){
+			this->report(nmea, this->read_xxHDT(nmea));
 		});
 		sentence.replace(2, 3, "HDG");
-		_parser.setSentenceHandler(sentence, [this](const NMEASentence& nmea){
-			this->read_xxHDG(nmea);
+		_parser.setPassiveSentenceHandler(sentence, [this](const NMEASentence& nmea){
+			this->report(nmea, this->read_xxHDG(nmea));
+		});
+		sentence.replace(2, 3, "GLL");
+		_parser.setPassiveSentenceHandler(sentence, [this](const NMEASentence& nmea){
+			this->report(nmea, this->read_xxGLL(nmea));
+		});
+		sentence.replace(2, 3, "ZDA");
+		_parser.setPassiveSentenceHandler(sentence, [this](const NMEASentence& nmea){
+			this->report(nmea, this->read_xxZDA(nmea));
+		});
+		sentence.replace(2, 3, "GST");
+		_parser.setPassiveSentenceHandler(sentence, [this](const NMEASentence& nmea){
+			this->report(nmea, this->read_xxGST(nmea));
+		});
+		sentence.replace(2, 3, "GNS");
+		_parser.setPassiveSentenceHandler(sentence, [this](const NMEASentence& nmea){
+			this->report(nmea, this->read_xxGNS(nmea));
 		});
 	}
-	_parser.setSentenceHandler("PSSN", [this](const NMEASentence& nmea){
-		this->read_PSSN(nmea);
+	_parser.setPassiveSentenceHandler("PSSN", [this](const NMEASentence& nmea){
+		this->report(nmea, this->read_PSSN(nmea));
 	});
 }
 
 
 
 
-void GPSService::read_PSRF150(const NMEASentence& nmea){
-	// nothing right now...
-	// Called with checksum 3E (valid) for GPS turning ON
-	// Called with checksum 3F (invalid) for GPS turning OFF
+DecodeResult GPSService::read_PSRF150(const NMEASentence& nmea){
+	/*
+	$PSRF150,1*3E
+
+	where:
+	PSRF150			SiRF "OK to send"
+	[0]	1			1: the receiver takes commands, 0: it does not (e.g. turning off)
+	*/
+	DecodeResult result;
+	if (!nmea.checksumOK()){
+		result.status = DecodeStatus::BadChecksum;
+		return result;
+	}
+	if (nmea.parameters.empty()){
+		result.status = DecodeStatus::MissingParameters;
+		return result;
+	}
+	const string& ok = nmea.parameters[0];
+	if (ok != "0" && ok != "1"){
+		result.status = DecodeStatus::MalformedField;
+		result.malformed = 1;
+		return result;
+	}
+	result.fields = 1;
+	this->onOkToSend(ok == "1");
+	return result;
 }
 
-void GPSService::read_xxGGA(const NMEASentence& nmea){
+DecodeResult GPSService::read_xxGGA(const NMEASentence& nmea){
 	/* -- EXAMPLE --
 	$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47
 
@@ -155,40 +236,37 @@ void GPSService::read_xxGGA(const NMEASentence& nmea){
 	[13] (empty field) DGPS station ID number
 	[13]  *47          the checksum data, always begins with *
 	*/
-	try
-	{
-		if (!nmea.checksumOK()){
-			throw NMEAParseError("Checksum is invalid!");
-		}
+	DecodeResult result;
+	if (!nmea.checksumOK()){
+		result.status = DecodeStatus::BadChecksum;
+		return result;
+	}
 
-		if (nmea.parameters.size() < 14){
-			throw NMEAParseError("GPS data is missing parameters.");
-		}
+	GGARecord gga;
+	DecodedFields fields = GGASchema::decode(nmea, gga);
+	result = makeResult<GGASchema>(nmea, fields);
 
 
-		// TIMESTAMP
-		this->fix.timestamp.setTime(parseDouble(nmea.parameters[0]));
+	// TIMESTAMP
+	if (fields.has(GGASchema::bit<&GGARecord::time>())){
+		this->fix.timestamp.setTimeOfDay(gga.time);
+	}
 
-		string sll;
-		string dir;
-		// LAT
-		sll = nmea.parameters[1];
-		dir = nmea.parameters[2];
-		if (!sll.empty()){
-			this->fix.latitude = convertLatLongToDeg(sll, dir);
-		}
+	// LAT
+	if (fields.has(GGASchema::bit<&GGARecord::latitude>())){
+		setLatLong(this->fix.latitude, this->fix.latitudeNanoMinutes, gga.latitude);
+	}
 
-		// LONG
-		sll = nmea.parameters[3];
-		dir = nmea.parameters[4];
-		if (!sll.empty()){
-			this->fix.longitude = convertLatLongToDeg(sll, dir);
-		}
+	// LONG
+	if (fields.has(GGASchema::bit<&GGARecord::longitude>())){
+		setLatLong(this->fix.longitude, this->fix.longitudeNanoMinutes, gga.longitude);
+	}
 
 
-		// FIX QUALITY
-		bool lockupdate = false;
-		this->fix.quality = (uint8_t)parseInt(nmea.parameters[5]);
+	// FIX QUALITY
+	bool lockupdate = false;
+	if (fields.has(GGASchema::bit<&GGARecord::quality>())){
+		this->fix.quality = gga.quality;
 		if (this->fix.quality == 0){
 			lockupdate = this->fix.setlock(false);
 		}
@@ -196,38 +274,35 @@ void GPSService::read_xxGGA(const NMEASentence& nmea){
 			lockupdate = this->fix.setlock(true);
 		}
 		else {}
+	}
 
 
-		// TRACKING SATELLITES
-		this->fix.trackingSatellites = (int32_t)parseInt(nmea.parameters[6]);
+	// TRACKING SATELLITES
+	if (fields.has(GGASchema::bit<&GGARecord::satellites>())){
+		this->fix.trackingSatellites = gga.satellites;
+	}
 
-		// ALTITUDE
-		if (!nmea.parameters[8].empty()){
-			this->fix.altitude = parseDouble(nmea.parameters[8]);
-		}
-		else {
-			// leave old value
-		}
+	// HORIZONTAL DILUTION OF PRECISION -- HDOP
+	if (fields.has(GGASchema::bit<&GGARecord::hdop>())){
+		this->fix.horizontalDilution = gga.hdop;
+	}
 
-		//calling handlers
-		if (lockupdate){
-			this->onLockStateChanged(this->fix.locked());
-		}
-		this->onUpdate();
+	// ALTITUDE
+	if (fields.has(GGASchema::bit<&GGARecord::altitude>())){
+		this->fix.altitude = gga.altitude;
 	}
-	catch (NumberConversionError& ex)
-	{
-		NMEAParseError pe("GPS Number Bad Format [$GPGGA] :: " + ex.message, nmea);
-		throw pe;
+
+	//calling handlers
+	if (lockupdate){
+		this->onLockStateChanged(this->fix.locked());
 	}
-	catch (NMEAParseError& ex)
-	{
-		NMEAParseError pe("GPS Data Bad Format [$GPGGA] :: " + ex.message, nmea);
-		throw pe;
+	if (result.fields){
+		this->onUpdate();
 	}
+	return result;
 }
 
-void GPSService::read_xxGSA(const NMEASentence& nmea){
+DecodeResult GPSService::read_xxGSA(const NMEASentence& nmea){
 	/*  -- EXAMPLE --
 	$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39
 
@@ -245,63 +320,57 @@ void GPSService::read_xxGSA(const NMEASentence& nmea){
 	[16] 2.1      Vertical dilution of precision (VDOP)
 	[16] *39      the checksum data, always begins with *
 	*/
+	DecodeResult result;
+	if (!nmea.checksumOK()){
+		result.status = DecodeStatus::BadChecksum;
+		return result;
+	}
 
-
-	try
-	{
-		if (!nmea.checksumOK()){
-			throw NMEAParseError("Checksum is invalid!");
-		}
-
-		if (nmea.parameters.size() < 17){
-			throw NMEAParseError("GPS data is missing parameters.");
-		}
+	GSARecord gsa;
+	DecodedFields fields = GSASchema::decode(nmea, gsa);
+	result = makeResult<GSASchema>(nmea, fields);
 
 
-		// FIX TYPE
-		bool lockupdate = false;
-		uint64_t fixtype = parseInt(nmea.parameters[1]);
-		this->fix.type = (int8_t)fixtype;
-		if (fixtype == 1){
+	// FIX TYPE
+	bool lockupdate = false;
+	if (fields.has(GSASchema::bit<&GSARecord::fixType>())){
+		this->fix.type = gsa.fixType;
+		if (gsa.fixType == 1){
 			lockupdate = this->fix.setlock(false);
 		}
-		else if (fixtype == 3) {
+		else if (gsa.fixType == 3) {
 			lockupdate = this->fix.setlock(true);
 		}
 		else {}
+	}
 
 
-		// DILUTION OF PRECISION  -- PDOP
-		double dop = parseDouble(nmea.parameters[14]);
-		this->fix.dilution = dop;
-
-		// HORIZONTAL DILUTION OF PRECISION -- HDOP
-		double hdop = parseDouble(nmea.parameters[15]);
-		this->fix.horizontalDilution = hdop;
+	// DILUTION OF PRECISION  -- PDOP
+	if (fields.has(GSASchema::bit<&GSARecord::pdop>())){
+		this->fix.dilution = gsa.pdop;
+	}
 
-		// VERTICAL DILUTION OF PRECISION -- VDOP
-		double vdop = parseDouble(nmea.parameters[16]);
-		this->fix.verticalDilution = vdop;
+	// HORIZONTAL DILUTION OF PRECISION -- HDOP
+	if (fields.has(GSASchema::bit<&GSARecord::hdop>())){
+		this->fix.horizontalDilution = gsa.hdop;
+	}
 
-		//calling handlers
-		if (lockupdate){
-			this->onLockStateChanged(this->fix.haslock);
-		}
-		this->onUpdate();
+	// VERTICAL DILUTION OF PRECISION -- VDOP
+	if (fields.has(GSASchema::bit<&GSARecord::vdop>())){
+		this->fix.verticalDilution = gsa.vdop;
 	}
-	catch (NumberConversionError& ex)
-	{
-		NMEAParseError pe("GPS Number Bad Format [$GPGSA] :: " + ex.message, nmea);
-		throw pe;
+
+	//calling handlers
+	if (lockupdate){
+		this->onLockStateChanged(this->fix.haslock);
 	}
-	catch (NMEAParseError& ex)
-	{
-		NMEAParseError pe("GPS Data Bad Format [$GPGSA] :: " + ex.message, nmea);
-		throw pe;
+	if (result.fields){
+		this->onUpdate();
 	}
+	return result;
 }
 
-void GPSService::read_xxGSV(const NMEASentence& nmea){
+DecodeResult GPSService::read_xxGSV(const NMEASentence& nmea){
 	/*  -- EXAMPLE --
 	$GPGSV,2,1,08,01,40,083,46,02,17,308,41,12,07,344,39,14,22,228,45*75
 
@@ -323,76 +392,84 @@ void GPSService::read_xxGSV(const NMEASentence& nmea){
 	[...]   for up to 4 satellites per sentence
 	[17] *75          the checksum data, always begins with *
 	*/
+	DecodeResult result;
+	if (!nmea.checksumOK()){
+		result.status = DecodeStatus::BadChecksum;
+		return result;
+	}
 
-	try
-	{
-		if (!nmea.checksumOK()){
-			throw NMEAParseError("Checksum is invalid!");
-		}
-
-		// can't do this check because the length varies depending on satallites...
-		//if(nmea.parameters.size() < 18){
-		//	throw NMEAParseError("GPS data is missing parameters.");
-		//}
-
-		// VISIBLE SATELLITES
-		this->fix.visibleSatellites = (int32_t)parseInt(nmea.parameters[2]);
+	// can't check the length of the whole sentence because it varies depending on satallites...
+	if (nmea.parameters.size() < 3){
+		result.status = DecodeStatus::MissingParameters;
+		return result;
+	}
 
-		uint32_t totalPages = (uint32_t)parseInt(nmea.parameters[0]);
-		uint32_t currentPage = (uint32_t)parseInt(nmea.parameters[1]);
+	int64_t totalPages, currentPage, visible;
+	if (!tryParseInt(nmea.parameters[0], totalPages) || !tryParseInt(nmea.parameters[1], currentPage) || !tryParseInt(nmea.parameters[2], visible)){
+		result.status = DecodeStatus::MalformedField;
+		return result;
+	}
+	result.fields = 0x7;
 
+	// VISIBLE SATELLITES
+	this->fix.visibleSatellites = (int32_t)visible;
 
-		//if this is the first page, then reset the almanac
-		if (currentPage == 1){
-			this->fix.almanac.clear();
-			//cout << "CLEARING ALMANAC" << endl;
-		}
 
-		this->fix.almanac.lastPage = currentPage;
-		this->fix.almanac.totalPages = totalPages;
-		this->fix.almanac.visibleSize = this->fix.visibleSatellites;
+	//if this is the first page, then reset the almanac
+	if (currentPage == 1){
+		this->fix.almanac.clear();
+		//cout << "CLEARING ALMANAC" << endl;
+	}
 
-		int entriesInPage = (nmea.parameters.size() - 3) >> 2;	//first 3 are not satellite info
-		//- entries come in 4-ples, and truncate, so used shift
-		GPSSatellite sat;
-		for (int i = 0; i < entriesInPage; i++){
-			int prop = 3 + i * 4;
+	this->fix.almanac.lastPage = (uint32_t)currentPage;
+	this->fix.almanac.totalPages = (uint32_t)totalPages;
+	this->fix.almanac.visibleSize = this->fix.visibleSatellites;
 
-			// PRN, ELEVATION, AZIMUTH, SNR
-			sat.prn = (uint32_t)parseInt(nmea.parameters[prop]);
-			sat.elevation = (uint32_t)parseInt(nmea.parameters[prop + 1]);
-			sat.azimuth = (uint32_t)parseInt(nmea.parameters[prop + 2]);
-			sat.snr = (uint32_t)parseInt(nmea.parameters[prop + 3]);
+	int entriesInPage = (nmea.parameters.size() - 3) >> 2;	//first 3 are not satellite info
+	//- entries come in 4-ples, and truncate, so used shift
+	GPSSatellite sat;
+	for (int i = 0; i < entriesInPage; i++){
+		int prop = 3 + i * 4;
 
-			//cout << "ADDING SATELLITE ::" << sat.toString() << endl;
-			this->fix.almanac.updateSatellite(sat);
+		// PRN, ELEVATION, AZIMUTH, SNR -- a satellite not tracked has no SNR, and maybe no position
+		if (nmea.parameters[prop].empty()){
+			continue;		// padding
 		}
-
-		this->fix.almanac.processedPages++;
-
-		// 
-		if (this->fix.visibleSatellites == 0){
-			this->fix.almanac.clear();
+		int64_t prn = 0, elevation = 0, azimuth = 0, snr = 0;
+		bool ok = tryParseInt(nmea.parameters[prop], prn);
+		ok = ok && (nmea.parameters[prop + 1].empty() || tryParseInt(nmea.parameters[prop + 1], elevation));
+		ok = ok && (nmea.parameters[prop + 2].empty() || tryParseInt(nmea.parameters[prop + 2], azimuth));
+		ok = ok && (nmea.parameters[prop + 3].empty() || tryParseInt(nmea.parameters[prop + 3], snr));
+		if (!ok){
+			result.status = DecodeStatus::MalformedField;
+			result.malformed |= (1u << (3 + i));
+			continue;
 		}
+		result.fields |= (1u << (3 + i));		// one bit per satellite of the page
 
+		sat.prn = (uint32_t)prn;
+		sat.elevation = (uint32_t)elevation;
+		sat.azimuth = (uint32_t)azimuth;
+		sat.snr = (uint32_t)snr;
 
-		//cout << "ALMANAC FINISHED page " << this->fix.almanac.processedPages << " of " << this->fix.almanac.totalPages << endl;
-		this->onUpdate();
-
+		//cout << "ADDING SATELLITE ::" << sat.toString() << endl;
+		this->fix.almanac.updateSatellite(sat);
 	}
-	catch (NumberConversionError& ex)
-	{
-		NMEAParseError pe("GPS Number Bad Format [$GPGSV] :: " + ex.message, nmea);
-		throw pe;
-	}
-	catch (NMEAParseError& ex)
-	{
-		NMEAParseError pe("GPS Data Bad Format [$GPGSV] :: " + ex.message, nmea);
-		throw pe;
+
+	this->fix.almanac.processedPages++;
+
+	// 
+	if (this->fix.visibleSatellites == 0){
+		this->fix.almanac.clear();
 	}
+
+
+	//cout << "ALMANAC FINISHED page " << this->fix.almanac.processedPages << " of " << this->fix.almanac.totalPages << endl;
+	this->onUpdate();
+	return result;
 }
 
-void GPSService::read_xxRMC(const NMEASentence& nmea){
+DecodeResult GPSService::read_xxRMC(const NMEASentence& nmea){
 	/*  -- EXAMPLE ---
 	$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A
 	$GPRMC,235957.025,V,,,,,,,070810,,,N*4B
@@ -411,43 +488,36 @@ void GPSService::read_xxRMC(const NMEASentence& nmea){
 	[10] *6A          The checksum data, always begins with *
 	// NMEA 2.3 includes another field after
 	*/
+	DecodeResult result;
+	if (!nmea.checksumOK()){
+		result.status = DecodeStatus::BadChecksum;
+		return result;
+	}
 
-	try
-	{
-		if (!nmea.checksumOK()){
-			throw NMEAParseError("Checksum is invalid!");
-		}
-
-		if (nmea.parameters.size() < 11){
-			throw NMEAParseError("GPS data is missing parameters.");
-		}
+	RMCRecord rmc;
+	DecodedFields fields = RMCSchema::decode(nmea, rmc);
+	result = makeResult<RMCSchema>(nmea, fields);
 
-		// TIMESTAMP
-		this->fix.timestamp.setTime(parseDouble(nmea.parameters[0]));
+	// TIMESTAMP
+	if (fields.has(RMCSchema::bit<&RMCRecord::time>())){
+		this->fix.timestamp.setTimeOfDay(rmc.time);
+	}
 
-		string sll;
-		string dir;
-		// LAT
-		sll = nmea.parameters[2];
-		dir = nmea.parameters[3];
-		if (!sll.empty()){
-			this->fix.latitude = convertLatLongToDeg(sll, dir);
-		}
+	// LAT
+	if (fields.has(RMCSchema::bit<&RMCRecord::latitude>())){
+		setLatLong(this->fix.latitude, this->fix.latitudeNanoMinutes, rmc.latitude);
+	}
 
-		// LONG
-		sll = nmea.parameters[4];
-		dir = nmea.parameters[5];
-		if (!sll.empty()){
-			this->fix.longitude = convertLatLongToDeg(sll, dir);
-		}
+	// LONG
+	if (fields.has(RMCSchema::bit<&RMCRecord::longitude>())){
+		setLatLong(this->fix.longitude, this->fix.longitudeNanoMinutes, rmc.longitude);
+	}
 
 
-		// ACTIVE
-		bool lockupdate = false;
-		char status = 'V';
-		if (!nmea.parameters[1].empty()){
-			status = nmea.parameters[1][0];
-		}
+	// ACTIVE
+	bool lockupdate = false;
+	if (fields.has(RMCSchema::bit<&RMCRecord::status>())){
+		char status = rmc.status;
 		this->fix.status = status;
 		if (status == 'V'){
 			lockupdate = this->fix.setlock(false);
@@ -458,32 +528,31 @@ void GPSService::read_xxRMC(const NMEASentence& nmea){
 		else {
 			lockupdate = this->fix.setlock(false);		//not A or V, so must be wrong... no lock
 		}
+	}
 
 
-		this->fix.speed = convertKnotsToKilometersPerHour(parseDouble(nmea.parameters[6]));		// received as knots, convert to km/h
-		this->fix.travelAngle = parseDouble(nmea.parameters[7]);
-		this->fix.timestamp.setDate((int32_t)parseInt(nmea.parameters[8]));
+	if (fields.has(RMCSchema::bit<&RMCRecord::speed>())){
+		this->fix.speed = convertKnotsToKilometersPerHour(rmc.speed);		// received as knots, convert to km/h
+	}
+	if (fields.has(RMCSchema::bit<&RMCRecord::course>())){
+		this->fix.travelAngle = rmc.course;
+	}
+	if (fields.has(RMCSchema::bit<&RMCRecord::date>())){
+		this->fix.timestamp.setDate(rmc.date);
+	}
 
 
-		//calling handlers
-		if (lockupdate){
-			this->onLockStateChanged(this->fix.haslock);
-		}
-		this->onUpdate();
-	}
-	catch (NumberConversionError& ex)
-	{
-		NMEAParseError pe("GPS Number Bad Format [$GPRMC] :: " + ex.message, nmea);
-		throw pe;
+	//calling handlers
+	if (lockupdate){
+		this->onLockStateChanged(this->fix.haslock);
 	}
-	catch (NMEAParseError& ex)
-	{
-		NMEAParseError pe("GPS Data Bad Format [$GPRMC] :: " + ex.message, nmea);
-		throw pe;
+	if (result.fields){
+		this->onUpdate();
 	}
+	return result;
 }
 
-void GPSService::read_xxVTG(const NMEASentence& nmea){
+DecodeResult GPSService::read_xxVTG(const NMEASentence& nmea){
 	/*
 	$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48
 
@@ -495,37 +564,33 @@ void GPSService::read_xxVTG(const NMEASentence& nmea){
 	[6-7]	010.2,K      Ground speed, Kilometers per hour
 	[7]	*48          Checksum
 	*/
+	DecodeResult result;
+	if (!nmea.checksumOK()){
+		result.status = DecodeStatus::BadChecksum;
+		return result;
+	}
 
-	try
-	{
-		if (!nmea.checksumOK()){
-			throw NMEAParseError("Checksum is invalid!");
-		}
-
-		if (nmea.parameters.size() < 8){
-			throw NMEAParseError("GPS data is missing parameters.");
-		}
+	VTGRecord vtg;
+	DecodedFields fields = VTGSchema::decode(nmea, vtg);
+	result = makeResult<VTGSchema>(nmea, fields);
 
-		// SPEED
-		// if empty, is converted to 0
-		this->fix.speed = parseDouble(nmea.parameters[6]);		//km/h
+	// TRAVEL ANGLE
+	if (fields.has(VTGSchema::bit<&VTGRecord::trueCourse>())){
+		this->fix.travelAngle = vtg.trueCourse;
+	}
 
+	// SPEED
+	if (fields.has(VTGSchema::bit<&VTGRecord::speedKmh>())){
+		this->fix.speed = vtg.speedKmh;		//km/h
+	}
 
+	if (result.fields){
 		this->onUpdate();
 	}
-	catch (NumberConversionError& ex)
-	{
-		NMEAParseError pe("GPS Number Bad Format [$GPVTG] :: " + ex.message, nmea);
-		throw pe;
-	}
-	catch (NMEAParseError& ex)
-	{
-		NMEAParseError pe("GPS Data Bad Format [$GPVTG] :: " + ex.message, nmea);
-		throw pe;
-	}
+	return result;
 }
 
-void GPSService::read_xxHDT	(const NMEASentence& nmea){
+DecodeResult GPSService::read_xxHDT	(const NMEASentence& nmea){
 	/*
 	$GPHDT,123.456,T*00
 
@@ -535,36 +600,28 @@ void GPSService::read_xxHDT	(const NMEASentence& nmea){
 	[1]	T     		 T:indicate heading relative to True North
 	[1]	*00          Checksum
 	*/
-	try
-	{
-		if (!nmea.checksumOK()){
-			throw NMEAParseError("Checksum is invalid!");
-		}
-
-		if (nmea.parameters.size() < 2){
-			throw NMEAParseError("GPS data is missing parameters.");
-		}
+	DecodeResult result;
+	if (!nmea.checksumOK()){
+		result.status = DecodeStatus::BadChecksum;
+		return result;
+	}
 
-		// Heading
-		// if empty, is converted to 0
-		this->fix.attitude.heading = parseDouble(nmea.parameters[0]);		//degree
+	HDTRecord hdt;
+	DecodedFields fields = HDTSchema::decode(nmea, hdt);
+	result = makeResult<HDTSchema>(nmea, fields);
 
+	// Heading
+	if (fields.has(HDTSchema::bit<&HDTRecord::heading>())){
+		this->fix.attitude.heading = hdt.heading;		//degree
+	}
 
+	if (result.fields){
 		this->onUpdate();
 	}
-	catch (NumberConversionError& ex)
-	{
-		NMEAParseError pe("GPS Number Bad Format [$GPHDT] :: " + ex.message, nmea);
-		throw pe;
-	}
-	catch (NMEAParseError& ex)
-	{
-		NMEAParseError pe("GPS Data Bad Format [$GPHDT] :: " + ex.message, nmea);
-		throw pe;
-	}
+	return result;
 }
 
-void GPSService::read_xxHDG	(const NMEASentence& nmea){
+DecodeResult GPSService::read_xxHDG	(const NMEASentence& nmea){
 	/*
 	$GPHDG,123.456,123.456,E,123.456,E*00
 
@@ -577,72 +634,274 @@ void GPSService::read_xxHDG	(const NMEASentence& nmea){
 	[4]	E     		 Magnetic Variation direction, E = Easterly, W = Westerly
 	[4]	*00          Checksum
 	*/
-	try
-	{
-		if (!nmea.checksumOK()){
-			throw NMEAParseError("Checksum is invalid!");
-		}
+	DecodeResult result;
+	if (!nmea.checksumOK()){
+		result.status = DecodeStatus::BadChecksum;
+		return result;
+	}
 
-		if (nmea.parameters.size() < 5){
-			throw NMEAParseError("GPS data is missing parameters.");
-		}
+	HDGRecord hdg;
+	DecodedFields fields = HDGSchema::decode(nmea, hdg);
+	result = makeResult<HDGSchema>(nmea, fields);
+
+	// Heading
+	if (fields.has(HDGSchema::bit<&HDGRecord::heading>())){
+		this->fix.attitude.heading = hdg.heading;		// degree
+	}
+
+	if (result.fields){
+		this->onUpdate();
+	}
+	return result;
+}
+
+DecodeResult GPSService::read_xxGLL	(const NMEASentence& nmea){
+	/*
+	$GPGLL,4916.45,N,12311.12,W,225444,A*31
+
+	where:
+	GLL      		 Geographic position, latitude and longitude
+	[0-1]	4916.46,N    Latitude 49 deg. 16.45 min. North
+	[2-3]	12311.12,W   Longitude 123 deg. 11.12 min. West
+	[4]	225444       Fix taken at 22:54:44 UTC
+	[5]	A            Data Active or V (void)
+	[5]	*31          Checksum
+	// NMEA 2.3 includes a mode indicator field after
+	*/
+	DecodeResult result;
+	if (!nmea.checksumOK()){
+		result.status = DecodeStatus::BadChecksum;
+		return result;
+	}
+
+	GLLRecord gll;
+	DecodedFields fields = GLLSchema::decode(nmea, gll);
+	result = makeResult<GLLSchema>(nmea, fields);
+
+	// LAT
+	if (fields.has(GLLSchema::bit<&GLLRecord::latitude>())){
+		setLatLong(this->fix.latitude, this->fix.latitudeNanoMinutes, gll.latitude);
+	}
+
+	// LONG
+	if (fields.has(GLLSchema::bit<&GLLRecord::longitude>())){
+		setLatLong(this->fix.longitude, this->fix.longitudeNanoMinutes, gll.longitude);
+	}
 
-		// Heading
-		// if empty, is converted to 0
-		this->fix.attitude.heading = parseDouble(nmea.parameters[0]);		// degree
+	// TIMESTAMP
+	if (fields.has(GLLSchema::bit<&GLLRecord::time>())){
+		this->fix.timestamp.setTimeOfDay(gll.time);
+	}
 
+	// ACTIVE
+	bool lockupdate = false;
+	if (fields.has(GLLSchema::bit<&GLLRecord::status>())){
+		lockupdate = this->fix.setlock(gll.status == 'A');
+		this->fix.status = gll.status;
+	}
 
+	//calling handlers
+	if (lockupdate){
+		this->onLockStateChanged(this->fix.haslock);
+	}
+	if (result.fields){
 		this->onUpdate();
 	}
-	catch (NumberConversionError& ex)
-	{
-		NMEAParseError pe("GPS Number Bad Format [$GPHDG] :: " + ex.message, nmea);
-		throw pe;
+	return result;
+}
+
+DecodeResult GPSService::read_xxZDA	(const NMEASentence& nmea){
+	/*
+	$GPZDA,201530.00,04,07,2002,00,00*60
+
+	where:
+	ZDA      		 Time and date
+	[0]	201530.00    UTC time 20:15:30.00
+	[1]	04           Day
+	[2]	07           Month
+	[3]	2002         Year
+	[4]	00           Local zone hours (-13 to 13)
+	[5]	00           Local zone minutes
+	[5]	*60          Checksum
+	*/
+	DecodeResult result;
+	if (!nmea.checksumOK()){
+		result.status = DecodeStatus::BadChecksum;
+		return result;
+	}
+
+	ZDARecord zda;
+	DecodedFields fields = ZDASchema::decode(nmea, zda);
+	result = makeResult<ZDASchema>(nmea, fields);
+
+	// TIMESTAMP
+	if (fields.has(ZDASchema::bit<&ZDARecord::time>())){
+		this->fix.timestamp.setTimeOfDay(zda.time);
+	}
+
+	// DATE
+	const uint32_t date = ZDASchema::bit<&ZDARecord::day>() | ZDASchema::bit<&ZDARecord::month>() | ZDASchema::bit<&ZDARecord::year>();
+	if (fields.has(date) && zda.day >= 1 && zda.day <= 31 && zda.month >= 1 && zda.month <= 12){
+		this->fix.timestamp.setDate(zda.day * 10000 + zda.month * 100 + zda.year % 100);
 	}
-	catch (NMEAParseError& ex)
-	{
-		NMEAParseError pe("GPS Data Bad Format [$GPHDG] :: " + ex.message, nmea);
-		throw pe;
+
+	if (result.fields){
+		this->onUpdate();
 	}
+	return result;
 }
 
-void GPSService::read_PSSN (const NMEASentence& nmea){
+DecodeResult GPSService::read_xxGST	(const NMEASentence& nmea){
 	/*
-	$PSSN,*
+	$GPGST,172814.0,0.006,0.023,0.020,273.6,0.023,0.020,0.031*6A
 
 	where:
-	PSSN      		Proprietary Septentrio NMEA Sentences
+	GST      		 Position error statistics
+	[0]	172814.0     UTC time of the associated fix
+	[1]	0.006        RMS of the pseudorange residuals (meters)
+	[2]	0.023        Error ellipse semi-major axis 1 sigma (meters)
+	[3]	0.020        Error ellipse semi-minor axis 1 sigma (meters)
+	[4]	273.6        Error ellipse orientation (degrees true)
+	[5]	0.023        Latitude error 1 sigma (meters)
+	[6]	0.020        Longitude error 1 sigma (meters)
+	[7]	0.031        Altitude error 1 sigma (meters)
+	[7]	*6A          Checksum
 	*/
-	try
-	{
-		if (!nmea.checksumOK()){
-			throw NMEAParseError("Checksum is invalid!");
-		}
+	DecodeResult result;
+	if (!nmea.checksumOK()){
+		result.status = DecodeStatus::BadChecksum;
+		return result;
+	}
 
-		if (nmea.parameters.size() < 2){
-			throw NMEAParseError("GPS data is missing parameters.");
-		}
+	GSTRecord gst;
+	DecodedFields fields = GSTSchema::decode(nmea, gst);
+	result = makeResult<GSTSchema>(nmea, fields);
+
+	if (fields.has(GSTSchema::bit<&GSTRecord::latitudeDeviation>())){
+		this->fix.latitudeError = gst.latitudeDeviation;
+	}
+	if (fields.has(GSTSchema::bit<&GSTRecord::longitudeDeviation>())){
+		this->fix.longitudeError = gst.longitudeDeviation;
+	}
+	if (fields.has(GSTSchema::bit<&GSTRecord::altitudeDeviation>())){
+		this->fix.altitudeError = gst.altitudeDeviation;
+	}
+
+	if (result.fields){
+		this->onUpdate();
+	}
+	return result;
+}
 
-		if (nmea.parameters[0] == "HRP") {
-			const_cast<NMEASentence&>(nmea).name.append("," + nmea.parameters[0]);
-			this->read_PSSN_HRP(nmea);
-		} else {
-			throw NMEAParseError("Invalid custom sentence: " + nmea.parameters[0]);
+DecodeResult GPSService::read_xxGNS	(const NMEASentence& nmea){
+	/*
+	$GNGNS,014035.00,4332.69262,S,17235.48549,E,RR,13,0.9,25.63,11.24,,*70
+
+	where:
+	GNS      		 GNSS fix data
+	[0]	014035.00    UTC time 01:40:35.00
+	[1-2]	4332.69262,S Latitude
+	[3-4]	17235.48549,E Longitude
+	[5]	RR           Mode per constellation (GPS, GLONASS, ...): N = no fix, A = autonomous,
+	                 D = differential, P = precise, R = RTK, F = float RTK, E = estimated
+	[6]	13           Number of satellites used
+	[7]	0.9          Horizontal dilution of precision
+	[8]	25.63        Altitude, meters above mean sea level
+	[9]	11.24        Geoidal separation, meters
+	[10]	(empty)     Age of differential data
+	[11]	(empty)     Differential reference station ID
+	[11]	*70         Checksum
+	*/
+	DecodeResult result;
+	if (!nmea.checksumOK()){
+		result.status = DecodeStatus::BadChecksum;
+		return result;
+	}
+
+	GNSRecord gns;
+	DecodedFields fields = GNSSchema::decode(nmea, gns);
+	result = makeResult<GNSSchema>(nmea, fields);
+
+	// TIMESTAMP
+	if (fields.has(GNSSchema::bit<&GNSRecord::time>())){
+		this->fix.timestamp.setTimeOfDay(gns.time);
+	}
+
+	// LAT
+	if (fields.has(GNSSchema::bit<&GNSRecord::latitude>())){
+		setLatLong(this->fix.latitude, this->fix.latitudeNanoMinutes, gns.latitude);
+	}
+
+	// LONG
+	if (fields.has(GNSSchema::bit<&GNSRecord::longitude>())){
+		setLatLong(this->fix.longitude, this->fix.longitudeNanoMinutes, gns.longitude);
+	}
+
+	// MODE
+	bool lockupdate = false;
+	if (fields.has(GNSSchema::bit<&GNSRecord::mode>())){
+		if (gns.mode == 'N'){
+			lockupdate = this->fix.setlock(false);
+		}
+		else if (gns.mode == 'A'){
+			lockupdate = this->fix.setlock(true);
 		}
+		else {}
+	}
+
+	// TRACKING SATELLITES
+	if (fields.has(GNSSchema::bit<&GNSRecord::satellites>())){
+		this->fix.trackingSatellites = gns.satellites;
+	}
+
+	// HORIZONTAL DILUTION OF PRECISION -- HDOP
+	if (fields.has(GNSSchema::bit<&GNSRecord::hdop>())){
+		this->fix.horizontalDilution = gns.hdop;
+	}
+
+	// ALTITUDE
+	if (fields.has(GNSSchema::bit<&GNSRecord::altitude>())){
+		this->fix.altitude = gns.altitude;
 	}
-	catch (NumberConversionError& ex)
-	{
-		NMEAParseError pe("GPS Number Bad Format [$PSSN] : " + ex.message, nmea);
-		throw pe;
+
+	//calling handlers
+	if (lockupdate){
+		this->onLockStateChanged(this->fix.haslock);
 	}
-	catch (NMEAParseError& ex)
-	{
-		NMEAParseError pe("GPS Data Bad Format [$PSSN] : " + ex.message, nmea);
-		throw pe;
+	if (result.fields){
+		this->onUpdate();
 	}
+	return result;
 }
 
-void GPSService::read_PSSN_HRP	(const NMEASentence& nmea){
+DecodeResult GPSService::read_PSSN (const NMEASentence& nmea){
+	/*
+	$PSSN,*
+
+	where:
+	PSSN      		Proprietary Septentrio NMEA Sentences
+	*/
+	DecodeResult result;
+	if (!nmea.checksumOK()){
+		result.status = DecodeStatus::BadChecksum;
+		return result;
+	}
+
+	if (nmea.parameters.size() < 2){
+		result.status = DecodeStatus::MissingParameters;
+		return result;
+	}
+
+	// dispatch on the sub-ID, the first parameter
+	if (nmea.parameters[0] == "HRP") {
+		return this->read_PSSN_HRP(nmea);
+	}
+
+	result.status = DecodeStatus::UnknownSentence;
+	return result;
+}
+
+DecodeResult GPSService::read_PSSN_HRP	(const NMEASentence& nmea){
 	/*
 	$PSSN,HRP,120010.10,080822,12.3,45.6,78.9,12.3,45.6,78.9,10,0,12.3,E*42
 
@@ -671,44 +930,224 @@ void GPSService::read_PSSN_HRP	(const NMEASentence& nmea){
 	[11-12] 12.3,E	Magnetic variation, degrees (E=East, W=West)
 	[12]	*00     Checksum
 	*/
-	try
-	{
-		if (!nmea.checksumOK()){
-			throw NMEAParseError("Checksum is invalid!");
-		}
+	DecodeResult result;
+	if (!nmea.checksumOK()){
+		result.status = DecodeStatus::BadChecksum;
+		return result;
+	}
+
+	PSSNHRPRecord hrp;
+	DecodedFields fields = PSSNHRPSchema::decode(nmea, hrp);
+	result = makeResult<PSSNHRPSchema>(nmea, fields);
+
+	GPSAttitude& attitude = this->fix.attitude;
+	if (fields.has(PSSNHRPSchema::bit<&PSSNHRPRecord::time>())){
+		attitude.timestamp.setTimeOfDay(hrp.time);
+	}
+	if (fields.has(PSSNHRPSchema::bit<&PSSNHRPRecord::date>())){
+		attitude.timestamp.setDate(hrp.date);
+	}
+	if (fields.has(PSSNHRPSchema::bit<&PSSNHRPRecord::heading>())){
+		attitude.heading = hrp.heading;
+	}
+	if (fields.has(PSSNHRPSchema::bit<&PSSNHRPRecord::roll>())){
+		attitude.roll = hrp.roll;
+	}
+	if (fields.has(PSSNHRPSchema::bit<&PSSNHRPRecord::pitch>())){
+		attitude.pitch = hrp.pitch;
+	}
+	if (fields.has(PSSNHRPSchema::bit<&PSSNHRPRecord::headingDeviation>())){
+		attitude.headingDeviation = hrp.headingDeviation;
+	}
+	if (fields.has(PSSNHRPSchema::bit<&PSSNHRPRecord::rollDeviation>())){
+		attitude.rollDeviation = hrp.rollDeviation;
+	}
+	if (fields.has(PSSNHRPSchema::bit<&PSSNHRPRecord::pitchDeviation>())){
+		attitude.pitchDeviation = hrp.pitchDeviation;
+	}
+	if (fields.has(PSSNHRPSchema::bit<&PSSNHRPRecord::satellites>())){
+		attitude.sattelitesCount = hrp.satellites;
+	}
+	if (fields.has(PSSNHRPSchema::bit<&PSSNHRPRecord::mode>())){
+		attitude.modeIndicator = hrp.mode;
+	}
+	if (fields.has(PSSNHRPSchema::bit<&PSSNHRPRecord::magneticVariation>())){
+		attitude.magneticVariation = hrp.magneticVariation;
+	}
+	if (fields.has(PSSNHRPSchema::bit<&PSSNHRPRecord::magneticDirection>())){
+		attitude.magnetVarDirection = (hrp.magneticDirection == 'W') ? 'W' : 'E';
+	}
+
+	if (result.fields){
+		this->onUpdate();
+	}
+	return result;
+}
+
 
-		if (nmea.parameters.size() < 13){
-			throw NMEAParseError("GPS data is missing parameters.");
+
+
+// ------------- BINARY PROTOCOLS -------------
+
+void GPSService::attachToDecoder(UBXDecoder& decoder){
+	decoder.onNavPVT += [this](const UBXNavPVT& pvt){
+		this->read_UBX_NAV_PVT(pvt);
+	};
+	decoder.onNavSat += [this](const UBXNavSat& sat){
+		this->read_UBX_NAV_SAT(sat);
+	};
+}
+
+void GPSService::attachToDecoder(SiRFDecoder& decoder){
+	decoder.onGeodeticNav += [this](const SiRFGeodeticNav& nav){
+		this->read_SiRF_41(nav);
+	};
+	decoder.onTrackerData += [this](const SiRFTrackerData& tracker){
+		this->read_SiRF_4(tracker);
+	};
+}
+
+void GPSService::read_UBX_NAV_PVT(const UBXNavPVT& pvt){
+	// TIMESTAMP, when both the date and the time are valid
+	if ((pvt.valid & 0x3) == 0x3){
+		int64_t seconds = GPSTimestamp::daysFromCivil(pvt.year, pvt.month, pvt.day) * 86400 + (pvt.hour * 60 + pvt.min) * 60 + pvt.sec;
+		setUTC(this->fix.timestamp, seconds * 1000000000 + pvt.nano);
+	}
+
+	bool fixOK = (pvt.flags & 0x1) != 0 && pvt.fixType >= 1 && pvt.fixType <= 4;
+	if (fixOK){
+		setLatLong(this->fix.latitude, this->fix.latitudeNanoMinutes, degrees7ToNanoMinutes(pvt.lat));
+		setLatLong(this->fix.longitude, this->fix.longitudeNanoMinutes, degrees7ToNanoMinutes(pvt.lon));
+		this->fix.altitude = pvt.hMSL / 1000.;
+		this->fix.speed = pvt.gSpeed * 0.0036;			// mm/s to km/h
+		this->fix.travelAngle = pvt.headMot * 1e-5;
+		this->fix.latitudeError = pvt.hAcc / 1000.;		// the horizontal estimate, for both axes
+		this->fix.longitudeError = pvt.hAcc / 1000.;
+		this->fix.altitudeError = pvt.vAcc / 1000.;
+		if (pvt.flags & 0x20){
+			this->fix.attitude.heading = pvt.headVeh * 1e-5;
+			this->fix.attitude.timestamp = this->fix.timestamp;
 		}
+	}
+
+	// FIX TYPE AND QUALITY
+	uint8_t carrier = pvt.flags >> 6;
+	this->fix.type = pvt.fixType == 3 || pvt.fixType == 4 ? 3 : (pvt.fixType == 2 ? 2 : 1);
+	if (!fixOK){
+		this->fix.quality = 0;
+	}
+	else if (pvt.fixType == 1){
+		this->fix.quality = 6;
+	}
+	else if (carrier == 2){
+		this->fix.quality = 4;
+	}
+	else if (carrier == 1){
+		this->fix.quality = 5;
+	}
+	else {
+		this->fix.quality = (pvt.flags & 0x2) ? 2 : 1;
+	}
+	bool locked = fixOK && pvt.fixType != 1;
+	this->fix.status = locked ? 'A' : 'V';
+	bool lockupdate = this->fix.setlock(locked);
+
+	this->fix.trackingSatellites = pvt.numSV;
+	this->fix.dilution = pvt.pDOP / 100.;
+
+	if (lockupdate){
+		this->onLockStateChanged(this->fix.haslock);
+	}
+	this->onUpdate();
+}
 
-		this->fix.attitude.timestamp.setTime(parseDouble(nmea.parameters[1]));
-		this->fix.attitude.timestamp.setDate((int32_t)parseInt(nmea.parameters[2]));
-		this->fix.attitude.heading = parseDouble(nmea.parameters[3]);
-		this->fix.attitude.roll = parseDouble(nmea.parameters[4]);
-		this->fix.attitude.pitch = parseDouble(nmea.parameters[5]);
-		this->fix.attitude.headingDeviation = parseDouble(nmea.parameters[6]);
-		this->fix.attitude.rollDeviation = parseDouble(nmea.parameters[7]);
-		this->fix.attitude.pitchDeviation = parseDouble(nmea.parameters[8]);
-		this->fix.attitude.sattelitesCount = (int32_t)parseInt(nmea.parameters[9]);
-		this->fix.attitude.modeIndicator = (int8_t)parseInt(nmea.parameters[10]);
-		this->fix.attitude.magneticVariation = parseDouble(nmea.parameters[11]);
-		char direction = 'E';
-		if (!nmea.parameters[12].empty() && nmea.parameters[12][0] == 'W'){
-			direction = 'W';
+void GPSService::read_UBX_NAV_SAT(const UBXNavSat& sat){
+	this->fix.almanac.clear();
+	uint32_t visible = 0;
+	for (const UBXSatellite& s : sat.satellites){
+		if (s.nmeaId() != 0){
+			visible++;
 		}
-		this->fix.attitude.magnetVarDirection = direction;
+	}
+	this->fix.almanac.visibleSize = visible;
+	for (const UBXSatellite& s : sat.satellites){
+		uint32_t prn = s.nmeaId();
+		if (prn == 0){
+			continue;		// no NMEA number
+		}
+		GPSSatellite satellite;
+		satellite.prn = prn;
+		satellite.snr = s.cno;
+		satellite.elevation = s.elev < 0 ? 0 : s.elev;
+		satellite.azimuth = s.azim < 0 ? 0 : s.azim;
+		this->fix.almanac.updateSatellite(satellite);
+	}
+	this->fix.almanac.lastPage = 1;
+	this->fix.almanac.totalPages = 1;
+	this->fix.almanac.processedPages = 1;
+	this->fix.visibleSatellites = (int32_t)visible;
+	this->onUpdate();
+}
 
-		this->onUpdate();
+void GPSService::read_SiRF_41(const SiRFGeodeticNav& nav){
+	uint8_t mode = nav.navType & 0x7;
+	bool valid = nav.navValid == 0 && mode != 0;
+
+	// TIMESTAMP
+	if (nav.year != 0){
+		int64_t seconds = GPSTimestamp::daysFromCivil(nav.year, nav.month, nav.day) * 86400 + (nav.hour * 60 + nav.minute) * 60;
+		setUTC(this->fix.timestamp, seconds * 1000000000 + (int64_t)nav.second * 1000000);
 	}
-	catch (NumberConversionError& ex)
-	{
-		NMEAParseError pe("GPS Number Bad Format [$GPHDG] :: " + ex.message, nmea);
-		throw pe;
+
+	if (valid || mode == 7){
+		setLatLong(this->fix.latitude, this->fix.latitudeNanoMinutes, degrees7ToNanoMinutes(nav.latitude));
+		setLatLong(this->fix.longitude, this->fix.longitudeNanoMinutes, degrees7ToNanoMinutes(nav.longitude));
+		this->fix.altitude = nav.altitudeMSL / 100.;
+		this->fix.speed = nav.speed * 0.036;			// cm/s to km/h
+		this->fix.travelAngle = nav.course / 100.;
+		this->fix.latitudeError = nav.ehpe / 100.;		// the horizontal estimate, for both axes
+		this->fix.longitudeError = nav.ehpe / 100.;
+		this->fix.altitudeError = nav.evpe / 100.;
 	}
-	catch (NMEAParseError& ex)
-	{
-		NMEAParseError pe("GPS Data Bad Format [$GPHDG] :: " + ex.message, nmea);
-		throw pe;
+
+	// FIX TYPE AND QUALITY
+	this->fix.type = mode == 4 || mode == 6 ? 3 : (mode == 0 || mode == 7 ? 1 : 2);
+	if (mode == 7){
+		this->fix.quality = 6;
 	}
+	else if (!valid){
+		this->fix.quality = 0;
+	}
+	else {
+		this->fix.quality = (nav.navType & 0x80) ? 2 : 1;
+	}
+	bool locked = valid && mode != 7;
+	this->fix.status = locked ? 'A' : 'V';
+	bool lockupdate = this->fix.setlock(locked);
+
+	this->fix.trackingSatellites = nav.svCount;
+	this->fix.horizontalDilution = nav.hdop * 0.2;
+
+	if (lockupdate){
+		this->onLockStateChanged(this->fix.haslock);
+	}
+	this->onUpdate();
 }
 
+void GPSService::read_SiRF_4(const SiRFTrackerData& tracker){
+	this->fix.almanac.clear();
+	this->fix.almanac.visibleSize = (uint32_t)tracker.channels.size();
+	for (const SiRFChannel& c : tracker.channels){
+		GPSSatellite satellite;
+		satellite.prn = c.svId >= 120 ? c.svId - 87 : c.svId;		// SBAS as 33-64, like NMEA
+		satellite.snr = round(c.averageCN0());
+		satellite.elevation = c.elevation;
+		satellite.azimuth = c.azimuth;
+		this->fix.almanac.updateSatellite(satellite);
+	}
+	this->fix.almanac.lastPage = 1;
+	this->fix.almanac.totalPages = 1;
+	this->fix.almanac.processedPages = 1;
+	this->fix.visibleSatellites = (int32_t)tracker.channels.size();
+	this->onUpdate();
+}
@@ -0,0 +1,330 @@
+/*
+ * Generator.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/Generator.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	const double PI = 3.14159265358979323846;
+	const double EARTH_RADIUS = 6371000.;		// meters
+	const int64_t DAY = 86400LL * 1000000000;
+	const char HEX[] = "0123456789ABCDEF";
+
+	uint64_t rotl(uint64_t x, int k){
+		return (x << k) | (x >> (64 - k));
+	}
+
+	uint64_t splitMix(uint64_t& x){
+		uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+}
+
+
+
+// ------------- GENERATOR ----------------
+
+NMEAGenerator::NMEAGenerator(uint64_t seed){
+	writer.geoidSeparation = 55.2;
+	int64_t noon = GPSTimestamp::daysFromCivil(2021, 5, 10) * DAY + DAY / 2;
+	start(53.361337, -6.505620, 61.7, noon, seed);
+}
+
+void NMEAGenerator::start(double lat, double lon, double altitude, int64_t utc, uint64_t seed){
+	for (auto& r : rng){
+		r = splitMix(seed);
+	}
+	latitude = lat;
+	longitude = lon;
+	baseAltitude = altitude;
+	startTime = utc;
+	heading = 0.;
+	epochs = 0;
+	sentences = 0;
+	errors = 0;
+	drawSky();
+
+	state = FixRecord();
+	state.time = utc;
+	state.status = 'A';
+	state.quality = 1;
+	state.type = 3;
+	move(0);
+}
+
+uint64_t NMEAGenerator::next(){
+	uint64_t result = rotl(rng[1] * 5, 7) * 9;
+	uint64_t t = rng[1] << 17;
+	rng[2] ^= rng[0];
+	rng[3] ^= rng[1];
+	rng[1] ^= rng[2];
+	rng[0] ^= rng[3];
+	rng[2] ^= t;
+	rng[3] = rotl(rng[3], 45);
+	return result;
+}
+
+double NMEAGenerator::uniform(){
+	return (double)(next() >> 11) * (1. / 9007199254740992.);
+}
+
+double NMEAGenerator::uniform(double low, double high){
+	return low + (high - low) * uniform();
+}
+
+void NMEAGenerator::drawSky(){
+	unsigned count = min(satelliteCount, 32u);
+	uint32_t prns[32];
+	for (uint32_t i = 0; i < 32; i++){
+		prns[i] = i + 1;
+	}
+	satellites.clear();
+	drifts.clear();
+	for (unsigned i = 0; i < count; i++){
+		swap(prns[i], prns[i + next() % (32 - i)]);
+		GPSSatellite s;
+		s.prn = prns[i];
+		s.azimuth = floor(uniform(0., 360.));
+		s.elevation = uniform(5., 85.);
+		satellites.push_back(s);
+		drifts.push_back(uniform(-0.01, 0.01));
+	}
+}
+
+void NMEAGenerator::move(int64_t nanos){
+	double seconds = (double)nanos / 1e9;
+	double distance = speed * seconds;
+	double course = heading * PI / 180.;
+	latitude += distance * cos(course) / EARTH_RADIUS * 180. / PI;
+	longitude += distance * sin(course) / (EARTH_RADIUS * cos(latitude * PI / 180.)) * 180. / PI;
+	if (longitude >= 180.){
+		longitude -= 360.;
+	}
+	else if (longitude < -180.){
+		longitude += 360.;
+	}
+	heading = fmod(heading + turnRate * seconds + 360., 360.);
+	state.time += nanos;
+
+	double t = (double)(state.time - startTime) / 1e9;
+	state.latitude = llround(latitude * 60e9);
+	state.longitude = llround(longitude * 60e9);
+	state.altitude = baseAltitude + 2. * sin(t / 60.) + uniform(-0.1, 0.1);
+	state.speed = speed * 3.6;
+	state.travelAngle = heading;
+	state.heading = fmod(heading + 2. * sin(t / 20.) + 360., 360.);
+	state.roll = 1.5 * sin(t / 7.);
+	state.pitch = 0.8 * cos(t / 11.);
+	state.horizontalDilution = (float)uniform(0.8, 1.3);
+
+	unsigned used = 0;
+	for (size_t i = 0; i < satellites.size(); i++){
+		GPSSatellite& s = satellites[i];
+		s.elevation += drifts[i] * seconds;
+		if (s.elevation < 5. || s.elevation > 88.){
+			drifts[i] = -drifts[i];
+			s.elevation = min(88., max(5., s.elevation));
+		}
+		bool tracked = uniform() >= 0.1;
+		s.snr = tracked ? floor(25. + s.elevation / 4. + uniform(0., 6.)) : 0.;
+		if (tracked && s.elevation > 10. && used < 12){
+			used++;
+		}
+	}
+	state.satellites = (uint8_t)used;
+}
+
+void NMEAGenerator::useTalker(){
+	if (talkers.empty()){
+		return;
+	}
+	double total = 0.;
+	for (auto& t : talkers){
+		total += t.second;
+	}
+	double pick = uniform() * total;
+	const string* chosen = &talkers.back().first;
+	for (auto& t : talkers){
+		if (pick < t.second){
+			chosen = &t.first;
+			break;
+		}
+		pick -= t.second;
+	}
+	writer.talker[0] = (*chosen)[0];
+	writer.talker[1] = (*chosen)[1];
+}
+
+void NMEAGenerator::emit(string& out, const char* text, size_t length){
+	const char* end = text + length;
+	while (text < end){
+		const char* nl = (const char*)memchr(text, '\n', end - text);
+		size_t line = (nl ? nl : end) - text;
+		size_t sentence = line > 0 && text[line - 1] == '\r' ? line - 1 : line;		// "$...*hh"
+
+		// the draws are the same whatever the rates, so the rest of the stream is too
+		bool bad = uniform() < badChecksums;
+		bool truncated = uniform() < truncations;
+		bool noisy = uniform() < noise;
+		uint64_t r = next();
+
+		size_t start = out.size();
+		out.append(text, sentence);
+		if (bad && sentence >= 3){
+			uint8_t checksum = (uint8_t)strtoul(out.c_str() + out.size() - 2, nullptr, 16) ^ (uint8_t)(1 + r % 255);
+			out[out.size() - 2] = HEX[checksum >> 4];
+			out[out.size() - 1] = HEX[checksum & 0xF];
+		}
+		if (truncated && sentence > 1){
+			out.resize(start + 1 + (r >> 8) % (sentence - 1));
+		}
+		out += crlf ? "\r\n" : "\n";
+		if (noisy){
+			size_t n = 1 + (r >> 40) % 32;
+			for (size_t i = 0; i < n; i++){
+				out.push_back((char)next());
+			}
+		}
+		sentences++;
+		if (bad || truncated || noisy){
+			errors++;
+		}
+		text += nl ? line + 1 : line;
+	}
+}
+
+void NMEAGenerator::epoch(string& out){
+	if (satellites.size() != min(satelliteCount, 32u)){
+		drawSky();
+	}
+	writer.crlf = crlf;
+
+	double hdop = state.horizontalDilution;
+	double vdop = hdop * 1.4;
+	double pdop = sqrt(hdop * hdop + vdop * vdop);
+
+	char buffer[40 * SentenceWriter::MAX_LENGTH];
+	for (auto& type : sentenceTypes){
+		size_t length = 0;
+		useTalker();
+		if (type == "GGA"){
+			length = writer.writeGGA(state, buffer, sizeof(buffer));
+		}
+		else if (type == "GSA"){
+			uint32_t used[12];
+			size_t count = 0;
+			for (auto& s : satellites){
+				if (s.snr > 0 && s.elevation > 10. && count < 12){
+					used[count++] = s.prn;
+				}
+			}
+			length = writer.writeGSA(used, count, state.type, pdop, hdop, vdop, buffer, sizeof(buffer));
+		}
+		else if (type == "GSV"){
+			length = writer.writeGSV(satellites.data(), satellites.size(), buffer, sizeof(buffer));
+		}
+		else if (type == "RMC"){
+			length = writer.writeRMC(state, buffer, sizeof(buffer));
+		}
+		else if (type == "VTG"){
+			length = writer.writeVTG(state, buffer, sizeof(buffer));
+		}
+		else if (type == "HDT"){
+			length = writer.writeHDT(state, buffer, sizeof(buffer));
+		}
+		else if (type == "PSSN"){
+			// proprietary, so not one of the writer's
+			int64_t day = (state.time % DAY + DAY) % DAY;
+			int64_t y;
+			uint32_t m, d;
+			GPSTimestamp::civilFromDays((state.time - day) / DAY, y, m, d);
+			int64_t ms = day / 1000000;
+			int body = snprintf(buffer + 1, sizeof(buffer) - 8, "PSSN,HRP,%02d%02d%02d.%03d,%02u%02u%02d,%.1f,%.1f,%.1f,0.1,0.2,0.2,%u,4,0.0,E",
+				(int)(ms / 3600000), (int)(ms / 60000 % 60), (int)(ms / 1000 % 60), (int)(ms % 1000), d, m, (int)((y % 100 + 100) % 100),
+				state.heading, state.roll, state.pitch, state.satellites);
+			uint8_t checksum = 0;
+			for (int i = 1; i <= body; i++){
+				checksum ^= (uint8_t)buffer[i];
+			}
+			buffer[0] = '$';
+			length = 1 + body;
+			buffer[length++] = '*';
+			buffer[length++] = HEX[checksum >> 4];
+			buffer[length++] = HEX[checksum & 0xF];
+			buffer[length++] = '\n';
+		}
+		emit(out, buffer, length);
+	}
+
+	epochs++;
+	move(rate > 0. ? llround(1e9 / rate) : 0);
+}
+
+bool NMEAGenerator::parseSentenceTypes(const string& text, vector<string>& types){
+	static const char* const known[] = { "GGA", "GSA", "GSV", "RMC", "VTG", "HDT", "PSSN" };
+	vector<string> parsed;
+	size_t pos = 0;
+	while (pos <= text.size()){
+		size_t comma = text.find(',', pos);
+		if (comma == string::npos){
+			comma = text.size();
+		}
+		string item = text.substr(pos, comma - pos);
+		bool found = false;
+		for (const char* k : known){
+			found = found || item == k;
+		}
+		if (!found){
+			return false;
+		}
+		parsed.push_back(item);
+		pos = comma + 1;
+	}
+	types = parsed;
+	return true;
+}
+
+bool NMEAGenerator::parseTalkers(const string& text, vector<pair<string, double>>& list){
+	vector<pair<string, double>> parsed;
+	size_t pos = 0;
+	while (pos <= text.size()){
+		size_t comma = text.find(',', pos);
+		if (comma == string::npos){
+			comma = text.size();
+		}
+		string item = text.substr(pos, comma - pos);
+		double weight = 1.;
+		size_t colon = item.find(':');
+		if (colon != string::npos){
+			char* end = nullptr;
+			weight = strtod(item.c_str() + colon + 1, &end);
+			if (*end != '\0' || !(weight > 0.)){
+				return false;
+			}
+			item.resize(colon);
+		}
+		if (item.size() != 2 || !isupper((unsigned char)item[0]) || !isupper((unsigned char)item[1])){
+			return false;
+		}
+		parsed.push_back({ item, weight });
+		pos = comma + 1;
+	}
+	list = parsed;
+	return true;
+}
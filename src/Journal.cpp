@@ -0,0 +1,428 @@
+/*
+ * Journal.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/Journal.h>
+#include <nmeaparse/CRC.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	const char MAGIC[4] = { 'N', 'M', 'T', 'J' };
+	const uint16_t VERSION = 1;
+	const uint64_t FILE_HEADER_SIZE = 64;
+	const uint64_t RECORD_HEADER_SIZE = 32;
+	const uint64_t MIN_CAPACITY = 4096;
+
+	const uint16_t KIND_DATA = 0;
+	const uint16_t KIND_SESSION = 1;
+	const uint16_t KIND_PADDING = 2;
+	const uint16_t SESSION_CHANNEL = 0xFFFF;
+
+	struct RecordHeader {
+		uint32_t size;
+		uint16_t channel;
+		uint16_t kind;
+		uint64_t sequence;
+		int64_t time;
+		uint32_t crc;
+	};
+
+	uint64_t align8(uint64_t v){
+		return (v + 7) & ~(uint64_t)7;
+	}
+
+	// Largest payload of one record, longer chunks are split.
+	uint64_t maxPayload(uint64_t capacity){
+		return min(capacity / 4, (uint64_t)1 << 20) - RECORD_HEADER_SIZE;
+	}
+
+	void putLE(uint8_t* p, uint64_t v, size_t n){
+		for (size_t i = 0; i < n; i++){
+			p[i] = (uint8_t)(v >> (8 * i));
+		}
+	}
+
+	uint64_t getLE(const uint8_t* p, size_t n){
+		uint64_t v = 0;
+		for (size_t i = 0; i < n; i++){
+			v |= (uint64_t)p[i] << (8 * i);
+		}
+		return v;
+	}
+
+	RecordHeader readRecordHeader(const uint8_t* p){
+		RecordHeader h;
+		h.size = (uint32_t)getLE(p, 4);
+		h.channel = (uint16_t)getLE(p + 4, 2);
+		h.kind = (uint16_t)getLE(p + 6, 2);
+		h.sequence = getLE(p + 8, 8);
+		h.time = (int64_t)getLE(p + 16, 8);
+		h.crc = (uint32_t)getLE(p + 24, 4);
+		return h;
+	}
+
+	void writeRecordHeader(uint8_t* p, const RecordHeader& h){
+		putLE(p, h.size, 4);
+		putLE(p + 4, h.channel, 2);
+		putLE(p + 6, h.kind, 2);
+		putLE(p + 8, h.sequence, 8);
+		putLE(p + 16, (uint64_t)h.time, 8);
+		putLE(p + 24, h.crc, 4);
+		putLE(p + 28, 0, 4);
+	}
+
+	// Follows the complete, consecutive records from the tail, calling onRecord(offset, header)
+	// for each one but the padding. Returns the ring bytes used up to the end of the last one,
+	// and sets the sequence number of the next record.
+	template<class F>
+	uint64_t walk(const uint8_t* ring, uint64_t capacity, uint64_t tail, uint64_t& sequence, F onRecord){
+		uint64_t pos = tail;
+		uint64_t end = tail;
+		uint64_t expected = 0;
+		while (pos - tail < capacity){
+			uint64_t offset = pos % capacity;
+			uint64_t rest = capacity - offset;
+			if (rest < RECORD_HEADER_SIZE){
+				pos += rest;
+				continue;
+			}
+			RecordHeader h = readRecordHeader(ring + offset);
+			if (expected == 0 ? (h.sequence < 1 || h.sequence > sequence) : h.sequence != expected){
+				break;
+			}
+			uint64_t bytes;
+			if (h.kind == KIND_PADDING){
+				if (h.size != rest - RECORD_HEADER_SIZE){
+					break;
+				}
+				bytes = rest;
+			}
+			else {
+				if (h.kind > KIND_PADDING || h.size > maxPayload(capacity)){
+					break;
+				}
+				bytes = align8(RECORD_HEADER_SIZE + h.size);
+				if (bytes > rest || crc32(ring + offset + RECORD_HEADER_SIZE, h.size) != h.crc){
+					break;
+				}
+			}
+			if (pos + bytes - tail > capacity){
+				break;
+			}
+			if (h.kind != KIND_PADDING){
+				onRecord(offset, h);
+			}
+			pos += bytes;
+			end = pos;
+			expected = h.sequence + 1;
+		}
+		if (expected != 0){
+			sequence = expected;
+		}
+		return end;
+	}
+}
+
+
+
+// ------------- JOURNAL ----------------
+
+void Journal::Tap::write(const uint8_t* data, size_t size){
+	journal->append(channel, data, size);
+}
+
+Journal::Journal()
+{}
+
+Journal::~Journal(){
+	close();
+}
+
+int64_t Journal::steadyTime(){
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool Journal::open(const string& path, size_t requested, string* error){
+	close();
+	lock_guard<mutex> guard(lock);
+
+	uint64_t cap = align8(max((uint64_t)requested, MIN_CAPACITY));
+	const char* bad = nullptr;
+	if (!file.create(path, FILE_HEADER_SIZE + cap)){
+		bad = "Cannot create ";
+	}
+	uint8_t* p = file.writableData();
+	if (!bad && memcmp(p, MAGIC, sizeof(MAGIC)) != 0){
+		// a new file is all zeros
+		if (any_of(p, p + FILE_HEADER_SIZE, [](uint8_t b){ return b != 0; })){
+			bad = "Not a journal: ";
+		}
+		else {
+			memcpy(p, MAGIC, sizeof(MAGIC));
+			putLE(p + 4, VERSION, 2);
+			putLE(p + 8, cap, 8);
+			putLE(p + 16, 0, 8);
+			putLE(p + 24, 0, 8);
+			putLE(p + 32, 1, 8);
+		}
+	}
+	if (!bad){
+		cap = getLE(p + 8, 8);
+		if (getLE(p + 4, 2) != VERSION || cap < MIN_CAPACITY || cap % 8 != 0 || FILE_HEADER_SIZE + cap > file.size()){
+			bad = "Corrupt journal: ";
+		}
+	}
+	if (bad){
+		if (error){
+			*error = bad + path;
+		}
+		file.close();
+		return false;
+	}
+
+	ring = p + FILE_HEADER_SIZE;
+	capacity = cap;
+	tail = getLE(p + 16, 8);
+	sequence = getLE(p + 32, 8);
+	head = walk(ring, capacity, tail, sequence, [](uint64_t, const RecordHeader&){});
+	extendable = false;
+	writeHeader();
+
+	uint8_t now[8];
+	putLE(now, (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::system_clock::now().time_since_epoch()).count(), 8);
+	appendRecord(SESSION_CHANNEL, KIND_SESSION, now, sizeof(now), steadyTime());
+	return true;
+}
+
+void Journal::close(){
+	lock_guard<mutex> guard(lock);
+	for (auto& t : taps){
+		if (t->parser->rawTap == t.get()){
+			t->parser->rawTap = nullptr;
+		}
+	}
+	taps.clear();
+	if (ring != nullptr){
+		writeHeader();
+	}
+	file.close();
+	ring = nullptr;
+	extendable = false;
+}
+
+bool Journal::sync(){
+	lock_guard<mutex> guard(lock);
+	return ring != nullptr && file.sync();
+}
+
+void Journal::writeHeader(){
+	// the records are in place before the header points to them
+	atomic_thread_fence(memory_order_release);
+	uint8_t* p = ring - FILE_HEADER_SIZE;
+	putLE(p + 16, tail, 8);
+	putLE(p + 24, head, 8);
+	putLE(p + 32, sequence, 8);
+}
+
+// Drops the oldest records until there are free bytes after the head.
+void Journal::makeRoom(uint64_t bytes){
+	bool moved = false;
+	while (capacity - (head - tail) < bytes){
+		uint64_t offset = tail % capacity;
+		uint64_t rest = capacity - offset;
+		if (rest < RECORD_HEADER_SIZE){
+			tail += rest;
+		}
+		else {
+			RecordHeader h = readRecordHeader(ring + offset);
+			tail += h.kind == KIND_PADDING ? rest : align8(RECORD_HEADER_SIZE + h.size);
+		}
+		moved = true;
+	}
+	if (moved){
+		writeHeader();
+	}
+}
+
+void Journal::appendRecord(uint16_t channel, uint16_t kind, const uint8_t* data, size_t size, int64_t time){
+	uint64_t bytes = align8(RECORD_HEADER_SIZE + size);
+	uint64_t offset = head % capacity;
+	uint64_t rest = capacity - offset;
+	if (rest < bytes){
+		makeRoom(rest);
+		if (rest >= RECORD_HEADER_SIZE){
+			writeRecordHeader(ring + offset, { (uint32_t)(rest - RECORD_HEADER_SIZE), 0, KIND_PADDING, sequence++, time, 0 });
+		}
+		head += rest;
+		offset = 0;
+	}
+	makeRoom(bytes);
+
+	memcpy(ring + offset + RECORD_HEADER_SIZE, data, size);
+	writeRecordHeader(ring + offset, { (uint32_t)size, channel, kind, sequence++, time, crc32(data, size) });
+	lastRecord = head;
+	head += bytes;
+	writeHeader();
+
+	extendable = kind == KIND_DATA;
+	lastChannel = channel;
+	lastTime = time;
+}
+
+void Journal::appendLocked(uint16_t channel, const uint8_t* data, size_t size, int64_t time){
+	if (extendable && channel == lastChannel && time >= lastTime && time - lastTime < coalesce){
+		uint64_t offset = lastRecord % capacity;
+		RecordHeader h = readRecordHeader(ring + offset);
+		size_t n = (size_t)min((uint64_t)size, maxPayload(capacity) - h.size);
+		uint64_t oldBytes = align8(RECORD_HEADER_SIZE + h.size);
+		uint64_t newBytes = align8(RECORD_HEADER_SIZE + h.size + n);
+		if (n > 0 && offset + newBytes <= capacity){
+			makeRoom(newBytes - oldBytes);
+			memcpy(ring + offset + RECORD_HEADER_SIZE + h.size, data, n);
+			h.crc = crc32(data, n, h.crc);
+			h.size += (uint32_t)n;
+			atomic_thread_fence(memory_order_release);
+			writeRecordHeader(ring + offset, h);
+			head = lastRecord + newBytes;
+			writeHeader();
+			data += n;
+			size -= n;
+		}
+	}
+	uint64_t most = maxPayload(capacity);
+	while (size > 0){
+		size_t n = (size_t)min((uint64_t)size, most);
+		appendRecord(channel, KIND_DATA, data, n, time);
+		data += n;
+		size -= n;
+	}
+}
+
+void Journal::append(uint16_t channel, const void* data, size_t size){
+	append(channel, data, size, steadyTime());
+}
+
+void Journal::append(uint16_t channel, const void* data, size_t size, int64_t time){
+	lock_guard<mutex> guard(lock);
+	if (ring != nullptr && size > 0){
+		appendLocked(channel, (const uint8_t*)data, size, time);
+	}
+}
+
+void Journal::attachToParser(NMEAParser& parser, uint16_t channel){
+	detach(parser);
+	lock_guard<mutex> guard(lock);
+	unique_ptr<Tap> t(new Tap);
+	t->journal = this;
+	t->parser = &parser;
+	t->channel = channel;
+	parser.rawTap = t.get();
+	taps.push_back(move(t));
+}
+
+void Journal::detach(NMEAParser& parser){
+	lock_guard<mutex> guard(lock);
+	for (auto it = taps.begin(); it != taps.end();){
+		if ((*it)->parser == &parser){
+			if (parser.rawTap == it->get()){
+				parser.rawTap = nullptr;
+			}
+			it = taps.erase(it);
+		}
+		else {
+			it++;
+		}
+	}
+}
+
+
+
+// ------------- JOURNAL READER ----------------
+
+bool JournalReader::open(const string& path, string* error){
+	close();
+	const char* bad = nullptr;
+	if (!file.open(path)){
+		bad = "Cannot open ";
+	}
+	const uint8_t* p = file.data();
+	uint64_t cap = 0;
+	if (!bad && (file.size() < FILE_HEADER_SIZE || memcmp(p, MAGIC, sizeof(MAGIC)) != 0)){
+		bad = "Not a journal: ";
+	}
+	if (!bad){
+		cap = getLE(p + 8, 8);
+		if (getLE(p + 4, 2) != VERSION || cap < MIN_CAPACITY || cap % 8 != 0 || FILE_HEADER_SIZE + cap > file.size()){
+			bad = "Corrupt journal: ";
+		}
+	}
+	if (bad){
+		if (error){
+			*error = bad + path;
+		}
+		close();
+		return false;
+	}
+
+	const uint8_t* ring = p + FILE_HEADER_SIZE;
+	uint64_t sequence = getLE(p + 32, 8);
+	bool dated = false;
+	int64_t sessionUtc = 0;
+	int64_t sessionTime = 0;
+	walk(ring, cap, getLE(p + 16, 8), sequence, [&](uint64_t offset, const RecordHeader& h){
+		const uint8_t* payload = ring + offset + RECORD_HEADER_SIZE;
+		if (h.kind == KIND_SESSION){
+			dated = h.size >= 8;
+			sessionUtc = dated ? (int64_t)getLE(payload, 8) : 0;
+			sessionTime = h.time;
+			return;
+		}
+		JournalRecord r;
+		r.sequence = h.sequence;
+		r.channel = h.channel;
+		r.time = h.time;
+		r.utc = dated ? sessionUtc + (h.time - sessionTime) : 0;
+		r.data = payload;
+		r.size = h.size;
+		list.push_back(r);
+	});
+	return true;
+}
+
+void JournalReader::close(){
+	file.close();
+	list.clear();
+}
+
+uint64_t JournalReader::replay(NMEAParser& parser, int channel) const {
+	uint64_t fed = 0;
+	for (auto& r : list){
+		if (channel >= 0 && r.channel != channel){
+			continue;
+		}
+		size_t i = 0;
+		while (i < r.size){
+			try {
+				while (i < r.size){
+					parser.readByte(r.data[i++]);
+				}
+			}
+			catch (NMEAParseError&){
+				// the parser has dropped the sentence, go on with the next byte
+			}
+		}
+		fed += r.size;
+	}
+	return fed;
+}
@@ -0,0 +1,599 @@
+/*
+ * LogIndex.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/LogIndex.h>
+#include <nmeaparse/GPSFix.h>
+#include <nmeaparse/NumberConversion.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	const int64_t DAY = 86400LL * 1000000000;
+	const int64_t HALF_DAY = DAY / 2;
+	const size_t MIN_CHUNK = 1 << 20;		// smaller logs are scanned by one thread
+
+	const char MAGIC[4] = { 'N', 'M', 'T', 'I' };
+	const uint16_t VERSION = 1;
+
+	// Where a line was counted, as seen from inside one chunk of the log
+	struct Key {
+		int64_t day;			// days since 1970 if dayKnown, else rollovers since the chunk start
+		int64_t granule;		// time of day of the granule, -1 before the first time stamp of the chunk
+		uint32_t type;			// chunk local
+		bool dayKnown;
+
+		bool operator==(const Key& k) const {
+			return day == k.day && granule == k.granule && type == k.type && dayKnown == k.dayKnown;
+		}
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key& k) const {
+			uint64_t h = (uint64_t)k.day * 0x9E3779B97F4A7C15ULL;
+			h ^= (uint64_t)k.granule + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+			h ^= ((uint64_t)k.type << 1 | k.dayKnown) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+			return (size_t)h;
+		}
+	};
+
+	struct Range {
+		uint64_t first{0};
+		uint64_t end{0};
+		uint32_t count{0};
+	};
+
+	// Result of scanning one chunk. Day counts stay relative to the chunk start until a date
+	// is found, the merge resolves them with the state at the end of the previous chunk.
+	struct ChunkScan {
+		vector<string_view> types;
+		unordered_map<string_view, uint32_t> typeIds;
+		unordered_map<Key, Range, KeyHash> ranges;
+
+		LogTime time;
+
+		void scan(const uint8_t* data, size_t begin, size_t end, int64_t granularity);
+		void line(const char* text, size_t length, uint64_t offset, uint64_t next, int64_t granularity);
+	};
+
+	// Field i (0 = first parameter) of the sentence body after the name, without the checksum.
+	string_view field(string_view body, size_t i){
+		size_t start = 0;
+		for (size_t n = 0; n < i; n++){
+			size_t comma = body.find(',', start);
+			if (comma == string_view::npos){
+				return string_view();
+			}
+			start = comma + 1;
+		}
+		size_t comma = body.find(',', start);
+		return body.substr(start, comma == string_view::npos ? string_view::npos : comma - start);
+	}
+
+	void ChunkScan::line(const char* text, size_t length, uint64_t offset, uint64_t next, int64_t granularity){
+		string_view name, body;
+		if (!LogTime::split(string_view(text, length), name, body)){
+			return;
+		}
+
+		time.read(name, body);
+
+		auto t = typeIds.find(name);
+		uint32_t type;
+		if (t == typeIds.end()){
+			type = (uint32_t)types.size();
+			types.push_back(name);
+			typeIds.emplace(name, type);
+		}
+		else {
+			type = t->second;
+		}
+
+		Key key;
+		key.day = time.day;
+		key.dayKnown = time.dayKnown;
+		key.granule = time.timeOfDay < 0 ? -1 : time.timeOfDay - time.timeOfDay % granularity;
+		key.type = type;
+		Range& r = ranges[key];
+		if (r.count == 0){
+			r.first = offset;
+		}
+		r.end = next;
+		r.count++;
+	}
+
+	void ChunkScan::scan(const uint8_t* data, size_t begin, size_t end, int64_t granularity){
+		const char* text = (const char*)data;
+		size_t pos = begin;
+		while (pos < end){
+			const void* nl = memchr(text + pos, '\n', end - pos);
+			size_t lineEnd = nl ? (size_t)((const char*)nl - text) : end;
+			size_t next = nl ? lineEnd + 1 : end;
+			line(text + pos, lineEnd - pos, pos, next, granularity);
+			pos = next;
+		}
+	}
+
+	struct Resolved {
+		int64_t granule;
+		string_view type;
+		Range range;
+	};
+
+	void putU16(string& s, uint16_t v){
+		s.push_back((char)(v & 0xFF));
+		s.push_back((char)(v >> 8));
+	}
+
+	void putU32(string& s, uint32_t v){
+		putU16(s, (uint16_t)(v & 0xFFFF));
+		putU16(s, (uint16_t)(v >> 16));
+	}
+
+	void putU64(string& s, uint64_t v){
+		putU32(s, (uint32_t)(v & 0xFFFFFFFF));
+		putU32(s, (uint32_t)(v >> 32));
+	}
+
+	uint64_t getLE(const uint8_t* p, size_t n){
+		uint64_t v = 0;
+		for (size_t i = 0; i < n; i++){
+			v |= (uint64_t)p[i] << (8 * i);
+		}
+		return v;
+	}
+}
+
+
+
+// ------------- LOG TIME ----------------
+
+bool LogTime::split(string_view line, string_view& name, string_view& body){
+	size_t dollar = line.find_last_of('$');
+	if (dollar == string_view::npos){
+		return false;
+	}
+	string_view s = line.substr(dollar + 1);
+	size_t star = s.find('*');
+	if (star != string_view::npos){
+		s = s.substr(0, star);
+	}
+	while (!s.empty() && (s.back() == '\r' || s.back() == '\n')){
+		s.remove_suffix(1);
+	}
+	size_t comma = s.find(',');
+	name = s.substr(0, comma);
+	body = comma == string_view::npos ? string_view() : s.substr(comma + 1);
+	return !name.empty();
+}
+
+bool LogTime::read(string_view line){
+	string_view name, body;
+	if (!split(line, name, body)){
+		return false;
+	}
+	read(name, body);
+	return true;
+}
+
+void LogTime::read(string_view name, string_view body){
+	// only the standard sentences that have a time or date
+	if (name.size() != 5 || name[0] == 'P'){
+		return;
+	}
+	string_view id = name.substr(2);
+	string_view timeField;
+	if (id == "GGA" || id == "RMC" || id == "ZDA" || id == "GNS" || id == "GST"){
+		timeField = field(body, 0);
+	}
+	else if (id == "GLL"){
+		timeField = field(body, 4);
+	}
+	int64_t tod;
+	if (!timeField.empty() && parseTimeOfDay(timeField, tod)){
+		if (timeOfDay >= 0 && tod + HALF_DAY < timeOfDay){
+			day++;		// past midnight
+		}
+		if (firstTimeOfDay < 0){
+			firstTimeOfDay = tod;
+		}
+		timeOfDay = tod;
+	}
+
+	int64_t date;
+	bool hasDate = false;
+	if (id == "RMC"){
+		int32_t raw;
+		if (parseDate(field(body, 8), raw)){
+			GPSTimestamp ts;
+			ts.setDate(raw);
+			ts.setTimeOfDay(0);
+			date = ts.nanos() / DAY;
+			hasDate = true;
+		}
+	}
+	else if (id == "ZDA"){
+		int64_t d, m, y;
+		if (tryParseInt(field(body, 1), d) && tryParseInt(field(body, 2), m) && tryParseInt(field(body, 3), y)
+			&& d >= 1 && d <= 31 && m >= 1 && m <= 12 && y > 0){
+			date = GPSTimestamp::daysFromCivil(y, (uint32_t)m, (uint32_t)d);
+			hasDate = true;
+		}
+	}
+	if (hasDate){
+		if (!dayKnown){
+			firstDate = date;
+			daysBeforeDate = day;
+		}
+		dayKnown = true;
+		day = date;
+	}
+}
+
+int64_t LogTime::time() const {
+	return day * DAY + max(timeOfDay, (int64_t)0);
+}
+
+
+
+// ------------- LOG INDEX ----------------
+
+bool LogIndex::build(const string& logPath, int64_t g, unsigned threads, string* error){
+	MappedFile file;
+	if (!file.open(logPath)){
+		if (error){
+			*error = "Cannot open " + logPath;
+		}
+		return false;
+	}
+	if (!build(file.data(), file.size(), g, threads)){
+		if (error){
+			*error = "The granularity must divide a day.";
+		}
+		return false;
+	}
+	return true;
+}
+
+bool LogIndex::build(const uint8_t* data, size_t size, int64_t g, unsigned threads){
+	if (g <= 0 || DAY % g != 0){
+		return false;
+	}
+	granularity = g;
+	logSize = size;
+	types.clear();
+	entries.clear();
+
+	// chunks end on line boundaries
+	if (threads == 0){
+		threads = max(1u, thread::hardware_concurrency());
+	}
+	size_t n = max((size_t)1, min((size_t)threads, size / MIN_CHUNK));
+	vector<size_t> bounds{ 0 };
+	for (size_t i = 1; i < n; i++){
+		size_t b = max(bounds.back(), size * i / n);
+		const void* nl = b < size ? memchr(data + b, '\n', size - b) : nullptr;
+		b = nl ? (size_t)((const uint8_t*)nl - data) + 1 : size;
+		if (b > bounds.back() && b < size){
+			bounds.push_back(b);
+		}
+	}
+	bounds.push_back(size);
+	n = bounds.size() - 1;
+
+	vector<ChunkScan> chunks(n);
+	if (n == 1){
+		chunks[0].scan(data, 0, size, g);
+	}
+	else {
+		vector<thread> workers;
+		for (size_t i = 0; i < n; i++){
+			workers.emplace_back([&, i](){
+				chunks[i].scan(data, bounds[i], bounds[i + 1], g);
+			});
+		}
+		for (auto& w : workers){
+			w.join();
+		}
+	}
+
+	// time of day before each chunk, and whether the chunk starts past midnight
+	vector<int64_t> previousTime(n, -1);
+	vector<int64_t> rollover(n, 0);
+	for (size_t k = 1; k < n; k++){
+		previousTime[k] = chunks[k - 1].time.timeOfDay >= 0 ? chunks[k - 1].time.timeOfDay : previousTime[k - 1];
+		if (previousTime[k] >= 0 && chunks[k].time.firstTimeOfDay >= 0 && chunks[k].time.firstTimeOfDay + HALF_DAY < previousTime[k]){
+			rollover[k] = 1;
+		}
+	}
+
+	// day at the start and end of each chunk: back from the first date found, then forward
+	vector<int64_t> start(n, 0);
+	vector<int64_t> end(n, 0);
+	vector<bool> known(n, false);
+	size_t j = 0;
+	while (j < n && !chunks[j].time.dayKnown){
+		j++;
+	}
+	if (j < n){
+		start[j] = chunks[j].time.firstDate - chunks[j].time.daysBeforeDate;
+		known[j] = true;
+		for (size_t k = j; k-- > 0;){
+			start[k] = start[k + 1] - rollover[k + 1] - chunks[k].time.day;
+			known[k] = true;
+		}
+	}
+	else {
+		known[0] = true;		// no date anywhere, times are since Jan 1, 1970
+	}
+	for (size_t k = 0; k < n; k++){
+		if (!known[k]){
+			start[k] = end[k - 1] + rollover[k];
+		}
+		end[k] = chunks[k].time.dayKnown ? chunks[k].time.day : start[k] + chunks[k].time.day;
+	}
+
+	vector<Resolved> resolved;
+	for (size_t k = 0; k < n; k++){
+		const ChunkScan& c = chunks[k];
+		for (auto& kv : c.ranges){
+			const Key& key = kv.first;
+			int64_t t;
+			if (key.granule < 0){
+				// before the first time stamp of the chunk, still in the last granule before it
+				if (previousTime[k] >= 0){
+					t = end[k - 1] * DAY + previousTime[k] - previousTime[k] % g;
+				}
+				else if (c.time.firstTimeOfDay >= 0){
+					t = start[k] * DAY + c.time.firstTimeOfDay - c.time.firstTimeOfDay % g;
+				}
+				else {
+					t = start[k] * DAY;
+				}
+			}
+			else {
+				t = (key.dayKnown ? key.day : start[k] + key.day) * DAY + key.granule;
+			}
+			resolved.push_back({ t, c.types[key.type], kv.second });
+		}
+	}
+
+	// global type ids, sorted by name
+	for (auto& r : resolved){
+		types.emplace_back(r.type);
+	}
+	sort(types.begin(), types.end());
+	types.erase(unique(types.begin(), types.end()), types.end());
+	unordered_map<string_view, uint16_t> ids;
+	for (size_t i = 0; i < types.size(); i++){
+		ids.emplace(types[i], (uint16_t)i);
+	}
+
+	entries.reserve(resolved.size());
+	for (auto& r : resolved){
+		entries.push_back({ r.granule, r.range.first, r.range.end, r.range.count, ids[r.type] });
+	}
+	sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b){
+		return a.granule != b.granule ? a.granule < b.granule : a.type != b.type ? a.type < b.type : a.first < b.first;
+	});
+
+	// the same granule and type may come from several chunks
+	size_t out = 0;
+	for (size_t i = 0; i < entries.size(); i++){
+		if (out > 0 && entries[out - 1].granule == entries[i].granule && entries[out - 1].type == entries[i].type){
+			Entry& e = entries[out - 1];
+			e.first = min(e.first, entries[i].first);
+			e.end = max(e.end, entries[i].end);
+			e.count += entries[i].count;
+		}
+		else {
+			entries[out++] = entries[i];
+		}
+	}
+	entries.resize(out);
+	return true;
+}
+
+bool LogIndex::save(const string& path, string* error) const {
+	string s(MAGIC, sizeof(MAGIC));
+	putU16(s, VERSION);
+	putU16(s, 0);
+	putU64(s, (uint64_t)granularity);
+	putU64(s, logSize);
+	putU32(s, (uint32_t)types.size());
+	putU32(s, (uint32_t)entries.size());
+	for (auto& t : types){
+		s.push_back((char)min(t.size(), (size_t)255));
+		s.append(t, 0, 255);
+	}
+	for (auto& e : entries){
+		putU64(s, (uint64_t)e.granule);
+		putU64(s, e.first);
+		putU64(s, e.end);
+		putU32(s, e.count);
+		putU16(s, e.type);
+		putU16(s, 0);
+	}
+
+	ofstream f(path, ios::binary | ios::trunc);
+	f.write(s.data(), s.size());
+	if (!f.good()){
+		if (error){
+			*error = "Cannot write " + path;
+		}
+		return false;
+	}
+	return true;
+}
+
+bool LogIndex::load(const string& path, string* error){
+	MappedFile file;
+	const char* bad = nullptr;
+	if (!file.open(path)){
+		bad = "Cannot open ";
+	}
+	const uint8_t* p = file.data();
+	size_t size = file.size();
+	const size_t HEADER = 32;
+	const size_t ENTRY = 32;
+	if (!bad && (size < HEADER || memcmp(p, MAGIC, sizeof(MAGIC)) != 0 || getLE(p + 4, 2) != VERSION)){
+		bad = "Not a log index: ";
+	}
+
+	vector<string> t;
+	vector<Entry> e;
+	if (!bad){
+		uint32_t typeCount = (uint32_t)getLE(p + 24, 4);
+		uint32_t entryCount = (uint32_t)getLE(p + 28, 4);
+		size_t pos = HEADER;
+		for (uint32_t i = 0; i < typeCount && !bad; i++){
+			if (pos >= size || size - pos - 1 < p[pos]){
+				bad = "Truncated log index: ";
+				break;
+			}
+			t.emplace_back((const char*)p + pos + 1, p[pos]);
+			pos += 1 + p[pos];
+		}
+		if (!bad && (size - pos) / ENTRY < entryCount){
+			bad = "Truncated log index: ";
+		}
+		for (uint32_t i = 0; i < entryCount && !bad; i++, pos += ENTRY){
+			Entry x;
+			x.granule = (int64_t)getLE(p + pos, 8);
+			x.first = getLE(p + pos + 8, 8);
+			x.end = getLE(p + pos + 16, 8);
+			x.count = (uint32_t)getLE(p + pos + 24, 4);
+			x.type = (uint16_t)getLE(p + pos + 28, 2);
+			if (x.type >= t.size()){
+				bad = "Corrupt log index: ";
+			}
+			e.push_back(x);
+		}
+	}
+	if (bad){
+		if (error){
+			*error = bad + path;
+		}
+		return false;
+	}
+
+	granularity = (int64_t)getLE(p + 8, 8);
+	logSize = getLE(p + 16, 8);
+	types.swap(t);
+	entries.swap(e);
+	return true;
+}
+
+vector<LogIndex::Entry> LogIndex::find(int64_t from, int64_t to, string_view type) const {
+	vector<Entry> found;
+	if (from > to){
+		return found;
+	}
+	// first granule that ends after `from`
+	auto it = lower_bound(entries.begin(), entries.end(), from, [this](const Entry& e, int64_t t){
+		return e.granule + granularity <= t;
+	});
+	for (; it != entries.end() && it->granule <= to; it++){
+		if (type.empty() || types[it->type] == type){
+			found.push_back(*it);
+		}
+	}
+	return found;
+}
+
+bool LogIndex::range(int64_t from, int64_t to, uint64_t& first, uint64_t& end, string_view type) const {
+	vector<Entry> found = find(from, to, type);
+	if (found.empty()){
+		return false;
+	}
+	first = found.front().first;
+	end = found.front().end;
+	for (auto& e : found){
+		first = min(first, e.first);
+		end = max(end, e.end);
+	}
+	return true;
+}
+
+int64_t LogIndex::firstTime() const {
+	return entries.empty() ? 0 : entries.front().granule;
+}
+
+int64_t LogIndex::lastTime() const {
+	return entries.empty() ? 0 : entries.back().granule + granularity;
+}
+
+
+
+// ------------- INDEXED LOG READER ----------------
+
+bool IndexedLogReader::open(const string& logPath, string* error, int64_t granularity){
+	close();
+	if (!file.open(logPath)){
+		if (error){
+			*error = "Cannot open " + logPath;
+		}
+		return false;
+	}
+	string sidecar = LogIndex::sidecarPath(logPath);
+	if (!idx.load(sidecar) || idx.logSize != file.size()){
+		if (!idx.build(file.data(), file.size(), granularity)){
+			if (error){
+				*error = "The granularity must divide a day.";
+			}
+			close();
+			return false;
+		}
+		idx.save(sidecar);		// best effort, the log may be in a read-only place
+	}
+	return true;
+}
+
+void IndexedLogReader::close(){
+	file.close();
+	idx = LogIndex();
+}
+
+size_t IndexedLogReader::read(int64_t from, int64_t to, NMEAParser& parser, string_view type) const {
+	uint64_t first, end;
+	if (!idx.range(from, to, first, end, type) || end > file.size()){
+		return 0;
+	}
+
+	const char* text = (const char*)file.data();
+	size_t count = 0;
+	size_t pos = (size_t)first;
+	while (pos < end){
+		const void* nl = memchr(text + pos, '\n', (size_t)end - pos);
+		size_t lineEnd = nl ? (size_t)((const char*)nl - text) : (size_t)end;
+		string_view line(text + pos, lineEnd - pos);
+		pos = nl ? lineEnd + 1 : (size_t)end;
+
+		string_view name, body;
+		if (!type.empty() && (!LogTime::split(line, name, body) || name != type)){
+			continue;
+		}
+		if (!line.empty() && line.back() == '\r'){
+			line.remove_suffix(1);
+		}
+		try {
+			parser.readLine(string(line));
+		}
+		catch (NMEAParseError&){
+			// not a sentence, skip it
+		}
+		count++;
+	}
+	return count;
+}
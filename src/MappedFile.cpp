@@ -0,0 +1,209 @@
+/*
+ * MappedFile.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/MappedFile.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace nmea;
+
+
+MappedFile::MappedFile()
+{}
+
+MappedFile::~MappedFile(){
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const string& path){
+	close();
+	HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (f == INVALID_HANDLE_VALUE){
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(f, &size)){
+		CloseHandle(f);
+		return false;
+	}
+	file = f;
+	opened = true;
+	if (size.QuadPart == 0){
+		return true;
+	}
+
+	HANDLE m = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m == NULL){
+		close();
+		return false;
+	}
+	mapping = m;
+	bytes = (uint8_t*)MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+	if (bytes == nullptr){
+		close();
+		return false;
+	}
+	length = (size_t)size.QuadPart;
+	return true;
+}
+
+bool MappedFile::create(const string& path, size_t minimumSize){
+	close();
+	HANDLE f = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (f == INVALID_HANDLE_VALUE){
+		return false;
+	}
+	file = f;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(f, &size)){
+		close();
+		return false;
+	}
+	if ((uint64_t)size.QuadPart < minimumSize){
+		size.QuadPart = (LONGLONG)minimumSize;
+		if (!SetFilePointerEx(f, size, NULL, FILE_BEGIN) || !SetEndOfFile(f)){
+			close();
+			return false;
+		}
+	}
+	opened = true;
+	writable = true;
+	if (size.QuadPart == 0){
+		return true;
+	}
+
+	HANDLE m = CreateFileMappingA(f, NULL, PAGE_READWRITE, 0, 0, NULL);
+	if (m == NULL){
+		close();
+		return false;
+	}
+	mapping = m;
+	bytes = (uint8_t*)MapViewOfFile(m, FILE_MAP_WRITE, 0, 0, 0);
+	if (bytes == nullptr){
+		close();
+		return false;
+	}
+	length = (size_t)size.QuadPart;
+	return true;
+}
+
+bool MappedFile::sync(){
+	if (!writable || bytes == nullptr){
+		return writable;
+	}
+	return FlushViewOfFile(bytes, 0) && FlushFileBuffers((HANDLE)file);
+}
+
+void MappedFile::close(){
+	if (bytes != nullptr){
+		UnmapViewOfFile(bytes);
+	}
+	if (mapping != nullptr){
+		CloseHandle((HANDLE)mapping);
+	}
+	if (file != nullptr){
+		CloseHandle((HANDLE)file);
+	}
+	bytes = nullptr;
+	mapping = nullptr;
+	file = nullptr;
+	length = 0;
+	opened = false;
+	writable = false;
+}
+
+#else
+
+bool MappedFile::open(const string& path){
+	close();
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0){
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0){
+		::close(fd);
+		return false;
+	}
+	if (st.st_size > 0){
+		void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if (p == MAP_FAILED){
+			::close(fd);
+			return false;
+		}
+		bytes = (uint8_t*)p;
+		length = (size_t)st.st_size;
+	}
+	::close(fd);		// the mapping stays valid
+	opened = true;
+	return true;
+}
+
+bool MappedFile::create(const string& path, size_t minimumSize){
+	close();
+	int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (fd < 0){
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0){
+		::close(fd);
+		return false;
+	}
+	size_t size = (size_t)st.st_size;
+	if (size < minimumSize){
+		if (ftruncate(fd, (off_t)minimumSize) != 0){
+			::close(fd);
+			return false;
+		}
+		size = minimumSize;
+	}
+	if (size > 0){
+		void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (p == MAP_FAILED){
+			::close(fd);
+			return false;
+		}
+		bytes = (uint8_t*)p;
+		length = size;
+	}
+	::close(fd);
+	opened = true;
+	writable = true;
+	return true;
+}
+
+bool MappedFile::sync(){
+	if (!writable || bytes == nullptr){
+		return writable;
+	}
+	return msync(bytes, length, MS_SYNC) == 0;
+}
+
+void MappedFile::close(){
+	if (bytes != nullptr){
+		munmap(bytes, length);
+	}
+	bytes = nullptr;
+	length = 0;
+	opened = false;
+	writable = false;
+}
+
+#endif
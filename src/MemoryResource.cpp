@@ -0,0 +1,43 @@
+/*
+ * MemoryResource.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/MemoryResource.h>
+#include <algorithm>
+
+using namespace std;
+using namespace nmea;
+
+
+// ------------- COUNTING RESOURCE ----------------
+
+CountingResource::CountingResource(pmr::memory_resource* _upstream)
+	: upstream(_upstream)
+{
+}
+
+CountingResource::~CountingResource(){
+}
+
+void* CountingResource::do_allocate(size_t bytes, size_t alignment){
+	void* p = upstream->allocate(bytes, alignment);		// counts nothing if it throws
+	allocations++;
+	total += bytes;
+	inUse += bytes;
+	peak = max(peak, inUse);
+	return p;
+}
+
+void CountingResource::do_deallocate(void* p, size_t bytes, size_t alignment){
+	upstream->deallocate(p, bytes, alignment);
+	deallocations++;
+	inUse -= bytes;
+}
+
+bool CountingResource::do_is_equal(const pmr::memory_resource& other) const noexcept {
+	return this == &other;
+}
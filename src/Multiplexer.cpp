@@ -0,0 +1,260 @@
+/*
+ * Multiplexer.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/Multiplexer.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	const char HEX[] = "0123456789ABCDEF";
+
+	int hexValue(char c){
+		if (c >= '0' && c <= '9'){
+			return c - '0';
+		}
+		if (c >= 'A' && c <= 'F'){
+			return c - 'A' + 10;
+		}
+		if (c >= 'a' && c <= 'f'){
+			return c - 'a' + 10;
+		}
+		return -1;
+	}
+
+	// The two hex digits of a checksum, or -1.
+	int checksumValue(string_view text){
+		if (text.size() != 2){
+			return -1;
+		}
+		int high = hexValue(text[0]);
+		int low = hexValue(text[1]);
+		return high < 0 || low < 0 ? -1 : high * 16 + low;
+	}
+
+	// "\s:tag,c:seconds*hh\"
+	size_t tagBlock(char* out, size_t size, const string& tag, bool timed, int64_t utc){
+		size_t n = 0;
+		out[n++] = '\\';
+		if (!tag.empty()){
+			size_t length = min(tag.size(), size - 32);
+			out[n++] = 's';
+			out[n++] = ':';
+			memcpy(out + n, tag.data(), length);
+			n += length;
+		}
+		if (timed){
+			if (n > 1){
+				out[n++] = ',';
+			}
+			out[n++] = 'c';
+			out[n++] = ':';
+			int64_t seconds = utc / 1000000000 - (utc % 1000000000 < 0);
+			char digits[20];
+			size_t count = 0;
+			uint64_t v = seconds < 0 ? 0 : (uint64_t)seconds;
+			do {
+				digits[count++] = (char)('0' + v % 10);
+				v /= 10;
+			} while (v > 0);
+			while (count > 0){
+				out[n++] = digits[--count];
+			}
+		}
+		uint8_t checksum = 0;
+		for (size_t i = 1; i < n; i++){
+			checksum ^= (uint8_t)out[i];
+		}
+		out[n++] = '*';
+		out[n++] = HEX[checksum >> 4];
+		out[n++] = HEX[checksum & 0xF];
+		out[n++] = '\\';
+		return n;
+	}
+}
+
+
+
+// ------------- MULTIPLEXER ----------------
+
+NMEAMultiplexer::NMEAMultiplexer(size_t capacity){
+	size_t size = 1024;
+	while (size < capacity){
+		size *= 2;
+	}
+	ring.resize(size);
+}
+
+NMEAMultiplexer::~NMEAMultiplexer(){
+}
+
+void NMEAMultiplexer::setClock(const Clock& clock){
+	timeSource = &clock;
+}
+
+size_t NMEAMultiplexer::addSource(){
+	lock_guard<mutex> guard(lock);
+	inputs.emplace_back(new Input);
+	return inputs.size() - 1;
+}
+
+void NMEAMultiplexer::write(size_t source, const void* data, size_t size){
+	lock_guard<mutex> guard(lock);
+	Input& input = *inputs[source];
+	const char* p = (const char*)data;
+	const char* end = p + size;
+	while (p < end){
+		const char* nl = (const char*)memchr(p, '\n', end - p);
+		const char* stop = nl ? nl : end;
+		size_t length = stop - p;
+
+		if (input.skipping){
+			input.skipping = nl == nullptr;
+		}
+		else if (input.partial.size() + length > MAX_LINE){
+			input.settings.rejected++;
+			input.partial.clear();
+			input.skipping = nl == nullptr;
+		}
+		else if (nl == nullptr){
+			input.partial.append(p, length);
+		}
+		else if (input.partial.empty()){
+			relay(input, p, length);		// straight from the chunk, the usual case
+		}
+		else {
+			input.partial.append(p, length);
+			relay(input, input.partial.data(), input.partial.size());
+			input.partial.clear();
+		}
+		p = nl ? nl + 1 : end;
+	}
+}
+
+void NMEAMultiplexer::relay(Input& input, const char* line, size_t length){
+	MultiplexSource& settings = input.settings;
+	if (length > 0 && line[length - 1] == '\r'){
+		length--;
+	}
+	if (!tokenizer.tokenize(string_view(line, length), verifyChecksums)){
+		if (length > 0){
+			settings.rejected++;
+		}
+		return;
+	}
+	int checksum = tokenizer.checksumSplit ? checksumValue(tokenizer.checksum) : -1;
+	if (verifyChecksums && checksum != tokenizer.calculatedChecksum){
+		settings.rejected++;
+		return;
+	}
+	if (!admit(input)){
+		settings.limited++;
+		return;
+	}
+
+	char tag[MAX_LINE / 4];
+	size_t tagLength = 0;
+	if (!settings.tag.empty() || timeTags){
+		tagLength = tagBlock(tag, sizeof(tag), settings.tag, timeTags, timeSource->now());
+	}
+	size_t sentenceLength = 1 + tokenizer.sentence.size();
+	size_t total = tagLength + sentenceLength + (crlf ? 2 : 1);
+	if (ring.size() - (head - tail) < total){
+		settings.overflows++;
+		return;
+	}
+
+	put(tag, tagLength);
+	uint64_t start = head;
+	put(tokenizer.sentence.data() - 1, sentenceLength);		// from the '$' or '!'
+	put("\r\n" + (crlf ? 0 : 1), crlf ? 2 : 1);
+
+	// patches the talker, and the checksum by the change of its bytes
+	const string_view& name = tokenizer.name;
+	if (settings.talker[0] != 0 && tokenizer.start == '$' && name.size() >= 3 && name[0] != 'P'){
+		uint8_t change = (uint8_t)(name[0] ^ name[1] ^ settings.talker[0] ^ settings.talker[1]);
+		size_t mask = ring.size() - 1;
+		ring[(start + 1) & mask] = (uint8_t)settings.talker[0];
+		ring[(start + 2) & mask] = (uint8_t)settings.talker[1];
+		if (change != 0 && checksum >= 0){
+			putHex(start + (tokenizer.checksum.data() - tokenizer.sentence.data()) + 1, (uint8_t)checksum ^ change);
+		}
+	}
+	settings.sentences++;
+}
+
+bool NMEAMultiplexer::admit(Input& input){
+	MultiplexSource& settings = input.settings;
+	if (!(settings.rate > 0.)){
+		return true;
+	}
+	int64_t now = timeSource->now();
+	if (!input.started){
+		input.started = true;
+		input.tokens = settings.burst;
+	}
+	else if (now > input.refill){
+		input.tokens = min(settings.burst, input.tokens + settings.rate * (double)(now - input.refill) / 1e9);
+	}
+	input.refill = now;
+	if (input.tokens < 1.){
+		return false;
+	}
+	input.tokens -= 1.;
+	return true;
+}
+
+void NMEAMultiplexer::put(const void* data, size_t size){
+	size_t offset = head & (ring.size() - 1);
+	size_t first = min(size, ring.size() - offset);
+	memcpy(ring.data() + offset, data, first);
+	memcpy(ring.data(), (const uint8_t*)data + first, size - first);
+	head += size;
+}
+
+void NMEAMultiplexer::putHex(uint64_t position, uint8_t value){
+	size_t mask = ring.size() - 1;
+	ring[position & mask] = (uint8_t)HEX[value >> 4];
+	ring[(position + 1) & mask] = (uint8_t)HEX[value & 0xF];
+}
+
+size_t NMEAMultiplexer::available() const {
+	lock_guard<mutex> guard(lock);
+	return head - tail;
+}
+
+size_t NMEAMultiplexer::read(void* buffer, size_t size){
+	lock_guard<mutex> guard(lock);
+	size = min(size, (size_t)(head - tail));
+	size_t offset = tail & (ring.size() - 1);
+	size_t first = min(size, ring.size() - offset);
+	memcpy(buffer, ring.data() + offset, first);
+	memcpy((uint8_t*)buffer + first, ring.data(), size - first);
+	tail += size;
+	return size;
+}
+
+size_t NMEAMultiplexer::peek(const uint8_t*& data) const {
+	lock_guard<mutex> guard(lock);
+	size_t offset = tail & (ring.size() - 1);
+	data = ring.data() + offset;
+	return min((size_t)(head - tail), ring.size() - offset);
+}
+
+void NMEAMultiplexer::consume(size_t size){
+	lock_guard<mutex> guard(lock);
+	tail += min(size, (size_t)(head - tail));
+}
+
+uint64_t NMEAMultiplexer::outputBytes() const {
+	lock_guard<mutex> guard(lock);
+	return head;
+}
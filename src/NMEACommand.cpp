@@ -10,6 +10,9 @@
 #include <nmeaparse/NMEACommand.h>
 #include <iomanip>
 #include <sstream>
+#include <charconv>
+#include <cstring>
+#include <memory>
 
 using namespace std;
 using namespace nmea;
@@ -22,7 +25,20 @@ NMEACommand::NMEACommand()
 NMEACommand::~NMEACommand(){};
 
 string NMEACommand::toString(){
-	return addChecksum(message);
+	char buffer[MAX_LENGTH];
+	char* text = buffer;
+	unique_ptr<char[]> large;
+	size_t length = encodeTo(buffer, sizeof(buffer));
+	for (size_t size = 2 * sizeof(buffer); length == 0; size *= 2){		// a long generic message
+		large.reset(new char[size]);
+		text = large.get();
+		length = encodeTo(text, size);
+	}
+
+	// "$name," ... "*hh\r\n"
+	message.assign(text + name.size() + 2, length - name.size() - 7);
+	checksum = (char)commandChecksum(string_view(text + 1, length - 6));
+	return string(text, length);
 }
 
 string NMEACommand::addChecksum(std::string s){
@@ -38,6 +54,59 @@ string NMEACommand::addChecksum(std::string s){
 	return ss.str();
 };
 
+size_t NMEACommand::encodeTo(char* buffer, size_t size) const {
+	static const char hex[] = "0123456789ABCDEF";
+	char* last = buffer + size;
+	if (size < 1){
+		return 0;
+	}
+	buffer[0] = '$';
+	char* p = encodeText(buffer + 1, last, name);
+	if (p == nullptr || p == last){
+		return 0;
+	}
+	*p++ = ',';
+	p = encodeBody(p, last);
+	if (p == nullptr || last - p < 5){
+		return 0;
+	}
+	uint8_t x = commandChecksum(string_view(buffer + 1, p - buffer - 1));
+	p[0] = '*';
+	p[1] = hex[x >> 4];
+	p[2] = hex[x & 0xF];
+	p[3] = '\r';
+	p[4] = '\n';
+	return p + 5 - buffer;
+}
+
+char* NMEACommand::encodeBody(char* first, char* last) const {
+	return encodeText(first, last, message);
+}
+
+char* NMEACommand::encodeText(char* first, char* last, string_view text){
+	if (first == nullptr || (size_t)(last - first) < text.size()){
+		return nullptr;
+	}
+	memcpy(first, text.data(), text.size());
+	return first + text.size();
+}
+
+char* NMEACommand::encodeInt(char* first, char* last, int64_t value, int width){
+	if (first == nullptr){
+		return nullptr;
+	}
+	char digits[24];
+	to_chars_result r = to_chars(digits, digits + sizeof(digits), value);
+	int length = (int)(r.ptr - digits);
+	int pad = width > length ? width - length : 0;
+	if (last - first < pad + length){
+		return nullptr;
+	}
+	memset(first, '0', pad);
+	memcpy(first + pad, digits, length);
+	return first + pad + length;
+}
+
 
 
 		/*
@@ -55,13 +124,15 @@ string NMEACommand::addChecksum(std::string s){
 		 Checksum	*0C
 		 <CR> <LF> End of message termination
 		*/
-std::string NMEACommandSerialConfiguration::toString(){
-	stringstream ss;
-
-	ss << "1," << baud << "," << databits << "," << stopbits << "," << parity;
-	message = ss.str();
-
-	return NMEACommand::addChecksum(message);
+char* NMEACommandSerialConfiguration::encodeBody(char* first, char* last) const {
+	char* p = encodeText(first, last, "1,");
+	p = encodeInt(p, last, baud);
+	p = encodeText(p, last, ",");
+	p = encodeInt(p, last, databits);
+	p = encodeText(p, last, ",");
+	p = encodeInt(p, last, stopbits);
+	p = encodeText(p, last, ",");
+	return encodeInt(p, last, parity);
 }
 
 
@@ -98,15 +169,13 @@ std::string NMEACommandSerialConfiguration::toString(){
 //   int rate;
 //   int checksumEnable;
 // Creates a valid NMEA $PSRF103 command sentence.
-std::string NMEACommandQueryRate::toString(){
-	stringstream ss;
-
-	ss << setfill('0') << setw(2) << messageID << ","
-		 << setfill('0') << setw(2) << mode << ","
-		 << setfill('0') << setw(2) << rate << ","
-		 << setfill('0') << setw(2) << checksumEnable;
-	message = ss.str();
-
-	return NMEACommand::addChecksum(message);
+char* NMEACommandQueryRate::encodeBody(char* first, char* last) const {
+	char* p = encodeInt(first, last, messageID, 2);
+	p = encodeText(p, last, ",");
+	p = encodeInt(p, last, mode, 2);
+	p = encodeText(p, last, ",");
+	p = encodeInt(p, last, rate, 2);
+	p = encodeText(p, last, ",");
+	return encodeInt(p, last, checksumEnable, 2);
 }
 
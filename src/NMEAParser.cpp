@@ -9,6 +9,7 @@
 
 #include <nmeaparse/NMEAParser.h>
 #include <nmeaparse/NumberConversion.h>
+#include <nmeaparse/NMEATokenizer.h>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
@@ -63,7 +64,7 @@ bool NMEASentence::checksumOK() const {
 
 
 // true if the text contains a non-alpha numeric value
-bool hasNonAlphaNum(string txt){
+bool hasNonAlphaNum(string_view txt){
 	for (const char i : txt){
 		if ( !isalnum(i) ){
 			return true;
@@ -73,7 +74,7 @@ bool hasNonAlphaNum(string txt){
 }
 
 // true if alphanumeric or '-'
-bool validParamChars(string txt){
+bool validParamChars(string_view txt){
 	for (const char i : txt){
 		if (!isalnum(i)){
 			if (i != '-' && i != '.' && i != '+'){
@@ -85,7 +86,7 @@ bool validParamChars(string txt){
 }
 
 // remove all whitespace
-void squish(string& str){
+void squish(pmr::string& str){
 
 	char chars[] = {'\t',' '};
 	for (const char i : chars)
@@ -109,9 +110,22 @@ void trim(string& str){
 
 
 NMEAParser::NMEAParser() 
-: log(false)
-, maxbuffersize(NMEA_PARSER_MAX_BUFFER_SIZE)
+: NMEAParser(pmr::get_default_resource())
+{ }
+
+NMEAParser::NMEAParser(pmr::memory_resource* _resource)
+: resource(_resource)
+, eventTable(_resource)
+, passiveHandlers(_resource)
+, buffer(_resource)
 , fillingbuffer(false)
+, maxbuffersize(NMEA_PARSER_MAX_BUFFER_SIZE)
+, sentenceArena(arenaBuffer, sizeof(arenaBuffer), _resource)
+, sentences(_resource)
+, spareParameters(_resource)
+, log(false)
+, onSentence(_resource)
+, onHandlersChanged(_resource)
 { }
 
 NMEAParser::~NMEAParser() 
@@ -119,8 +133,36 @@ NMEAParser::~NMEAParser()
 
 
 void NMEAParser::setSentenceHandler(std::string cmdKey, std::function<void(const NMEASentence&)> handler){
-	eventTable.erase(cmdKey);
-	eventTable.insert({ cmdKey, handler });
+	pmr::string key(cmdKey, resource);
+	passiveHandlers.erase(key);
+	eventTable.insert_or_assign(move(key), move(handler));
+	onHandlersChanged();
+}
+
+void NMEAParser::setPassiveSentenceHandler(std::string cmdKey, std::function<void(const NMEASentence&)> handler){
+	pmr::string key(cmdKey, resource);
+	passiveHandlers.insert(key);
+	eventTable.insert_or_assign(move(key), move(handler));
+	onHandlersChanged();
+}
+
+void NMEAParser::removeSentenceHandler(const std::string& cmdKey){
+	pmr::string key(cmdKey, resource);
+	passiveHandlers.erase(key);
+	if (eventTable.erase(key) > 0){
+		onHandlersChanged();
+	}
+}
+
+vector<string> NMEAParser::getRegisteredSentenceHandlers(bool includePassive) const {
+	vector<string> names;
+	for (const auto& table : eventTable){
+		if (table.second && (includePassive || passiveHandlers.count(table.first) == 0)){
+			names.emplace_back(table.first);
+		}
+	}
+	sort(names.begin(), names.end());
+	return names;
 }
 string NMEAParser::getRegisteredSentenceHandlersCSV()
 {
@@ -145,13 +187,18 @@ string NMEAParser::getRegisteredSentenceHandlersCSV()
 }
 
 void NMEAParser::readByte(uint8_t b){
-	uint8_t startbyte = '$';
+	if (rawTap != nullptr){
+		rawTap->write(&b, 1);
+	}
+	consumeByte(b);
+}
 
+void NMEAParser::consumeByte(uint8_t b){
 	if (fillingbuffer){
 		if (b == '\n'){
 			buffer.push_back(b);
 			try {
-				readSentence(buffer);
+				dispatch(buffer);
 				buffer.clear();
 				fillingbuffer = false;
 			}
@@ -180,7 +227,7 @@ void NMEAParser::readByte(uint8_t b){
 		}
 	}
 	else {
-		if (b == startbyte){			// only start filling when we see the start byte.
+		if (b == '$' || b == '!'){			// only start filling when we see a start byte ('!' for AIS and other encapsulated sentences).
 			fillingbuffer = true;
 			buffer.push_back(b);
 		}
@@ -188,71 +235,95 @@ void NMEAParser::readByte(uint8_t b){
 }
 
 void NMEAParser::readBuffer(uint8_t* b, uint32_t size){
+	if (rawTap != nullptr){
+		rawTap->write(b, size);
+	}
 	for (uint32_t i = 0; i < size; ++i){
-		readByte(b[i]);
+		consumeByte(b[i]);
 	}
 }
 
 void NMEAParser::readLine(string cmd){
 	cmd += "\r\n";
+	if (rawTap != nullptr){
+		rawTap->write((const uint8_t*)cmd.data(), cmd.size());
+	}
 	for (const char i : cmd){
-		readByte(i);
+		consumeByte(i);
 	}
 }
 
 // Loggers
-void NMEAParser::onInfo(NMEASentence& nmea, string txt){
+void NMEAParser::onInfo(NMEASentence& nmea, string_view txt){
 	if (log){
 		cout << "[Info]    " << txt << endl;
 	}
 }
-void NMEAParser::onWarning(NMEASentence& nmea, string txt){
+void NMEAParser::onWarning(NMEASentence& nmea, string_view txt){
 	if (log){
 		cout << "[Warning] " << txt << endl;
 	}
 }
-void NMEAParser::onError(NMEASentence& nmea, string txt){
-	throw NMEAParseError("[ERROR] " + txt);
+void NMEAParser::onError(NMEASentence& nmea, string_view txt){
+	throw NMEAParseError("[ERROR] " + string(txt));
 }
 
 // takes a complete NMEA string and gets the data bits from it,
 // calls the corresponding handler in eventTable, based on the 5 letter sentence code
 void NMEAParser::readSentence(std::string cmd){
+	dispatch(cmd);
+}
+
+void NMEAParser::dispatch(string_view line){
 
-	NMEASentence nmea;
+	// The temporaries below are allocated in the arena, released when the outermost call returns
+	// (a handler may inject a sentence of its own, parsed into the sentence of the next depth).
+	struct ArenaScope {
+		NMEAParser& parser;
+		ArenaScope(NMEAParser& p) : parser(p)	{ parser.depth++; }
+		~ArenaScope()							{ if (--parser.depth == 0) parser.sentenceArena.release(); }
+	} scope(*this);
+
+	if (sentences.size() < (size_t)depth){
+		sentences.emplace_back();
+	}
+	NMEASentence& nmea = sentences[depth - 1];
+	resetSentence(nmea);
 
 	onInfo(nmea, "Processing NEW string...");
 	
-	if (cmd.empty()){
+	if (line.empty()){
 		onWarning(nmea, "Blank string -- Skipped processing.");
 		return;
 	}
 	
 	// If there is a newline at the end (we are coming from the byte reader
-	if ( *(cmd.end()-1) == '\n'){
-		if (*(cmd.end() - 2) == '\r'){	// if there is a \r before the newline, remove it.
-			cmd = cmd.substr(0, cmd.size() - 2);
+	if (line.back() == '\n'){
+		if (line.size() >= 2 && line[line.size() - 2] == '\r'){	// if there is a \r before the newline, remove it.
+			line.remove_suffix(2);
 		}
 		else
 		{
 			onWarning(nmea, "Malformed newline, missing carriage return (\\r) ");
-			cmd = cmd.substr(0, cmd.size()-1);
+			line.remove_suffix(1);
 		}
 	}
 
 	ios_base::fmtflags oldflags = cout.flags();
 
 	// Remove all whitespace characters.
-	size_t beginsize = cmd.size();
+	pmr::string cmd(line, &sentenceArena);
 	squish(cmd);
-	if (cmd.size() != beginsize){
+	if (cmd.size() != line.size() && log){
 		stringstream ss;
-		ss << "New NMEA string was full of " << (beginsize - cmd.size()) << " whitespaces!";
+		ss << "New NMEA string was full of " << (line.size() - cmd.size()) << " whitespaces!";
 		onWarning(nmea, ss.str());
 	}
 
 	
-	onInfo(nmea, string("NMEA string: (\"") + cmd + "\")");
+	if (log){
+		onInfo(nmea, string("NMEA string: (\"") + string(cmd) + "\")");
+	}
 	
 
 	// Seperates the data now that everything is formatted
@@ -292,12 +363,15 @@ void NMEAParser::readSentence(std::string cmd){
 
 
 	// Call event handlers based on map entries
-	function<void(const NMEASentence&)> handler = eventTable[nmea.name];
-	if (handler){
-		onInfo(nmea, string("Calling specific handler for sentence named \"") + nmea.name + "\"");
+	auto entry = eventTable.find(pmr::string(nmea.name, &sentenceArena));		// find, not [], which would register an empty handler
+	if (entry != eventTable.end() && entry->second){
+		if (log){
+			onInfo(nmea, string("Calling specific handler for sentence named \"") + nmea.name + "\"");
+		}
+		function<void(const NMEASentence&)> handler = entry->second;		// a copy: the handler may replace itself
 		handler(nmea);
 	}
-	else
+	else if (log)
 	{
 		onWarning(nmea, string("Null event handler for type (name: \"") + nmea.name + "\")");
 	}
@@ -312,7 +386,7 @@ void NMEAParser::readSentence(std::string cmd){
 
 // takes the string *between* the '$' and '*' in nmea sentence,
 // then calculates a rolling XOR on the bytes
-uint8_t NMEAParser::calculateChecksum(string s){
+uint8_t NMEAParser::calculateChecksum(std::string_view s){
 	uint8_t checksum = 0;
 	for (const char i : s){
 		checksum = checksum ^ i;
@@ -329,7 +403,32 @@ uint8_t NMEAParser::calculateChecksum(string s){
 }
 
 
-void NMEAParser::parseText(NMEASentence& nmea, string txt){
+// Empties a sentence of the parser for the next one, keeping the buffers of its strings.
+void NMEAParser::resetSentence(NMEASentence& nmea){
+	nmea.isvalid = false;
+	nmea.text.clear();
+	nmea.name.clear();
+	nmea.checksum.clear();
+	nmea.checksumIsCalculated = false;
+	nmea.parsedChecksum = 0;
+	nmea.calculatedChecksum = 0;
+	for (auto& p : nmea.parameters){
+		spareParameters.push_back(std::move(p));
+	}
+	nmea.parameters.clear();
+}
+
+void NMEAParser::addParameter(NMEASentence& nmea, string_view field){
+	if (spareParameters.empty()){
+		nmea.parameters.emplace_back(field);
+		return;
+	}
+	nmea.parameters.push_back(std::move(spareParameters.back()));
+	spareParameters.pop_back();
+	nmea.parameters.back().assign(field);
+}
+
+void NMEAParser::parseText(NMEASentence& nmea, string_view txt){
 
 	if (txt.empty()){
 		nmea.isvalid = false;
@@ -339,29 +438,18 @@ void NMEAParser::parseText(NMEASentence& nmea, string txt){
 	nmea.isvalid = false;	// assume it's invalid first
 	nmea.text = txt;		// save the received text of the sentence
 
-	// Looking for index of last '$'
-	size_t startbyte = 0;
-	size_t dollar = txt.find_last_of('$');
-	if (dollar == string::npos){
+	// Split from the last '$' or '!'
+	NMEATokenizer tokens;
+	if (!tokens.tokenize(txt)){
 		// No dollar sign... INVALID!
 		return;
 	}
-	else
-	{
-		startbyte = dollar;
-	}
-
-
-	// Get rid of data up to last'$'
-	txt = txt.substr(startbyte + 1);
 
 
 	// Look for checksum
-	size_t checkstri = txt.find_last_of('*');
-	bool haschecksum = checkstri != string::npos;
-	if (haschecksum){
+	if (tokens.hasChecksum){
 		// A checksum was passed in the message, so calculate what we expect to see
-		nmea.calculatedChecksum = calculateChecksum(txt.substr(0, checkstri));
+		nmea.calculatedChecksum = tokens.calculatedChecksum;
 	}
 	else
 	{
@@ -370,15 +458,14 @@ void NMEAParser::parseText(NMEASentence& nmea, string txt){
 	}
 
 	// Handle comma edge cases
-	size_t comma = txt.find(',');
-	if (comma == string::npos){		//comma not found, but there is a name...
-		if (!txt.empty())
+	if (!tokens.hasFields){		//comma not found, but there is a name...
+		if (!tokens.name.empty())
 		{	// the received data must just be the name
-			if ( hasNonAlphaNum(txt) ){
+			if ( hasNonAlphaNum(tokens.name) ){
 				nmea.isvalid = false;
 				return;
 			}
-			nmea.name = txt;
+			nmea.name.assign(tokens.name);
 			nmea.isvalid = true;
 			return;
 		}
@@ -390,14 +477,14 @@ void NMEAParser::parseText(NMEASentence& nmea, string txt){
 	}
 
 	//"$," case - no name
-	if (comma == 0){
+	if (tokens.name.empty()){
 		nmea.isvalid = false;
 		return;
 	}
 
 
 	//name should not include first comma
-	nmea.name = txt.substr(0, comma);	
+	nmea.name.assign(tokens.name);
 	if ( hasNonAlphaNum(nmea.name) ){
 		nmea.isvalid = false;
 		return;
@@ -405,74 +492,74 @@ void NMEAParser::parseText(NMEASentence& nmea, string txt){
 
 
 	//comma is the last character/only comma
-	if (comma + 1 == txt.size()){		
-		nmea.parameters.push_back("");
+	if (tokens.name.size() + 1 == tokens.sentence.size()){
+		addParameter(nmea, "");
 		nmea.isvalid = true;
 		return;	
 	}
 
 
-	//move to data after first comma
-	txt = txt.substr(comma + 1, txt.size() - (comma + 1));
-
 	//parse parameters according to csv
-	istringstream f(txt);
-	string s;
-	while (getline(f, s, ',')) {
-		//cout << s << endl;
-		nmea.parameters.push_back(s);
+	NMEATokenizer::FieldReader fields = tokens.fieldReader();
+	string_view field;
+	while (fields.next(field)) {
+		addParameter(nmea, field);
 	}
 
 
-	//above line parsing does not add a blank parameter if there is a comma at the end...
-	// so do it here.
-	if (*(txt.end() - 1) == ','){
+	//a comma at the end leaves a blank last parameter
+	if (tokens.sentence.back() == ','){
 
 		// supposed to have checksum but there is a comma at the end... invalid
-		if (haschecksum){
+		if (tokens.hasChecksum){
+			nmea.parameters.pop_back();
 			nmea.isvalid = false;
 			return;
 		}
 
 		//cout << "NMEA parser Warning: extra comma at end of sentence, but no information...?" << endl;		// it's actually standard, if checksum is disabled
-		nmea.parameters.push_back("");
 
-		stringstream sz;
-		sz << "Found " << nmea.parameters.size() << " parameters.";
-		onInfo(nmea, sz.str());
+		if (log){
+			stringstream sz;
+			sz << "Found " << nmea.parameters.size() << " parameters.";
+			onInfo(nmea, sz.str());
+		}
 
 	}
 	else
 	{
-		stringstream sz;
-		sz << "Found " << nmea.parameters.size() << " parameters.";
-		onInfo(nmea, sz.str());
+		if (log){
+			stringstream sz;
+			sz << "Found " << nmea.parameters.size() << " parameters.";
+			onInfo(nmea, sz.str());
+		}
 
 		//possible checksum at end...
-		size_t endi = nmea.parameters.size() - 1;
-		size_t checki = nmea.parameters[endi].find_last_of('*');
-		if (checki != string::npos){
-			string last = nmea.parameters[endi];
-			nmea.parameters[endi] = last.substr(0, checki);
-			if (checki == last.size() - 1){
+		if (tokens.checksumSplit){
+			if (tokens.checksum.empty()){
 				onError(nmea, "Checksum '*' character at end, but no data.");
 			}
 			else{
-				nmea.checksum = last.substr(checki + 1, last.size() - checki);		//extract checksum without '*'
+				nmea.checksum.assign(tokens.checksum);		//extract checksum without '*'
 
-				onInfo(nmea, string("Found checksum. (\"*") + nmea.checksum + "\")");
+				if (log){
+					onInfo(nmea, string("Found checksum. (\"*") + nmea.checksum + "\")");
+				}
 
-				try
-				{
-					nmea.parsedChecksum = (uint8_t)parseInt(nmea.checksum, 16);
+				int64_t wide;
+				if (parseHexByte(nmea.checksum, nmea.parsedChecksum)){
+					nmea.checksumIsCalculated = true;
+				}
+				else if (tryParseInt(nmea.checksum, wide, 16)){		// not the usual 2 digits, but still hex
+					nmea.parsedChecksum = (uint8_t)wide;
 					nmea.checksumIsCalculated = true;
 				}
-				catch( NumberConversionError& )
+				else
 				{
-					onError(nmea, string("parseInt() error. Parsed checksum string was not readable as hex. (\"") +  nmea.checksum + "\")");
+					onError(nmea, string("parseInt() error. Parsed checksum string was not readable as hex. (\"") + nmea.checksum + "\")");
 				}
 				
-				onInfo(nmea, string("Checksum ok? ") + (nmea.checksumOK() ? "YES" : "NO") + "!");
+				onInfo(nmea, nmea.checksumOK() ? "Checksum ok? YES!" : "Checksum ok? NO!");
 				
 
 			}
@@ -480,7 +567,8 @@ void NMEAParser::parseText(NMEASentence& nmea, string txt){
 	}
 
 
-	for (size_t i = 0; i < nmea.parameters.size(); i++){
+	// encapsulated sentences ('!') carry armored binary, with any printable character
+	for (size_t i = 0; tokens.start == '$' && i < nmea.parameters.size(); i++){
 		if (!validParamChars(nmea.parameters[i])){
 			nmea.isvalid = false;
 			stringstream ss;
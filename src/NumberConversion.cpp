@@ -9,38 +9,269 @@
 
 #include <nmeaparse/NumberConversion.h>
 #include <cstdlib>
+#include <charconv>
 
 using namespace std;
 
 namespace nmea {
-// Note: both parseDouble and parseInt return 0 with "" input.
 
-		double parseDouble(std::string s){
+namespace {
+	// Powers of ten that are exact in a double.
+	const double ExactPow10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+		1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	// Hex digit values, -1 for anything else.
+	struct HexTable {
+		int8_t value[256]{};
+		constexpr HexTable(){
+			for (int i = 0; i < 256; i++){
+				value[i] = -1;
+			}
+			for (int i = 0; i < 10; i++){
+				value['0' + i] = (int8_t)i;
+			}
+			for (int i = 0; i < 6; i++){
+				value['a' + i] = (int8_t)(10 + i);
+				value['A' + i] = (int8_t)(10 + i);
+			}
+		}
+	};
+	constexpr HexTable Hex;
+
+	inline bool isDigit(char c){
+		return (uint8_t)(c - '0') <= 9;
+	}
+
+	// Two ASCII digits to their value, no validation.
+	inline int32_t twoDigits(const char* p){
+		return (p[0] - '0') * 10 + (p[1] - '0');
+	}
+
+	inline bool sixDigits(const char* p){
+		return isDigit(p[0]) && isDigit(p[1]) && isDigit(p[2]) && isDigit(p[3]) && isDigit(p[4]) && isDigit(p[5]);
+	}
+}
+
+		// NMEA numbers are plain decimals ("-0031.0200"), so decode those directly: the digits
+		// are exact in an integer and a power of ten up to 1e22 is exact in a double, which
+		// makes the single division correctly rounded. Anything else goes through from_chars.
+		bool tryParseDouble(std::string_view s, double& out){
+			const char* p = s.data();
+			const char* end = p + s.size();
+			if (p == end){
+				return false;
+			}
+
+			bool negative = false;
+			if (*p == '-' || *p == '+'){
+				negative = (*p == '-');
+				p++;
+				if (p != end && (*p == '-' || *p == '+')){		// "+-5" would pass from_chars below
+					return false;
+				}
+			}
+
+			uint64_t mantissa = 0;
+			int digits = 0;
+			int decimals = 0;
+			const char* q = p;
+			for (; q != end && isDigit(*q); q++, digits++){
+				mantissa = mantissa * 10 + (*q - '0');
+				if (digits > 18){
+					break;
+				}
+			}
+			if (q != end && *q == '.' && digits <= 18){
+				for (q++; q != end && isDigit(*q); q++, digits++, decimals++){
+					mantissa = mantissa * 10 + (*q - '0');
+					if (digits > 18){
+						break;
+					}
+				}
+			}
+
+			if (q == end && digits > 0 && digits <= 19 && decimals <= 22 && mantissa <= (1ULL << 53)){
+				double d = (double)mantissa / ExactPow10[decimals];
+				out = negative ? -d : d;
+				return true;
+			}
+
+			// exponents, long mantissas... from_chars takes the '-' but not the '+'
+			if (*s.data() == '-'){
+				p = s.data();
+			}
+			double d;
+			auto res = std::from_chars(p, end, d);
+			if (res.ec != std::errc() || res.ptr != end || p == end){
+				return false;
+			}
+			out = d;
+			return true;
+		}
+
+		bool tryParseInt(std::string_view s, int64_t& out, int radix){
+			const char* p = s.data();
+			const char* end = p + s.size();
+			if (p != end && *p == '+'){
+				p++;
+				if (p != end && *p == '-'){			// from_chars would take "+-5" as -5
+					return false;
+				}
+			}
+			if (p == end){
+				return false;
+			}
+
+			int64_t d;
+			auto res = std::from_chars(p, end, d, radix);
+			if (res.ec != std::errc() || res.ptr != end){
+				return false;
+			}
+			out = d;
+			return true;
+		}
+
+		bool parseHexByte(std::string_view s, uint8_t& out){
+			if (s.size() != 2){
+				return false;
+			}
+			int hi = Hex.value[(uint8_t)s[0]];
+			int lo = Hex.value[(uint8_t)s[1]];
+			if ((hi | lo) < 0){
+				return false;
+			}
+			out = (uint8_t)((hi << 4) | lo);
+			return true;
+		}
+
+// Note: both parseDouble and parseInt return 0 with "" input.
 
-			char* p;
-			double d = ::strtod(s.c_str(), &p);
-			if (*p != 0){
+		double parseDouble(std::string_view s){
+			double d = 0;
+			if (!s.empty() && !tryParseDouble(s, d)){
 				std::stringstream ss;
-				ss << "NumberConversionError: parseDouble() error in argument \"" << s << "\", '"
-					<< *p << "' is not a number.";
+				ss << "NumberConversionError: parseDouble() error in argument \"" << s << "\", it is not a number.";
 				throw NumberConversionError(ss.str());
 			}
 			return d;
 		}
-		int64_t parseInt(std::string s, int radix){
-			char* p;
-
-			int64_t d = ::strtoll(s.c_str(), &p, radix);
-
-			if (*p != 0) {
+		int64_t parseInt(std::string_view s, int radix){
+			int64_t d = 0;
+			if (!s.empty() && !tryParseInt(s, d, radix)){
 				std::stringstream ss;
-				ss << "NumberConversionError: parseInt() error in argument \"" << s << "\", '"
-					<< *p << "' is not a number.";
+				ss << "NumberConversionError: parseInt() error in argument \"" << s << "\", it is not a number.";
 				throw NumberConversionError(ss.str());
 			}
 			return d;
 		}
 
+		bool parseTimeOfDay(std::string_view hhmmss, int64_t& nanos){
+			const size_t n = hhmmss.size();
+			const char* p = hhmmss.data();
+			if (n < 6 || !sixDigits(p)){
+				return false;
+			}
+
+			int32_t hh = twoDigits(p);
+			int32_t mm = twoDigits(p + 2);
+			int32_t ss = twoDigits(p + 4);
+			if (hh > 23 || mm > 59 || ss > 60){		// 60 is a leap second
+				return false;
+			}
+
+			int64_t frac = 0;
+			int64_t scale = 1000000000;
+			if (n > 6){
+				if (p[6] != '.'){
+					return false;
+				}
+				for (size_t i = 7; i < n; i++){
+					if (!isDigit(p[i])){
+						return false;
+					}
+					if (scale > 1){
+						scale /= 10;
+						frac += (p[i] - '0') * scale;
+					}
+				}
+			}
+
+			nanos = ((hh * 60 + mm) * 60 + ss) * 1000000000LL + frac;
+			return true;
+		}
+
+		bool parseDate(std::string_view ddmmyy, int32_t& raw){
+			const char* p = ddmmyy.data();
+			if (ddmmyy.size() != 6 || !sixDigits(p)){
+				return false;
+			}
+
+			int32_t dd = twoDigits(p);
+			int32_t mm = twoDigits(p + 2);
+			int32_t yy = twoDigits(p + 4);
+			if (dd < 1 || dd > 31 || mm < 1 || mm > 12){
+				return false;
+			}
+
+			raw = dd * 10000 + mm * 100 + yy;
+			return true;
+		}
+
+		bool parseLatLong(std::string_view ddmm, std::string_view dir, int64_t& nanominutes){
+			const char* p = ddmm.data();
+			const char* end = p + ddmm.size();
+
+			// dddmm -- degrees and whole minutes
+			int64_t whole = 0;
+			const char* start = p;
+			while (p != end && isDigit(*p)){
+				if (p - start == 5){
+					return false;
+				}
+				whole = whole * 10 + (*p - '0');
+				p++;
+			}
+			if (p == start){
+				return false;
+			}
+
+			// .mmmm -- fraction of minutes, scaled to 1e-9
+			int64_t frac = 0;
+			if (p != end){
+				if (*p != '.'){
+					return false;
+				}
+				p++;
+				int64_t scale = 1000000000;
+				for (; p != end; p++){
+					if (!isDigit(*p)){
+						return false;
+					}
+					if (scale > 1){
+						scale /= 10;
+						frac += (*p - '0') * scale;
+					}
+				}
+			}
+
+			int64_t deg = whole / 100;
+			int64_t mins = whole % 100;
+			if (mins >= 60 || deg > 180){
+				return false;
+			}
+
+			int64_t value = (deg * 60 + mins) * 1000000000 + frac;
+
+			//everything should be N/E, so flip S,W
+			if (!dir.empty() && (dir[0] == 'S' || dir[0] == 'W')){
+				value = -value;
+			}
+			nanominutes = value;
+			return true;
+		}
+
 }
 
 /*
@@ -0,0 +1,101 @@
+/*
+ * RatePruner.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/RatePruner.h>
+#include <nmeaparse/NMEACommand.h>
+#include <algorithm>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	// The sentence of each $PSRF103 message number, nullptr for the ones without
+	const char* const TYPE_NAMES[OutputRatePruner::TYPES] = { "GGA", "GLL", "GSA", "GSV", "RMC", "VTG", nullptr, nullptr, "ZDA" };
+
+	bool known(NMEASentence::MessageID id){
+		return id >= 0 && id < OutputRatePruner::TYPES && TYPE_NAMES[id] != nullptr;
+	}
+}
+
+
+
+// ------------- OUTPUT RATE PRUNER ----------------
+
+OutputRatePruner::OutputRatePruner(NMEAParser& _parser, CommandSequencer& _sequencer)
+	: parser(_parser), sequencer(_sequencer)
+{
+	fill(begin(rates), end(rates), 1);
+	fill(begin(device), end(device), -1);
+	subscription = (parser.onHandlersChanged += [this](){
+		this->changed = true;
+	}).getID();
+	// a service registers a dozen handlers in a row: wait for the next sentence to look at them
+	sentenceSubscription = (parser.onSentence += [this](const NMEASentence&){
+		if (this->changed && this->automatic){
+			this->update();
+		}
+	}).getID();
+}
+
+OutputRatePruner::~OutputRatePruner(){
+	parser.onHandlersChanged -= subscription;
+	parser.onSentence -= sentenceSubscription;
+}
+
+void OutputRatePruner::setRate(NMEASentence::MessageID id, int seconds){
+	if (known(id)){
+		rates[id] = min(max(seconds, 1), 255);
+		changed = true;
+	}
+}
+
+void OutputRatePruner::keep(NMEASentence::MessageID id, bool on){
+	if (known(id)){
+		kept[id] = on;
+		changed = true;
+	}
+}
+
+int OutputRatePruner::wantedRate(NMEASentence::MessageID id) const {
+	if (!known(id)){
+		return 0;
+	}
+	if (kept[id]){
+		return rates[id];
+	}
+	for (const string& name : parser.getRegisteredSentenceHandlers(false)){
+		if (name.size() == 5 && name.compare(2, 3, TYPE_NAMES[id]) == 0){		// talker, type
+			return rates[id];
+		}
+	}
+	return 0;
+}
+
+int OutputRatePruner::update(){
+	changed = false;
+	int count = 0;
+	for (int id = 0; id < TYPES; id++){
+		int rate = wantedRate((NMEASentence::MessageID)id);
+		if (!known((NMEASentence::MessageID)id) || rate == device[id]){
+			continue;
+		}
+		NMEACommandQueryRate command;
+		command.messageID = (NMEASentence::MessageID)id;
+		command.mode = NMEACommandQueryRate::SETRATE;
+		command.rate = rate;
+		sequencer.add(command, ack);
+		device[id] = rate;
+		count++;
+	}
+	return count;
+}
+
+void OutputRatePruner::reset(){
+	fill(begin(device), end(device), -1);
+}
@@ -0,0 +1,256 @@
+/*
+ * Replay.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/Replay.h>
+#include <nmeaparse/LogIndex.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <thread>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	const int64_t DAY = 86400LL * 1000000000;
+	const int64_t NO_TIME = numeric_limits<int64_t>::min();
+	const uint64_t COUNT_EVERY = 4096;		// lines between updates of the shared counters
+
+	int64_t steadyNanos(){
+		return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// "1620648000.125 ..." at the start of a line, in nanoseconds.
+	bool parseReceiveTime(string_view line, int64_t& time){
+		size_t i = 0;
+		while (i < line.size() && (line[i] == ' ' || line[i] == '\t')){
+			i++;
+		}
+		int64_t seconds = 0;
+		size_t digits = 0;
+		for (; i < line.size() && line[i] >= '0' && line[i] <= '9' && digits < 12; i++, digits++){
+			seconds = seconds * 10 + (line[i] - '0');
+		}
+		if (digits == 0){
+			return false;
+		}
+		int64_t nanos = 0;
+		if (i < line.size() && line[i] == '.'){
+			int64_t scale = 100000000;
+			for (i++; i < line.size() && line[i] >= '0' && line[i] <= '9'; i++){
+				nanos += (line[i] - '0') * scale;
+				scale /= 10;
+			}
+		}
+		if (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != ',' && line[i] != ';' && line[i] != '$'){
+			return false;
+		}
+		time = seconds * 1000000000 + nanos;
+		return true;
+	}
+}
+
+
+
+// ------------- REPLAY ENGINE ----------------
+
+ReplayEngine::ReplayEngine()
+{}
+
+ReplayEngine::~ReplayEngine()
+{}
+
+bool ReplayEngine::add(const string& logPath, NMEAParser& parser, string* error){
+	Log* log = nullptr;
+	for (auto& l : logs){
+		if (l->path == logPath){
+			log = l.get();
+		}
+	}
+	if (log == nullptr){
+		unique_ptr<Log> l(new Log);
+		if (!l->file.open(logPath)){
+			if (error){
+				*error = "Cannot open " + logPath;
+			}
+			return false;
+		}
+		l->path = logPath;
+		log = l.get();
+		logs.push_back(move(l));
+	}
+
+	unique_ptr<Stream> s(new Stream);
+	s->log = log;
+	s->parser = &parser;
+	streamList.push_back(move(s));
+	return true;
+}
+
+void ReplayEngine::timeLines(Log& log, bool receiveTimes){
+	log.lines.clear();
+	log.receiveTimes = receiveTimes;
+	log.timed = true;
+
+	const char* text = (const char*)log.file.data();
+	size_t size = log.file.size();
+	LogTime sentenceTime;
+	int64_t last = NO_TIME;
+	size_t firstDated = numeric_limits<size_t>::max();
+
+	size_t pos = 0;
+	while (pos < size){
+		const void* nl = memchr(text + pos, '\n', size - pos);
+		size_t end = nl ? (size_t)((const char*)nl - text) : size;
+		size_t next = nl ? end + 1 : size;
+		string_view line(text + pos, end - pos);
+		if (!line.empty() && line.back() == '\r'){
+			line.remove_suffix(1);
+		}
+		if (!line.empty()){
+			if (receiveTimes){
+				parseReceiveTime(line, last);
+			}
+			else {
+				sentenceTime.read(line);
+				if (sentenceTime.timeOfDay >= 0){
+					last = sentenceTime.time();
+				}
+				if (sentenceTime.dayKnown && firstDated > log.lines.size()){
+					firstDated = log.lines.size();
+				}
+			}
+			log.lines.push_back({ pos, (uint32_t)line.size(), last });
+		}
+		pos = next;
+	}
+
+	// the lines before the first date get it, counting the midnights before it
+	if (!receiveTimes && sentenceTime.dayKnown){
+		int64_t shift = (sentenceTime.firstDate - sentenceTime.daysBeforeDate) * DAY;
+		for (size_t i = 0; i < firstDated; i++){
+			if (log.lines[i].time != NO_TIME){
+				log.lines[i].time += shift;
+			}
+		}
+	}
+	// and the lines before the first time get that one
+	int64_t first = 0;
+	for (auto& l : log.lines){
+		if (l.time != NO_TIME){
+			first = l.time;
+			break;
+		}
+	}
+	for (auto& l : log.lines){
+		if (l.time != NO_TIME){
+			break;
+		}
+		l.time = first;
+	}
+}
+
+void ReplayEngine::work(const vector<Stream*>& mine, int64_t start){
+	// streams by the replay time of their next line, since the start
+	typedef pair<int64_t, size_t> Item;
+	priority_queue<Item, vector<Item>, greater<Item>> queue;
+	for (size_t i = 0; i < mine.size(); i++){
+		if (!mine[i]->log->lines.empty()){
+			queue.push({ 0, i });
+		}
+	}
+
+	bool paced = pacing != Pacing::None && speed > 0.;
+	uint64_t lineCount = 0;
+	uint64_t byteCount = 0;
+	while (!queue.empty() && !stopping){
+		Item item = queue.top();
+		queue.pop();
+		if (paced){
+			int64_t wait = start + (int64_t)((double)item.first / speed) - steadyNanos();
+			if (wait > 0){
+				this_thread::sleep_for(chrono::nanoseconds(wait));
+			}
+		}
+
+		Stream& s = *mine[item.second];
+		const vector<Line>& lineList = s.log->lines;
+		const Line& l = lineList[s.next++];
+		s.clock.set(l.time);
+		try {
+			s.parser->readLine(string((const char*)s.log->file.data() + l.offset, l.length));
+		}
+		catch (NMEAParseError&){
+			// not a sentence, skip it
+		}
+
+		byteCount += l.length + 1;
+		if (++lineCount % COUNT_EVERY == 0){
+			lines += COUNT_EVERY;
+			bytes += byteCount;
+			byteCount = 0;
+		}
+		if (s.next < lineList.size()){
+			int64_t pause = max((int64_t)0, min(lineList[s.next].time - l.time, maxGap));
+			queue.push({ item.first + pause, item.second });
+		}
+	}
+	lines += lineCount % COUNT_EVERY;
+	bytes += byteCount;
+}
+
+void ReplayEngine::run(){
+	stopping = false;
+	lines = 0;
+	bytes = 0;
+
+	bool receiveTimes = pacing == Pacing::ReceiveTime;
+	for (auto& log : logs){
+		if (!log->timed || log->receiveTimes != receiveTimes){
+			timeLines(*log, receiveTimes);
+		}
+	}
+	for (auto& s : streamList){
+		s->next = 0;
+		s->clock.set(s->log->lines.empty() ? 0 : s->log->lines[0].time);
+	}
+	if (streamList.empty()){
+		return;
+	}
+
+	size_t n = threads;
+	if (n == 0){
+		n = max(1u, thread::hardware_concurrency());
+	}
+	n = min(n, streamList.size());
+	vector<vector<Stream*>> assigned(n);
+	for (size_t i = 0; i < streamList.size(); i++){
+		assigned[i % n].push_back(streamList[i].get());
+	}
+
+	int64_t start = steadyNanos();
+	if (n == 1){
+		work(assigned[0], start);
+		return;
+	}
+	vector<thread> workers;
+	for (size_t i = 0; i < n; i++){
+		workers.emplace_back(&ReplayEngine::work, this, cref(assigned[i]), start);
+	}
+	for (auto& w : workers){
+		w.join();
+	}
+}
+
+void ReplayEngine::stop(){
+	stopping = true;
+}
@@ -0,0 +1,352 @@
+/*
+ * SchemaRegistry.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/SchemaRegistry.h>
+#include <nmeaparse/NumberConversion.h>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace nmea;
+
+
+namespace {
+	struct TypeName {
+		const char* name;
+		FieldType type;
+	};
+	const TypeName TypeNames[] = {
+		{ "skip",		FieldType::Skip },
+		{ "int",		FieldType::Int },
+		{ "double",		FieldType::Double },
+		{ "char",		FieldType::Char },
+		{ "text",		FieldType::Text },
+		{ "time",		FieldType::Time },
+		{ "date",		FieldType::Date },
+		{ "latlong",	FieldType::LatLong }
+	};
+
+	size_t parameterWidth(FieldType type){
+		return (type == FieldType::LatLong) ? 2 : 1;
+	}
+}
+
+
+
+// --------- SENTENCE LAYOUT --------------
+
+size_t SentenceLayout::arity() const {
+	size_t n = subId.empty() ? 0 : 1;
+	for (const auto& f : fields){
+		n += parameterWidth(f.type);
+	}
+	return n;
+}
+
+size_t SentenceLayout::fieldIndex(std::string_view fieldName) const {
+	for (size_t i = 0; i < fields.size(); i++){
+		if (fields[i].name == fieldName){
+			return i;
+		}
+	}
+	return fields.size();
+}
+
+string SentenceLayout::key() const {
+	return subId.empty() ? name : name + "," + subId;
+}
+
+
+
+// --------- SCHEMA COLUMNS --------------
+
+SchemaColumns::SchemaColumns(const SentenceLayout* l)
+	: layout(l)
+	, values(l->fields.size())
+	, texts(l->fields.size())
+{}
+
+void SchemaColumns::append(const SchemaRecord& record){
+	for (size_t i = 0; i < values.size(); i++){
+		values[i].push_back(record.values[i]);
+		if (layout->fields[i].type == FieldType::Text){
+			texts[i].emplace_back(record.texts[i]);
+		}
+	}
+	valid.push_back(record.valid);
+}
+
+void SchemaColumns::clear(){
+	for (size_t i = 0; i < values.size(); i++){
+		values[i].clear();
+		texts[i].clear();
+	}
+	valid.clear();
+}
+
+
+
+// --------- SCHEMA REGISTRY --------------
+
+SchemaRegistry::SchemaRegistry()
+	: sentenceHandler([](const NMEASentence&){})
+{}
+
+SchemaRegistry::~SchemaRegistry(){
+	detach();
+}
+
+bool SchemaRegistry::parseFieldType(std::string_view text, FieldType& type){
+	for (const auto& t : TypeNames){
+		if (text == t.name){
+			type = t.type;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool SchemaRegistry::add(SentenceLayout layout){
+	if (layout.fields.size() > 64 || layout.name.empty()){
+		return false;
+	}
+
+	size_t parameter = layout.subId.empty() ? 0 : 1;
+	for (auto& f : layout.fields){
+		f.parameter = parameter;
+		parameter += parameterWidth(f.type);
+	}
+
+	Family& family = families[layout.name];
+	SentenceLayout* existing = layout.subId.empty() ? family.plain : nullptr;
+	if (!layout.subId.empty()){
+		auto it = family.bySubId.find(layout.subId);
+		if (it != family.bySubId.end()){
+			existing = it->second;
+		}
+	}
+
+	// Replace in place so pointers held by records and columns stay valid.
+	if (existing){
+		*existing = std::move(layout);
+		return true;
+	}
+
+	layouts.emplace_back(new SentenceLayout(std::move(layout)));
+	SentenceLayout* added = layouts.back().get();
+	if (added->subId.empty()){
+		family.plain = added;
+	}
+	else {
+		family.bySubId[added->subId] = added;
+	}
+	return true;
+}
+
+bool SchemaRegistry::load(std::istream& config, std::string* error){
+	string line;
+	size_t lineNumber = 0;
+	while (getline(config, line)){
+		lineNumber++;
+
+		size_t hash = line.find('#');
+		if (hash != string::npos){
+			line.resize(hash);
+		}
+
+		istringstream words(line);
+		string key;
+		if (!(words >> key)){
+			continue;		// blank or comment
+		}
+
+		SentenceLayout layout;
+		size_t comma = key.find(',');
+		layout.name = key.substr(0, comma);
+		if (comma != string::npos){
+			layout.subId = key.substr(comma + 1);
+		}
+
+		bool ok = !layout.name.empty();
+		string word;
+		while (ok && (words >> word)){
+			SentenceLayout::FieldSpec f;
+			size_t colon = word.find(':');
+			string type = word;
+			if (colon != string::npos){
+				f.name = word.substr(0, colon);
+				type = word.substr(colon + 1);
+			}
+			ok = parseFieldType(type, f.type);
+			f.parameter = 0;
+			layout.fields.push_back(f);
+		}
+
+		if (!ok || !add(std::move(layout))){
+			if (error){
+				stringstream ss;
+				ss << "Schema config line " << lineNumber << " is malformed: \"" << line << "\"";
+				*error = ss.str();
+			}
+			return false;
+		}
+	}
+	return true;
+}
+
+bool SchemaRegistry::loadFile(const std::string& path, std::string* error){
+	ifstream file(path);
+	if (!file){
+		if (error){
+			*error = "Could not open schema config \"" + path + "\"";
+		}
+		return false;
+	}
+	return load(file, error);
+}
+
+const SentenceLayout* SchemaRegistry::find(std::string_view name, std::string_view subId) const {
+	auto it = families.find(name);
+	if (it == families.end()){
+		return nullptr;
+	}
+	const Family& family = it->second;
+	if (!subId.empty() && !family.bySubId.empty()){
+		auto sub = family.bySubId.find(subId);
+		if (sub != family.bySubId.end()){
+			return sub->second;
+		}
+	}
+	return family.plain;
+}
+
+const SentenceLayout* SchemaRegistry::find(const NMEASentence& nmea) const {
+	std::string_view subId;
+	if (!nmea.parameters.empty()){
+		subId = nmea.parameters[0];
+	}
+	return find(nmea.name, subId);
+}
+
+vector<string> SchemaRegistry::keys() const {
+	vector<string> k;
+	for (const auto& l : layouts){
+		k.push_back(l->key());
+	}
+	return k;
+}
+
+DecodeStatus SchemaRegistry::decode(const NMEASentence& nmea, SchemaRecord& record) const {
+	const SentenceLayout* layout = find(nmea);
+	if (!layout){
+		record.layout = nullptr;
+		record.status = DecodeStatus::UnknownSentence;
+		record.valid = 0;
+		record.malformed = 0;
+		return record.status;
+	}
+	return decode(*layout, nmea, record);
+}
+
+DecodeStatus SchemaRegistry::decode(const SentenceLayout& layout, const NMEASentence& nmea, SchemaRecord& record){
+	const size_t count = layout.fields.size();
+	record.layout = &layout;
+	record.valid = 0;
+	record.malformed = 0;
+	record.values.assign(count, SchemaRecord::Value{0});
+	record.texts.assign(count, std::string_view());
+
+	if (nmea.checksumIsCalculated && !nmea.checksumOK()){
+		record.status = DecodeStatus::BadChecksum;
+		return record.status;
+	}
+
+	const size_t size = nmea.parameters.size();
+	for (size_t i = 0; i < count; i++){
+		const SentenceLayout::FieldSpec& f = layout.fields[i];
+		if (f.parameter + parameterWidth(f.type) > size){
+			break;		// short sentence, the rest is absent
+		}
+
+		std::string_view text = nmea.parameters[f.parameter];
+		record.texts[i] = text;
+		if (text.empty() || f.type == FieldType::Skip){
+			continue;
+		}
+
+		SchemaRecord::Value& v = record.values[i];
+		bool ok = true;
+		switch (f.type){
+		case FieldType::Int:
+			ok = tryParseInt(text, v.i);
+			break;
+		case FieldType::Double:
+			ok = tryParseDouble(text, v.d);
+			break;
+		case FieldType::Char:
+			v.i = text[0];
+			break;
+		case FieldType::Time:
+			ok = parseTimeOfDay(text, v.i);
+			break;
+		case FieldType::Date: {
+			int32_t raw;
+			ok = parseDate(text, raw);
+			v.i = raw;
+			break;
+		}
+		case FieldType::LatLong:
+			ok = parseLatLong(text, nmea.parameters[f.parameter + 1], v.i);
+			break;
+		default:
+			break;
+		}
+
+		if (ok){
+			record.valid |= (1ULL << i);
+		}
+		else {
+			record.malformed |= (1ULL << i);
+		}
+	}
+
+	if (record.malformed){
+		record.status = DecodeStatus::MalformedField;
+	}
+	else if (size < layout.arity()){
+		record.status = DecodeStatus::MissingParameters;
+	}
+	else {
+		record.status = DecodeStatus::OK;
+	}
+	return record.status;
+}
+
+void SchemaRegistry::onSentence(const NMEASentence& nmea){
+	const SentenceLayout* layout = find(nmea);
+	if (layout == nullptr){
+		return;		// someone else's sentence
+	}
+	decode(*layout, nmea, current);
+	onRecord(current);
+}
+
+void SchemaRegistry::attachToParser(NMEAParser& p){
+	detach();
+	parser = &p;
+	sentenceHandler = p.onSentence += [this](const NMEASentence& nmea){
+		this->onSentence(nmea);
+	};
+}
+
+void SchemaRegistry::detach(){
+	if (parser != nullptr){
+		parser->onSentence.removeHandler(sentenceHandler);
+		parser = nullptr;
+	}
+}
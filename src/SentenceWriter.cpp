@@ -0,0 +1,316 @@
+/*
+ * SentenceWriter.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/SentenceWriter.h>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	const int64_t DAY = 86400LL * 1000000000;
+	const double KMH_PER_KNOT = 1.852;
+	const double LARGEST = 999999.;		// bigger values are clamped, which keeps sentences under MAX_LENGTH
+	const uint64_t MAX_ANGLE = 180ULL * 60 * 1000000000;		// 1e-9 arc minutes
+	const char HEX[] = "0123456789ABCDEF";
+
+	const uint64_t POW10[10] = {
+		1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL
+	};
+
+	// Unchecked writing, into room for MAX_LENGTH characters
+	struct Cursor {
+		char* start;
+		char* p;
+
+		explicit Cursor(char* buffer) : start(buffer), p(buffer) {}
+
+		void put(char c)		{ *p++ = c; }
+		void put(const char* s, size_t n){
+			memcpy(p, s, n);
+			p += n;
+		}
+
+		// at least minDigits digits, padded with '0'
+		void number(uint64_t v, unsigned minDigits = 1){
+			char digits[20];
+			unsigned n = 0;
+			do {
+				digits[n++] = (char)('0' + v % 10);
+				v /= 10;
+			} while (v > 0);
+			for (; n < minDigits; n++){
+				digits[n] = '0';
+			}
+			while (n > 0){
+				*p++ = digits[--n];
+			}
+		}
+
+		void fixed(double v, unsigned decimals){
+			if (!(v == v)){
+				v = 0.;
+			}
+			v = v < -LARGEST ? -LARGEST : (v > LARGEST ? LARGEST : v);
+			int64_t scaled = llround(v * (double)POW10[decimals]);
+			if (scaled < 0){
+				put('-');
+				scaled = -scaled;
+			}
+			number((uint64_t)scaled / POW10[decimals]);
+			if (decimals > 0){
+				put('.');
+				number((uint64_t)scaled % POW10[decimals], decimals);
+			}
+		}
+
+		// hhmmss.sss, truncated
+		void time(int64_t utc, unsigned decimals){
+			int64_t nanos = (utc % DAY + DAY) % DAY;
+			uint64_t units = (uint64_t)nanos / POW10[9 - decimals];
+			uint64_t seconds = units / POW10[decimals];
+			number(seconds / 3600, 2);
+			number(seconds / 60 % 60, 2);
+			number(seconds % 60, 2);
+			if (decimals > 0){
+				put('.');
+				number(units % POW10[decimals], decimals);
+			}
+		}
+
+		// ddmmyy
+		void date(int64_t utc){
+			int64_t days = utc / DAY - (utc % DAY < 0);
+			int64_t y;
+			uint32_t m, d;
+			GPSTimestamp::civilFromDays(days, y, m, d);
+			number(d, 2);
+			number(m, 2);
+			number((uint64_t)((y % 100 + 100) % 100), 2);
+		}
+
+		// ddmm.mmmm,N from 1e-9 arc minutes, rounded
+		void angle(int64_t nanominutes, unsigned degreeDigits, unsigned decimals, char positive, char negative){
+			uint64_t magnitude = nanominutes < 0 ? 0 - (uint64_t)nanominutes : (uint64_t)nanominutes;
+			if (magnitude > MAX_ANGLE){
+				magnitude = MAX_ANGLE;
+			}
+			uint64_t divisor = POW10[9 - decimals];
+			uint64_t units = (magnitude + divisor / 2) / divisor;
+			uint64_t perMinute = POW10[decimals];
+			uint64_t minutes = units / perMinute;
+			number(minutes / 60, degreeDigits);
+			number(minutes % 60, 2);
+			if (decimals > 0){
+				put('.');
+				number(units % perMinute, decimals);
+			}
+			put(',');
+			put(nanominutes < 0 ? negative : positive);
+		}
+
+		void header(const char talker[2], const char* type){
+			put('$');
+			put(talker, 2);
+			put(type, 3);
+		}
+
+		// "*hh" and the line end, returns the length
+		size_t finish(bool crlf){
+			uint8_t x = 0;
+			for (const char* c = start + 1; c < p; c++){
+				x ^= (uint8_t)*c;
+			}
+			put('*');
+			put(HEX[x >> 4]);
+			put(HEX[x & 0xF]);
+			if (crlf){
+				put('\r');
+			}
+			put('\n');
+			return p - start;
+		}
+	};
+
+	// Writes straight into big enough buffers, through a scratch one otherwise.
+	template<class Write>
+	size_t writeSentence(char* buffer, size_t size, Write write){
+		if (size >= SentenceWriter::MAX_LENGTH){
+			Cursor out(buffer);
+			return write(out);
+		}
+		char scratch[SentenceWriter::MAX_LENGTH];
+		Cursor out(scratch);
+		size_t length = write(out);
+		if (length > size){
+			return 0;
+		}
+		memcpy(buffer, scratch, length);
+		return length;
+	}
+
+	unsigned clampDecimals(unsigned d){
+		return d > 9 ? 9 : d;
+	}
+}
+
+
+
+// ------------- SENTENCE WRITER ----------------
+
+size_t SentenceWriter::writeGGA(const FixRecord& fix, char* buffer, size_t size) const {
+	return writeSentence(buffer, size, [&](Cursor& out){
+		out.header(talker, "GGA");
+		out.put(',');
+		out.time(fix.time, clampDecimals(timeDecimals));
+		out.put(',');
+		out.angle(fix.latitude, 2, clampDecimals(minuteDecimals), 'N', 'S');
+		out.put(',');
+		out.angle(fix.longitude, 3, clampDecimals(minuteDecimals), 'E', 'W');
+		out.put(',');
+		out.number(fix.quality);
+		out.put(',');
+		out.number(fix.satellites, 2);
+		out.put(',');
+		out.fixed(fix.horizontalDilution, 2);
+		out.put(',');
+		out.fixed(fix.altitude, 1);
+		out.put(",M,", 3);
+		out.fixed(geoidSeparation, 1);
+		out.put(",M,,", 4);
+		return out.finish(crlf);
+	});
+}
+
+size_t SentenceWriter::writeRMC(const FixRecord& fix, char* buffer, size_t size) const {
+	return writeSentence(buffer, size, [&](Cursor& out){
+		out.header(talker, "RMC");
+		out.put(',');
+		out.time(fix.time, clampDecimals(timeDecimals));
+		out.put(',');
+		out.put(fix.status == 'A' ? 'A' : 'V');
+		out.put(',');
+		out.angle(fix.latitude, 2, clampDecimals(minuteDecimals), 'N', 'S');
+		out.put(',');
+		out.angle(fix.longitude, 3, clampDecimals(minuteDecimals), 'E', 'W');
+		out.put(',');
+		out.fixed(fix.speed / KMH_PER_KNOT, 2);
+		out.put(',');
+		out.fixed(fix.travelAngle, 2);
+		out.put(',');
+		out.date(fix.time);
+		out.put(",,,", 3);
+		out.put(fix.status == 'A' ? 'A' : 'N');
+		return out.finish(crlf);
+	});
+}
+
+size_t SentenceWriter::writeVTG(const FixRecord& fix, char* buffer, size_t size) const {
+	return writeSentence(buffer, size, [&](Cursor& out){
+		out.header(talker, "VTG");
+		out.put(',');
+		out.fixed(fix.travelAngle, 2);
+		out.put(",T,,M,", 6);
+		out.fixed(fix.speed / KMH_PER_KNOT, 2);
+		out.put(",N,", 3);
+		out.fixed(fix.speed, 2);
+		out.put(",K,", 3);
+		out.put(fix.status == 'A' ? 'A' : 'N');
+		return out.finish(crlf);
+	});
+}
+
+size_t SentenceWriter::writeHDT(const FixRecord& fix, char* buffer, size_t size) const {
+	return writeSentence(buffer, size, [&](Cursor& out){
+		out.header(talker, "HDT");
+		out.put(',');
+		out.fixed(fix.heading, 2);
+		out.put(",T", 2);
+		return out.finish(crlf);
+	});
+}
+
+size_t SentenceWriter::writeGSA(const uint32_t* prns, size_t count, uint8_t type, double pdop, double hdop, double vdop,
+	char* buffer, size_t size) const
+{
+	return writeSentence(buffer, size, [&](Cursor& out){
+		out.header(talker, "GSA");
+		out.put(",A,", 3);
+		out.number(type < 1 || type > 3 ? 1 : type);
+		for (size_t i = 0; i < 12; i++){
+			out.put(',');
+			if (i < count){
+				out.number(prns[i] % 1000, 2);
+			}
+		}
+		out.put(',');
+		out.fixed(pdop, 2);
+		out.put(',');
+		out.fixed(hdop, 2);
+		out.put(',');
+		out.fixed(vdop, 2);
+		return out.finish(crlf);
+	});
+}
+
+size_t SentenceWriter::writeGSV(const GPSSatellite* satellites, size_t count, char* buffer, size_t size) const {
+	size_t pages = count == 0 ? 1 : (count + 3) / 4;
+	if (pages > 9){
+		pages = 9;			// the page fields have one digit
+		count = 36;
+	}
+	size_t total = 0;
+	for (size_t page = 0; page < pages; page++){
+		size_t length = writeSentence(buffer + total, size - total, [&](Cursor& out){
+			out.header(talker, "GSV");
+			out.put(',');
+			out.number(pages);
+			out.put(',');
+			out.number(page + 1);
+			out.put(',');
+			out.number(count, 2);
+			for (size_t i = page * 4; i < count && i < page * 4 + 4; i++){
+				const GPSSatellite& s = satellites[i];
+				out.put(',');
+				out.number(s.prn % 1000, 2);
+				out.put(',');
+				out.number((uint64_t)llround(s.elevation < 0 ? 0. : (s.elevation > 90. ? 90. : s.elevation)), 2);
+				out.put(',');
+				out.number((uint64_t)llround(s.azimuth < 0 ? 0. : (s.azimuth > 359. ? 359. : s.azimuth)), 3);
+				out.put(',');
+				if (s.snr > 0){
+					out.number((uint64_t)llround(s.snr > 99. ? 99. : s.snr), 2);
+				}
+			}
+			return out.finish(crlf);
+		});
+		if (length == 0){
+			return 0;
+		}
+		total += length;
+	}
+	return total;
+}
+
+size_t SentenceWriter::writeGSA(const GPSFix& fix, char* buffer, size_t size) const {
+	uint32_t prns[12];
+	size_t count = 0;
+	size_t tracked = fix.trackingSatellites < 0 ? 0 : (size_t)fix.trackingSatellites;
+	for (const GPSSatellite& s : fix.almanac.satellites){
+		if (count < 12 && count < tracked && s.snr > 0){
+			prns[count++] = s.prn;
+		}
+	}
+	return writeGSA(prns, count, fix.type, fix.dilution, fix.horizontalDilution, fix.verticalDilution, buffer, size);
+}
+
+size_t SentenceWriter::writeGSV(const GPSFix& fix, char* buffer, size_t size) const {
+	return writeGSV(fix.almanac.satellites.data(), fix.almanac.satellites.size(), buffer, size);
+}
@@ -0,0 +1,191 @@
+/*
+ * SiRF.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/SiRF.h>
+#include <cstring>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	const uint8_t START1 = 0xA0;
+	const uint8_t START2 = 0xA2;
+	const uint8_t END1 = 0xB0;
+	const uint8_t END2 = 0xB3;
+	const uint8_t MID_TRACKER_DATA = 4;
+	const uint8_t MID_GEODETIC_NAV = 41;
+	const size_t CHANNEL_SIZE = 15;
+
+	uint16_t u16(const uint8_t* p)		{ return (uint16_t)(p[0] << 8 | p[1]); }
+	uint32_t u32(const uint8_t* p)		{ return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | (uint32_t)p[3]; }
+	int16_t i16(const uint8_t* p)		{ return (int16_t)u16(p); }
+	int32_t i32(const uint8_t* p)		{ return (int32_t)u32(p); }
+}
+
+
+
+// ------------- SIRF CHANNEL ----------------
+
+double SiRFChannel::averageCN0() const {
+	unsigned sum = 0;
+	for (uint8_t c : cn0){
+		sum += c;
+	}
+	return sum / 10.;
+}
+
+
+
+// ------------- SIRF DECODER ----------------
+
+SiRFDecoder::SiRFDecoder(){
+	frame.reserve(256);
+}
+
+SiRFDecoder::~SiRFDecoder(){
+}
+
+void SiRFDecoder::readByte(uint8_t b){
+	size_t n = frame.size();
+	if (n == 0){
+		if (b == START1){
+			frame.push_back(b);
+		}
+		return;
+	}
+	if (n == 1 && b != START2){
+		if (b != START1){
+			frame.clear();
+		}
+		return;
+	}
+	frame.push_back(b);
+	if (frame.size() == 4){
+		size_t length = u16(&frame[2]) & 0x7FFF;
+		if (length > MAX_PAYLOAD){
+			errors++;
+			frame.clear();
+			return;
+		}
+		expected = length + OVERHEAD;
+	}
+	if (frame.size() >= 4 && frame.size() == expected){
+		readFrame(frame.data(), frame.size());
+		frame.clear();
+	}
+}
+
+void SiRFDecoder::readBuffer(const uint8_t* data, size_t size){
+	for (size_t i = 0; i < size; i++){
+		readByte(data[i]);
+	}
+}
+
+bool SiRFDecoder::readFrame(const uint8_t* data, size_t size){
+	if (size < OVERHEAD + 1 || data[0] != START1 || data[1] != START2 || (u16(data + 2) & 0x7FFF) != size - OVERHEAD
+		|| data[size - 2] != END1 || data[size - 1] != END2
+		|| checksum(data + 4, size - OVERHEAD) != (u16(data + size - 4) & 0x7FFF))
+	{
+		errors++;
+		return false;
+	}
+	frames++;
+
+	const uint8_t* payload = data + 4;
+	size_t length = size - OVERHEAD;
+	onMessage(payload[0], payload, length);
+	if (payload[0] == MID_GEODETIC_NAV && decodeGeodeticNav(payload, length, nav)){
+		onGeodeticNav(nav);
+	}
+	else if (payload[0] == MID_TRACKER_DATA && decodeTrackerData(payload, length, tracker)){
+		onTrackerData(tracker);
+	}
+	return true;
+}
+
+uint16_t SiRFDecoder::checksum(const uint8_t* payload, size_t size){
+	uint32_t sum = 0;
+	for (size_t i = 0; i < size; i++){
+		sum += payload[i];
+	}
+	return (uint16_t)(sum & 0x7FFF);
+}
+
+size_t SiRFDecoder::encodeFrame(const uint8_t* payload, size_t size, uint8_t* buffer, size_t capacity){
+	if (size == 0 || size > 0x7FFF || capacity < size + OVERHEAD){
+		return 0;
+	}
+	uint16_t ck = checksum(payload, size);
+	buffer[0] = START1;
+	buffer[1] = START2;
+	buffer[2] = (uint8_t)(size >> 8);
+	buffer[3] = (uint8_t)size;
+	memcpy(buffer + 4, payload, size);
+	buffer[size + 4] = (uint8_t)(ck >> 8);
+	buffer[size + 5] = (uint8_t)ck;
+	buffer[size + 6] = END1;
+	buffer[size + 7] = END2;
+	return size + OVERHEAD;
+}
+
+bool SiRFDecoder::decodeGeodeticNav(const uint8_t* p, size_t size, SiRFGeodeticNav& nav){
+	if (size < 91 || p[0] != MID_GEODETIC_NAV){
+		return false;
+	}
+	nav.navValid = u16(p + 1);
+	nav.navType = u16(p + 3);
+	nav.week = u16(p + 5);
+	nav.tow = u32(p + 7);
+	nav.year = u16(p + 11);
+	nav.month = p[13];
+	nav.day = p[14];
+	nav.hour = p[15];
+	nav.minute = p[16];
+	nav.second = u16(p + 17);
+	nav.satellites = u32(p + 19);
+	nav.latitude = i32(p + 23);
+	nav.longitude = i32(p + 27);
+	nav.altitudeEllipsoid = i32(p + 31);
+	nav.altitudeMSL = i32(p + 35);
+	nav.datum = (int8_t)p[39];
+	nav.speed = u16(p + 40);
+	nav.course = u16(p + 42);
+	nav.climbRate = i16(p + 46);
+	nav.ehpe = u32(p + 50);
+	nav.evpe = u32(p + 54);
+	nav.ehve = u16(p + 62);
+	nav.headingError = u16(p + 86);
+	nav.svCount = p[88];
+	nav.hdop = p[89];
+	nav.modeInfo = p[90];
+	return true;
+}
+
+bool SiRFDecoder::decodeTrackerData(const uint8_t* p, size_t size, SiRFTrackerData& tracker){
+	if (size < 8 || p[0] != MID_TRACKER_DATA || size < 8 + CHANNEL_SIZE * (size_t)p[7]){
+		return false;
+	}
+	tracker.week = i16(p + 1);
+	tracker.tow = u32(p + 3);
+	tracker.channels.clear();
+	for (size_t i = 0; i < p[7]; i++){
+		const uint8_t* c = p + 8 + CHANNEL_SIZE * i;
+		if (c[0] == 0){
+			continue;		// idle
+		}
+		SiRFChannel channel;
+		channel.svId = c[0];
+		channel.azimuth = c[1] * 1.5;		// sent as 2/3 degrees
+		channel.elevation = c[2] / 2.;		// ...and half degrees
+		channel.state = u16(c + 3);
+		memcpy(channel.cn0, c + 5, 10);
+		tracker.channels.push_back(channel);
+	}
+	return true;
+}
@@ -0,0 +1,315 @@
+/*
+ * SpatialIndex.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/SpatialIndex.h>
+#include <nmeaparse/NumberConversion.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	const int64_t NANOMINUTES_PER_DEGREE = 60LL * 1000000000;
+	const uint32_t MAX_LEVEL = 26;
+
+	const char MAGIC[4] = { 'N', 'M', 'T', 'S' };
+	const uint16_t VERSION = 1;
+	const size_t HEADER_SIZE = 32;
+	const size_t ENTRY_SIZE = 24;
+
+	bool before(const SpatialIndex::Entry& a, const SpatialIndex::Entry& b){
+		if (a.window != b.window){
+			return a.window < b.window;
+		}
+		if (a.cell != b.cell){
+			return a.cell < b.cell;
+		}
+		return a.block < b.block;
+	}
+
+	bool same(const SpatialIndex::Entry& a, const SpatialIndex::Entry& b){
+		return a.window == b.window && a.cell == b.cell && a.block == b.block;
+	}
+
+	// Spreads the 32 bits of v to the even bits of the result.
+	uint64_t spread(uint32_t v){
+		uint64_t x = v;
+		x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+		x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+		x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+		x = (x | (x << 2)) & 0x3333333333333333ULL;
+		x = (x | (x << 1)) & 0x5555555555555555ULL;
+		return x;
+	}
+
+	uint32_t compact(uint64_t x){
+		x &= 0x5555555555555555ULL;
+		x = (x | (x >> 1)) & 0x3333333333333333ULL;
+		x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+		x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+		x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+		x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+		return (uint32_t)x;
+	}
+
+	uint32_t cellOf(double fraction, uint32_t level){
+		double n = (double)(1u << level);
+		double c = fraction * n;
+		if (!(c >= 0.)){		// also NaN
+			return 0;
+		}
+		return c >= n ? (1u << level) - 1 : (uint32_t)c;
+	}
+
+	int64_t windowOf(int64_t time, int64_t window){
+		int64_t w = time / window;
+		if (time % window < 0){
+			w--;
+		}
+		return w * window;
+	}
+
+	// Longitude ranges of a box, split at the 180th meridian.
+	vector<pair<double, double>> longitudeRanges(const BoundingBox& box){
+		if (box.west <= box.east){
+			return { { box.west, box.east } };
+		}
+		return { { box.west, 180. }, { -180., box.east } };
+	}
+
+	bool inside(const BoundingBox& box, const FixRecord& fix){
+		double lat = nanoMinutesToDegrees(fix.latitude);
+		double lon = nanoMinutesToDegrees(fix.longitude);
+		if (lat < box.south || lat > box.north){
+			return false;
+		}
+		if (box.west <= box.east){
+			return lon >= box.west && lon <= box.east;
+		}
+		return lon >= box.west || lon <= box.east;
+	}
+
+	void putLE(string& s, uint64_t v, size_t n){
+		for (size_t i = 0; i < n; i++){
+			s.push_back((char)((v >> (8 * i)) & 0xFF));
+		}
+	}
+
+	uint64_t getLE(const uint8_t* p, size_t n){
+		uint64_t v = 0;
+		for (size_t i = 0; i < n; i++){
+			v |= (uint64_t)p[i] << (8 * i);
+		}
+		return v;
+	}
+}
+
+
+
+// ------------- SPATIAL INDEX ----------------
+
+uint32_t SpatialIndex::column(int64_t longitude, uint32_t level){
+	return cellOf((double)(longitude + 180 * NANOMINUTES_PER_DEGREE) / (360. * NANOMINUTES_PER_DEGREE), level);
+}
+
+uint32_t SpatialIndex::row(int64_t latitude, uint32_t level){
+	return cellOf((double)(latitude + 90 * NANOMINUTES_PER_DEGREE) / (180. * NANOMINUTES_PER_DEGREE), level);
+}
+
+uint64_t SpatialIndex::morton(uint32_t column, uint32_t row){
+	return spread(column) | (spread(row) << 1);
+}
+
+void SpatialIndex::build(const ArchiveReader& archive, uint32_t l, int64_t w, unsigned threads){
+	level = max(1u, min(l, MAX_LEVEL));
+	window = max(w, (int64_t)1);
+	blockCount = (uint32_t)archive.blocks().size();
+	entries.clear();
+
+	if (threads == 0){
+		threads = max(1u, thread::hardware_concurrency());
+	}
+	size_t n = max((size_t)1, min((size_t)threads, (size_t)blockCount));
+	vector<vector<Entry>> found(n);
+
+	// each thread indexes a run of blocks
+	auto work = [&](size_t t){
+		vector<Entry>& out = found[t];
+		uint32_t begin = (uint32_t)((uint64_t)blockCount * t / n);
+		uint32_t end = (uint32_t)((uint64_t)blockCount * (t + 1) / n);
+		for (uint32_t b = begin; b < end; b++){
+			size_t start = out.size();
+			Entry last{ 0, 0, b };
+			bool any = false;
+			archive.readBlock(b, [&](const FixRecord& fix){
+				Entry e{ windowOf(fix.time, window), morton(column(fix.longitude, level), row(fix.latitude, level)), b };
+				if (!any || !same(e, last)){		// fixes in a row are mostly in the same cell
+					out.push_back(e);
+					last = e;
+					any = true;
+				}
+			});
+			sort(out.begin() + start, out.end(), before);
+			out.erase(unique(out.begin() + start, out.end(), same), out.end());
+		}
+	};
+	if (n == 1){
+		work(0);
+	}
+	else {
+		vector<thread> workers;
+		for (size_t t = 0; t < n; t++){
+			workers.emplace_back(work, t);
+		}
+		for (auto& worker : workers){
+			worker.join();
+		}
+	}
+
+	size_t total = 0;
+	for (auto& f : found){
+		total += f.size();
+	}
+	entries.reserve(total);
+	for (auto& f : found){
+		entries.insert(entries.end(), f.begin(), f.end());
+		vector<Entry>().swap(f);
+	}
+	sort(entries.begin(), entries.end(), before);
+}
+
+bool SpatialIndex::save(const string& path, string* error) const {
+	string s(MAGIC, sizeof(MAGIC));
+	putLE(s, VERSION, 2);
+	putLE(s, level, 2);
+	putLE(s, (uint64_t)window, 8);
+	putLE(s, blockCount, 4);
+	putLE(s, 0, 4);
+	putLE(s, entries.size(), 8);
+	s.reserve(HEADER_SIZE + entries.size() * ENTRY_SIZE);
+	for (auto& e : entries){
+		putLE(s, (uint64_t)e.window, 8);
+		putLE(s, e.cell, 8);
+		putLE(s, e.block, 4);
+		putLE(s, 0, 4);
+	}
+
+	ofstream f(path, ios::binary | ios::trunc);
+	f.write(s.data(), s.size());
+	if (!f.good()){
+		if (error){
+			*error = "Cannot write " + path;
+		}
+		return false;
+	}
+	return true;
+}
+
+bool SpatialIndex::load(const string& path, string* error){
+	MappedFile file;
+	const char* bad = nullptr;
+	if (!file.open(path)){
+		bad = "Cannot open ";
+	}
+	const uint8_t* p = file.data();
+	size_t size = file.size();
+	if (!bad && (size < HEADER_SIZE || memcmp(p, MAGIC, sizeof(MAGIC)) != 0 || getLE(p + 4, 2) != VERSION)){
+		bad = "Not a spatial index: ";
+	}
+	uint64_t count = bad ? 0 : getLE(p + 24, 8);
+	if (!bad && (size - HEADER_SIZE) / ENTRY_SIZE < count){
+		bad = "Truncated spatial index: ";
+	}
+	uint32_t l = bad ? 0 : (uint32_t)getLE(p + 6, 2);
+	int64_t w = bad ? 0 : (int64_t)getLE(p + 8, 8);
+	if (!bad && (l < 1 || l > MAX_LEVEL || w < 1)){
+		bad = "Corrupt spatial index: ";
+	}
+	if (bad){
+		if (error){
+			*error = bad + path;
+		}
+		return false;
+	}
+
+	level = l;
+	window = w;
+	blockCount = (uint32_t)getLE(p + 16, 4);
+	entries.resize((size_t)count);
+	const uint8_t* e = p + HEADER_SIZE;
+	for (auto& x : entries){
+		x.window = (int64_t)getLE(e, 8);
+		x.cell = getLE(e + 8, 8);
+		x.block = (uint32_t)getLE(e + 16, 4);
+		e += ENTRY_SIZE;
+	}
+	return true;
+}
+
+vector<uint32_t> SpatialIndex::blocks(const BoundingBox& box, int64_t from, int64_t to) const {
+	vector<uint32_t> result;
+	if (from > to || box.south > box.north){
+		return result;
+	}
+	int64_t firstWindow = windowOf(from, window);
+	int64_t lastWindow = windowOf(to, window);
+	uint32_t y0 = row((int64_t)(box.south * NANOMINUTES_PER_DEGREE), level);
+	uint32_t y1 = row((int64_t)(box.north * NANOMINUTES_PER_DEGREE), level);
+
+	for (auto& lon : longitudeRanges(box)){
+		uint32_t x0 = column((int64_t)(lon.first * NANOMINUTES_PER_DEGREE), level);
+		uint32_t x1 = column((int64_t)(lon.second * NANOMINUTES_PER_DEGREE), level);
+		// every cell of the rectangle is between its corners in Morton order
+		uint64_t lo = morton(x0, y0);
+		uint64_t hi = morton(x1, y1);
+
+		auto it = lower_bound(entries.begin(), entries.end(), Entry{ firstWindow, lo, 0 }, before);
+		while (it != entries.end() && it->window <= lastWindow){
+			if (it->cell < lo){
+				it = lower_bound(it, entries.end(), Entry{ it->window, lo, 0 }, before);
+			}
+			else if (it->cell > hi){
+				it = lower_bound(it, entries.end(), Entry{ it->window + window, lo, 0 }, before);
+			}
+			else {
+				uint32_t x = compact(it->cell);
+				uint32_t y = compact(it->cell >> 1);
+				if (x >= x0 && x <= x1 && y >= y0 && y <= y1){
+					result.push_back(it->block);
+				}
+				it++;
+			}
+		}
+	}
+
+	sort(result.begin(), result.end());
+	result.erase(unique(result.begin(), result.end()), result.end());
+	return result;
+}
+
+size_t SpatialIndex::scan(const ArchiveReader& archive, const BoundingBox& box, int64_t from, int64_t to, const ArchiveReader::FixHandler& onFix) const {
+	size_t count = 0;
+	for (uint32_t b : blocks(box, from, to)){
+		if (b >= archive.blocks().size()){
+			break;
+		}
+		archive.readBlock(b, [&](const FixRecord& fix){
+			if (fix.time >= from && fix.time <= to && inside(box, fix)){
+				count++;
+				if (onFix){
+					onFix(fix);
+				}
+			}
+		});
+	}
+	return count;
+}
@@ -0,0 +1,530 @@
+/*
+ * TrackStore.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/TrackStore.h>
+#include <cstring>
+#include <cmath>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+
+	uint64_t zigzag(int64_t v){
+		return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+	}
+
+	int64_t unzigzag(uint64_t v){
+		return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+	}
+
+	unsigned leadingZeros(uint64_t v){
+#if defined(__GNUC__)
+		return v == 0 ? 64 : __builtin_clzll(v);
+#else
+		unsigned n = 0;
+		for (uint64_t m = 1ULL << 63; m != 0 && (v & m) == 0; m >>= 1){
+			n++;
+		}
+		return n;
+#endif
+	}
+
+	unsigned trailingZeros(uint64_t v){
+#if defined(__GNUC__)
+		return v == 0 ? 64 : __builtin_ctzll(v);
+#else
+		unsigned n = 0;
+		for (uint64_t m = 1; m != 0 && (v & m) == 0; m <<= 1){
+			n++;
+		}
+		return n;
+#endif
+	}
+
+	uint64_t doubleBits(double d){
+		uint64_t u;
+		memcpy(&u, &d, sizeof(u));
+		return u;
+	}
+
+	double bitsDouble(uint64_t u){
+		double d;
+		memcpy(&d, &u, sizeof(d));
+		return d;
+	}
+
+	const int64_t POW10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+	const double POW10D[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+	const unsigned MAX_DECIMALS = 9;
+
+	// Widths of the small value buckets, picked by a unary prefix: '0' is zero, '10' + 7 bits, '110' + 12 bits...
+	const unsigned WIDTHS[] = { 7, 12, 20, 32 };
+	const unsigned BUCKETS = sizeof(WIDTHS) / sizeof(WIDTHS[0]);
+
+	unsigned decimalZeros(int64_t v){
+		unsigned n = 0;
+		while (n < MAX_DECIMALS && v % 10 == 0){
+			v /= 10;
+			n++;
+		}
+		return n;
+	}
+
+	unsigned bitWidth(uint64_t v){
+		return 64 - leadingZeros(v);
+	}
+
+	// Writes v in the smallest bucket. Returns false if it doesn't fit in the widest one.
+	// With an escape, the all ones prefix of length BUCKETS + 1 is left to the caller.
+	bool writeSmall(BitWriter& out, int64_t v, bool escape){
+		uint64_t z = zigzag(v);
+		if (z == 0){
+			out.writeBit(false);
+			return true;
+		}
+		for (unsigned b = 0; b < BUCKETS; b++){
+			if (z < (1ULL << WIDTHS[b])){
+				out.write(~0ULL, b + 1);
+				if (escape || b + 1 < BUCKETS){
+					out.writeBit(false);
+				}
+				out.write(z, WIDTHS[b]);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Returns the bucket index + 1, 0 for zero, or BUCKETS + 1 for an escape.
+	unsigned readPrefix(BitReader& in, bool escape){
+		unsigned limit = escape ? BUCKETS + 1 : BUCKETS;
+		unsigned ones = 0;
+		while (ones < limit && in.readBit()){
+			ones++;
+		}
+		return ones;
+	}
+
+	void writeWide(BitWriter& out, int64_t v){
+		uint64_t z = zigzag(v);
+		unsigned w = bitWidth(z);
+		out.write(w, 7);
+		out.write(z, w);
+	}
+
+	int64_t readWide(BitReader& in){
+		unsigned w = (unsigned)in.read(7);
+		return unzigzag(in.read(w));
+	}
+
+	// Integer differences, in units of 10^unit. The unit only shrinks, with an escape
+	// ('11111' + 4 bits of unit + a wide value) the first time a difference needs it.
+	void writeInteger(BitWriter& out, int64_t diff, uint8_t& unit){
+		if (diff % POW10[unit] == 0 && writeSmall(out, diff / POW10[unit], true)){
+			return;
+		}
+		if (diff % POW10[unit] != 0){
+			unit = (uint8_t)decimalZeros(diff);
+		}
+		out.write(~0ULL, BUCKETS + 1);
+		out.write(unit, 4);
+		writeWide(out, diff / POW10[unit]);
+	}
+
+	int64_t readInteger(BitReader& in, uint8_t& unit){
+		unsigned b = readPrefix(in, true);
+		if (b == 0){
+			return 0;
+		}
+		if (b <= BUCKETS){
+			return unzigzag(in.read(WIDTHS[b - 1])) * POW10[unit];
+		}
+		unit = (uint8_t)in.read(4);
+		return readWide(in) * POW10[unit];
+	}
+
+	// The value as an integer count of 10^-k, if that is exact.
+	bool toDecimal(double v, unsigned k, int64_t& m){
+		double x = v * POW10D[k];
+		if (!(x < 9007199254740992.0 && x > -9007199254740992.0)){
+			return false;
+		}
+		m = llround(x);
+		return doubleBits((double)m / POW10D[k]) == doubleBits(v);
+	}
+
+	double fromDecimal(int64_t m, unsigned k){
+		return (double)m / POW10D[k];
+	}
+
+	uint8_t findDecimals(double v, int64_t& m){
+		for (unsigned k = 0; k <= MAX_DECIMALS; k++){
+			if (toDecimal(v, k, m)){
+				return (uint8_t)k;
+			}
+		}
+		return TrackStore::CodecState::RAW;
+	}
+
+	// XOR with the previous value. '0' for a repeat, '10' when the meaningful bits fit in the
+	// previous window, '11' + 6 bits of leading zeros + 6 bits of length otherwise.
+	void writeXor(BitWriter& out, uint64_t value, uint64_t previous, uint8_t& leading, uint8_t& trailing){
+		uint64_t x = value ^ previous;
+		if (x == 0){
+			out.writeBit(false);
+			return;
+		}
+		out.writeBit(true);
+		unsigned lz = leadingZeros(x);
+		unsigned tz = trailingZeros(x);
+		if (leading + trailing > 0 && lz >= leading && tz >= trailing){
+			out.writeBit(false);
+			out.write(x >> trailing, 64 - leading - trailing);
+			return;
+		}
+		unsigned length = 64 - lz - tz;
+		out.writeBit(true);
+		out.write(lz, 6);
+		out.write(length - 1, 6);
+		out.write(x >> tz, length);
+		leading = (uint8_t)lz;
+		trailing = (uint8_t)tz;
+	}
+
+	uint64_t readXor(BitReader& in, uint64_t previous, uint8_t& leading, uint8_t& trailing){
+		if (in.readBit()){
+			if (in.readBit()){
+				unsigned lz = (unsigned)in.read(6);
+				unsigned length = (unsigned)in.read(6) + 1;
+				leading = (uint8_t)lz;
+				trailing = (uint8_t)(64 - lz - length);
+			}
+			previous ^= in.read(64 - leading - trailing) << trailing;
+		}
+		return previous;
+	}
+
+	// Floating point values. In decimal mode '0' + the small delta of the scaled integer,
+	// in RAW mode '0' + the XOR. '1' + 4 bits switches the decimals, followed by the
+	// wide scaled integer or the XOR for RAW.
+	void writeFloat(BitWriter& out, TrackStore::CodecState& s, size_t i, double v){
+		const uint8_t RAW = TrackStore::CodecState::RAW;
+		uint64_t bits = doubleBits(v);
+		int64_t m;
+		uint8_t k;
+		if (s.decimals[i] != RAW && toDecimal(v, s.decimals[i], m)){
+			int64_t delta = (int64_t)((uint64_t)m - (uint64_t)s.scaled[i]);
+			if (zigzag(delta) < (1ULL << WIDTHS[BUCKETS - 1])){
+				out.writeBit(false);
+				writeSmall(out, delta, false);
+				s.scaled[i] = m;
+				s.previousBits[i] = bits;
+				return;
+			}
+			k = s.decimals[i];
+		}
+		else {
+			k = findDecimals(v, m);
+			if (k == RAW && s.decimals[i] == RAW){
+				out.writeBit(false);
+				writeXor(out, bits, s.previousBits[i], s.leading[i], s.trailing[i]);
+				s.previousBits[i] = bits;
+				return;
+			}
+		}
+
+		out.writeBit(true);
+		out.write(k, 4);
+		if (k == RAW){
+			writeXor(out, bits, s.previousBits[i], s.leading[i], s.trailing[i]);
+		}
+		else {
+			writeWide(out, m);
+			s.scaled[i] = m;
+		}
+		s.decimals[i] = k;
+		s.previousBits[i] = bits;
+	}
+
+	void readFloat(BitReader& in, TrackStore::CodecState& s, size_t i){
+		const uint8_t RAW = TrackStore::CodecState::RAW;
+		if (!in.readBit()){
+			if (s.decimals[i] != RAW){
+				unsigned b = readPrefix(in, false);
+				int64_t delta = b == 0 ? 0 : unzigzag(in.read(WIDTHS[b - 1]));
+				s.scaled[i] = (int64_t)((uint64_t)s.scaled[i] + (uint64_t)delta);
+				s.previousBits[i] = doubleBits(fromDecimal(s.scaled[i], s.decimals[i]));
+			}
+			else {
+				s.previousBits[i] = readXor(in, s.previousBits[i], s.leading[i], s.trailing[i]);
+			}
+			return;
+		}
+		uint8_t k = (uint8_t)in.read(4);
+		if (k == RAW){
+			s.previousBits[i] = readXor(in, s.previousBits[i], s.leading[i], s.trailing[i]);
+		}
+		else {
+			s.scaled[i] = readWide(in);
+			s.previousBits[i] = doubleBits(fromDecimal(s.scaled[i], k));
+		}
+		s.decimals[i] = k;
+	}
+
+	uint32_t packFlags(const FixRecord& r){
+		return (uint32_t)(uint8_t)r.status | ((uint32_t)r.quality << 8) | ((uint32_t)r.type << 16) | ((uint32_t)r.satellites << 24);
+	}
+
+	void unpackFlags(uint32_t f, FixRecord& r){
+		r.status = (char)(f & 0xFF);
+		r.quality = (uint8_t)(f >> 8);
+		r.type = (uint8_t)(f >> 16);
+		r.satellites = (uint8_t)(f >> 24);
+	}
+
+}
+
+
+
+// ------------- CODEC ----------------
+
+// Channels: the UTC time, the receive latency (receiveTime - time), latitude and longitude.
+// Only the latency is first order, the others change at a steady rate.
+static const bool SECOND_ORDER[TrackStore::CodecState::INTEGERS] = { true, false, true, true };
+
+void TrackStore::encode(BitWriter& out, CodecState& state, const FixRecord& r, bool first){
+	const int64_t ints[CodecState::INTEGERS] = { r.time, (int64_t)((uint64_t)r.receiveTime - (uint64_t)r.time), r.latitude, r.longitude };
+	const double floats[CodecState::FLOATS] = { r.altitude, r.speed, r.travelAngle, r.heading, r.roll, r.pitch, (double)r.horizontalDilution };
+	uint32_t flags = packFlags(r);
+
+	if (first){
+		state = CodecState();
+		for (size_t i = 0; i < CodecState::INTEGERS; i++){
+			out.write((uint64_t)ints[i], 64);
+			state.previous[i] = ints[i];
+			state.unit[i] = (uint8_t)decimalZeros(ints[i]);
+		}
+		for (size_t i = 0; i < CodecState::FLOATS; i++){
+			state.previousBits[i] = doubleBits(floats[i]);
+			state.decimals[i] = findDecimals(floats[i], state.scaled[i]);
+			out.write(state.previousBits[i], 64);
+		}
+		out.write(flags, 32);
+		state.flags = flags;
+		return;
+	}
+
+	for (size_t i = 0; i < CodecState::INTEGERS; i++){
+		int64_t delta = (int64_t)((uint64_t)ints[i] - (uint64_t)state.previous[i]);
+		int64_t diff = SECOND_ORDER[i] ? (int64_t)((uint64_t)delta - (uint64_t)state.delta[i]) : delta;
+		writeInteger(out, diff, state.unit[i]);
+		state.previous[i] = ints[i];
+		state.delta[i] = delta;
+	}
+	for (size_t i = 0; i < CodecState::FLOATS; i++){
+		writeFloat(out, state, i, floats[i]);
+	}
+	if (flags == state.flags){
+		out.writeBit(false);
+	}
+	else {
+		out.writeBit(true);
+		out.write(flags, 32);
+		state.flags = flags;
+	}
+}
+
+void TrackStore::decode(BitReader& in, CodecState& state, FixRecord& r, bool first){
+	if (first){
+		state = CodecState();
+		for (size_t i = 0; i < CodecState::INTEGERS; i++){
+			state.previous[i] = (int64_t)in.read(64);
+			state.unit[i] = (uint8_t)decimalZeros(state.previous[i]);
+		}
+		for (size_t i = 0; i < CodecState::FLOATS; i++){
+			state.previousBits[i] = in.read(64);
+			state.decimals[i] = findDecimals(bitsDouble(state.previousBits[i]), state.scaled[i]);
+		}
+		state.flags = (uint32_t)in.read(32);
+	}
+	else {
+		for (size_t i = 0; i < CodecState::INTEGERS; i++){
+			int64_t diff = readInteger(in, state.unit[i]);
+			state.delta[i] = SECOND_ORDER[i] ? (int64_t)((uint64_t)state.delta[i] + (uint64_t)diff) : diff;
+			state.previous[i] = (int64_t)((uint64_t)state.previous[i] + (uint64_t)state.delta[i]);
+		}
+		for (size_t i = 0; i < CodecState::FLOATS; i++){
+			readFloat(in, state, i);
+		}
+		if (in.readBit()){
+			state.flags = (uint32_t)in.read(32);
+		}
+	}
+
+	r.time = state.previous[0];
+	r.receiveTime = (int64_t)((uint64_t)state.previous[0] + (uint64_t)state.previous[1]);
+	r.latitude = state.previous[2];
+	r.longitude = state.previous[3];
+	r.altitude = bitsDouble(state.previousBits[0]);
+	r.speed = bitsDouble(state.previousBits[1]);
+	r.travelAngle = bitsDouble(state.previousBits[2]);
+	r.heading = bitsDouble(state.previousBits[3]);
+	r.roll = bitsDouble(state.previousBits[4]);
+	r.pitch = bitsDouble(state.previousBits[5]);
+	r.horizontalDilution = (float)bitsDouble(state.previousBits[6]);
+	unpackFlags(state.flags, r);
+}
+
+
+
+// ------------- TRACK STORE ----------------
+
+TrackStore::TrackStore(size_t recordsPerBlock)
+	: blockSize(recordsPerBlock == 0 ? 1 : recordsPerBlock)
+{}
+
+TrackStore::~TrackStore()
+{}
+
+bool TrackStore::append(uint32_t device, const FixRecord& record){
+	Track& track = tracks[device];
+	if (!track.blocks.empty() && record.time < track.blocks.back().lastTime){
+		return false;
+	}
+
+	bool first = track.blocks.empty() || track.blocks.back().count >= blockSize;
+	if (first){
+		if (!track.blocks.empty()){
+			track.blocks.back().data.words.shrink_to_fit();
+		}
+		track.blocks.emplace_back();
+		track.blocks.back().firstTime = record.time;
+	}
+
+	Block& block = track.blocks.back();
+	encode(block.data, track.state, record, first);
+	block.lastTime = record.time;
+	block.count++;
+	track.count++;
+	return true;
+}
+
+TrackStore::Reader TrackStore::read(uint32_t device, int64_t from, int64_t to) const {
+	Reader reader;
+	auto it = tracks.find(device);
+	if (it == tracks.end()){
+		return reader;
+	}
+	reader.track = &it->second;
+	reader.from = from;
+	reader.to = to;
+
+	// first block that may hold `from`
+	const vector<Block>& blocks = it->second.blocks;
+	size_t lo = 0;
+	size_t hi = blocks.size();
+	while (lo < hi){
+		size_t mid = lo + (hi - lo) / 2;
+		if (blocks[mid].lastTime < from){
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+	reader.block = lo;
+	reader.index = 0;
+	reader.openBlock();
+	return reader;
+}
+
+bool TrackStore::Reader::openBlock(){
+	if (track == nullptr || block >= track->blocks.size()){
+		return false;
+	}
+	const Block& b = track->blocks[block];
+	in = BitReader(b.data.words.data(), b.data.bits);
+	index = 0;
+	return true;
+}
+
+bool TrackStore::Reader::next(FixRecord& record){
+	while (track != nullptr && block < track->blocks.size()){
+		const Block& b = track->blocks[block];
+		if (b.firstTime > to){
+			break;
+		}
+		if (index >= b.count){
+			block++;
+			openBlock();
+			continue;
+		}
+		decode(in, state, record, index == 0);
+		index++;
+		if (record.time > to){
+			break;
+		}
+		if (record.time >= from){
+			return true;
+		}
+	}
+	track = nullptr;
+	return false;
+}
+
+vector<uint32_t> TrackStore::devices() const {
+	vector<uint32_t> ids;
+	ids.reserve(tracks.size());
+	for (auto& t : tracks){
+		ids.push_back(t.first);
+	}
+	return ids;
+}
+
+size_t TrackStore::size(uint32_t device) const {
+	auto it = tracks.find(device);
+	return it == tracks.end() ? 0 : it->second.count;
+}
+
+size_t TrackStore::size() const {
+	size_t n = 0;
+	for (auto& t : tracks){
+		n += t.second.count;
+	}
+	return n;
+}
+
+size_t TrackStore::memoryUsage() const {
+	size_t bytes = 0;
+	for (auto& t : tracks){
+		bytes += sizeof(Track) + t.second.blocks.capacity() * sizeof(Block);
+		for (auto& b : t.second.blocks){
+			bytes += b.data.words.capacity() * sizeof(uint64_t);
+		}
+	}
+	return bytes;
+}
+
+void TrackStore::erase(uint32_t device){
+	tracks.erase(device);
+}
+
+void TrackStore::clear(){
+	tracks.clear();
+}
+
+void TrackStore::shrink(){
+	for (auto& t : tracks){
+		t.second.blocks.shrink_to_fit();
+		for (auto& b : t.second.blocks){
+			b.data.words.shrink_to_fit();
+		}
+	}
+}
@@ -0,0 +1,221 @@
+/*
+ * UBX.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+#include <nmeaparse/UBX.h>
+#include <cstring>
+
+using namespace std;
+using namespace nmea;
+
+// ------ Some helpers ----------
+namespace {
+	const uint8_t SYNC1 = 0xB5;
+	const uint8_t SYNC2 = 0x62;
+	const uint8_t CLASS_NAV = 0x01;
+	const uint8_t NAV_PVT = 0x07;
+	const uint8_t NAV_SAT = 0x35;
+
+	uint16_t u16(const uint8_t* p)		{ return (uint16_t)(p[0] | p[1] << 8); }
+	uint32_t u32(const uint8_t* p)		{ return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24; }
+	int16_t i16(const uint8_t* p)		{ return (int16_t)u16(p); }
+	int32_t i32(const uint8_t* p)		{ return (int32_t)u32(p); }
+}
+
+
+
+// ------------- UBX SATELLITE ----------------
+
+uint32_t UBXSatellite::nmeaId() const {
+	switch (gnssId){
+	case 0:		return svId >= 1 && svId <= 32 ? svId : 0;			// GPS
+	case 1:		return svId >= 120 && svId <= 151 ? svId - 87 : 0;	// SBAS, 33-64
+	case 2:		return svId >= 1 && svId <= 36 ? 300 + svId : 0;	// Galileo, 301-336
+	case 3:		return svId >= 1 && svId <= 37 ? 400 + svId : 0;	// BeiDou, 401-437
+	case 5:		return svId >= 1 && svId <= 10 ? 192 + svId : 0;	// QZSS, 193-202
+	case 6:		return svId >= 1 && svId <= 32 ? 64 + svId : 0;		// GLONASS, 65-96
+	default:	return 0;
+	}
+}
+
+
+
+// ------------- UBX DECODER ----------------
+
+UBXDecoder::UBXDecoder(){
+	frame.reserve(256);
+}
+
+UBXDecoder::~UBXDecoder(){
+}
+
+bool UBXDecoder::step(uint8_t b){
+	size_t n = frame.size();
+	if (n == 0){
+		if (b == SYNC1){
+			frame.push_back(b);
+		}
+		return true;
+	}
+	if (n == 1 && b != SYNC2){
+		if (b != SYNC1){
+			frame.clear();
+		}
+		return true;
+	}
+	frame.push_back(b);
+	if (frame.size() == 6){
+		size_t length = u16(&frame[4]);
+		if (length > MAX_PAYLOAD){
+			errors++;
+			return false;
+		}
+		expected = length + OVERHEAD;
+	}
+	if (frame.size() >= 6 && frame.size() == expected){
+		if (!readFrame(frame.data(), frame.size())){
+			return false;
+		}
+		frame.clear();
+	}
+	return true;
+}
+
+void UBXDecoder::readByte(uint8_t b){
+	if (step(b)){
+		return;
+	}
+	// not a frame: its sync was in the data, start again from the byte after it
+	rescan.assign(frame.begin() + 1, frame.end());
+	frame.clear();
+	size_t i = 0;
+	while (i < rescan.size()){
+		if (step(rescan[i++])){
+			continue;
+		}
+		vector<uint8_t> rest(frame.begin() + 1, frame.end());
+		rest.insert(rest.end(), rescan.begin() + i, rescan.end());
+		rescan.swap(rest);
+		frame.clear();
+		i = 0;
+	}
+}
+
+void UBXDecoder::readBuffer(const uint8_t* data, size_t size){
+	for (size_t i = 0; i < size; i++){
+		readByte(data[i]);
+	}
+}
+
+bool UBXDecoder::readFrame(const uint8_t* data, size_t size){
+	if (size < OVERHEAD || data[0] != SYNC1 || data[1] != SYNC2 || u16(data + 4) != size - OVERHEAD
+		|| checksum(data + 2, size - 4) != u16(data + size - 2))
+	{
+		errors++;
+		return false;
+	}
+	frames++;
+
+	uint8_t msgClass = data[2];
+	uint8_t msgId = data[3];
+	const uint8_t* payload = data + 6;
+	size_t length = size - OVERHEAD;
+	onMessage(msgClass, msgId, payload, length);
+	if (msgClass == CLASS_NAV && msgId == NAV_PVT && decodeNavPVT(payload, length, pvt)){
+		onNavPVT(pvt);
+	}
+	else if (msgClass == CLASS_NAV && msgId == NAV_SAT && decodeNavSat(payload, length, sat)){
+		onNavSat(sat);
+	}
+	return true;
+}
+
+uint16_t UBXDecoder::checksum(const uint8_t* data, size_t size){
+	uint8_t a = 0;
+	uint8_t b = 0;
+	for (size_t i = 0; i < size; i++){
+		a += data[i];
+		b += a;
+	}
+	return (uint16_t)(a | b << 8);
+}
+
+size_t UBXDecoder::encodeFrame(uint8_t msgClass, uint8_t msgId, const uint8_t* payload, size_t size, uint8_t* buffer, size_t capacity){
+	if (size > 0xFFFF || capacity < size + OVERHEAD){
+		return 0;
+	}
+	buffer[0] = SYNC1;
+	buffer[1] = SYNC2;
+	buffer[2] = msgClass;
+	buffer[3] = msgId;
+	buffer[4] = (uint8_t)size;
+	buffer[5] = (uint8_t)(size >> 8);
+	if (size > 0){
+		memcpy(buffer + 6, payload, size);
+	}
+	uint16_t ck = checksum(buffer + 2, size + 4);
+	buffer[size + 6] = (uint8_t)ck;
+	buffer[size + 7] = (uint8_t)(ck >> 8);
+	return size + OVERHEAD;
+}
+
+bool UBXDecoder::decodeNavPVT(const uint8_t* p, size_t size, UBXNavPVT& pvt){
+	if (size < 84){
+		return false;
+	}
+	pvt.iTOW = u32(p);
+	pvt.year = u16(p + 4);
+	pvt.month = p[6];
+	pvt.day = p[7];
+	pvt.hour = p[8];
+	pvt.min = p[9];
+	pvt.sec = p[10];
+	pvt.valid = p[11];
+	pvt.tAcc = u32(p + 12);
+	pvt.nano = i32(p + 16);
+	pvt.fixType = p[20];
+	pvt.flags = p[21];
+	pvt.flags2 = p[22];
+	pvt.numSV = p[23];
+	pvt.lon = i32(p + 24);
+	pvt.lat = i32(p + 28);
+	pvt.height = i32(p + 32);
+	pvt.hMSL = i32(p + 36);
+	pvt.hAcc = u32(p + 40);
+	pvt.vAcc = u32(p + 44);
+	pvt.velN = i32(p + 48);
+	pvt.velE = i32(p + 52);
+	pvt.velD = i32(p + 56);
+	pvt.gSpeed = i32(p + 60);
+	pvt.headMot = i32(p + 64);
+	pvt.sAcc = u32(p + 68);
+	pvt.headAcc = u32(p + 72);
+	pvt.pDOP = u16(p + 76);
+	pvt.headVeh = size >= 92 ? i32(p + 84) : 0;
+	return true;
+}
+
+bool UBXDecoder::decodeNavSat(const uint8_t* p, size_t size, UBXNavSat& sat){
+	if (size < 8 || size < 8 + 12 * (size_t)p[5]){
+		return false;
+	}
+	sat.iTOW = u32(p);
+	sat.version = p[4];
+	sat.satellites.resize(p[5]);
+	for (size_t i = 0; i < sat.satellites.size(); i++){
+		const uint8_t* s = p + 8 + 12 * i;
+		UBXSatellite& out = sat.satellites[i];
+		out.gnssId = s[0];
+		out.svId = s[1];
+		out.cno = s[2];
+		out.elev = (int8_t)s[3];
+		out.azim = i16(s + 4);
+		out.prRes = i16(s + 6);
+		out.flags = u32(s + 8);
+	}
+	return true;
+}
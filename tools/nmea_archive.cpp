@@ -0,0 +1,268 @@
+/*
+ * nmea_archive.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Converts NMEA logs to binary archives (see Archive.h) and reads them back.
+//
+//     nmea_archive convert <log.txt> <out.nta> [--sentences] [--block-bytes N]
+//     nmea_archive info <file.nta>
+//     nmea_archive dump <file.nta> [from to]      (UTC, seconds since 1970)
+//     nmea_archive index <file.nta> [--level N] [--window seconds]
+//     nmea_archive within <file.nta> <south> <west> <north> <east> [from to]     (degrees)
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <limits>
+#include <algorithm>
+#include <nmeaparse/nmea.h>
+#include <nmeaparse/Archive.h>
+#include <nmeaparse/SpatialIndex.h>
+
+
+
+using namespace std;
+using namespace nmea;
+
+static int usage(){
+	cerr << "usage: nmea_archive convert <log.txt> <out.nta> [--sentences] [--block-bytes N]" << endl;
+	cerr << "       nmea_archive info <file.nta>" << endl;
+	cerr << "       nmea_archive dump <file.nta> [from to]" << endl;
+	cerr << "       nmea_archive index <file.nta> [--level N] [--window seconds]" << endl;
+	cerr << "       nmea_archive within <file.nta> <south> <west> <north> <east> [from to]" << endl;
+	return 2;
+}
+
+static int convert(int argc, char** argv){
+	if (argc < 4){
+		return usage();
+	}
+	bool sentences = false;
+	size_t blockBytes = 64 * 1024;
+	for (int i = 4; i < argc; i++){
+		string arg = argv[i];
+		if (arg == "--sentences"){
+			sentences = true;
+		}
+		else if (arg == "--block-bytes" && i + 1 < argc){
+			blockBytes = strtoul(argv[++i], nullptr, 10);
+		}
+		else {
+			return usage();
+		}
+	}
+
+	ifstream in(argv[2], ios::binary);
+	if (!in){
+		cerr << "Cannot open " << argv[2] << endl;
+		return 1;
+	}
+
+	NMEAParser parser;
+	GPSService gps(parser);
+	ArchiveWriter writer(blockBytes);
+	if (!writer.open(argv[3])){
+		cerr << "Cannot create " << argv[3] << endl;
+		return 1;
+	}
+	writer.attachToService(gps);
+	if (sentences){
+		writer.attachToParser(parser);
+	}
+
+	uint64_t inputBytes = 0;
+	string line;
+	while (getline(in, line)){
+		inputBytes += line.size() + 1;
+		if (!line.empty() && line.back() == '\r'){
+			line.pop_back();		// CRLF logs
+		}
+		try {
+			parser.readLine(line);
+		}
+		catch (NMEAParseError&){
+			// not a sentence, skip it
+		}
+	}
+	writer.close();
+
+	cout << argv[2] << ": " << inputBytes << " bytes -> " << argv[3] << ": " << writer.bytesWritten() << " bytes in "
+		<< writer.blocksWritten() << " blocks";
+	if (writer.bytesWritten() > 0){
+		cout << " (" << fixed << setprecision(1) << (double)inputBytes / writer.bytesWritten() << "x)";
+	}
+	cout << endl;
+	return 0;
+}
+
+static int info(int argc, char** argv){
+	if (argc < 3){
+		return usage();
+	}
+	ArchiveReader reader;
+	string error;
+	if (!reader.open(argv[2], &error)){
+		cerr << error << endl;
+		return 1;
+	}
+	uint64_t fixes = 0;
+	uint64_t sentences = 0;
+	size_t corrupt = 0;
+	int64_t first = numeric_limits<int64_t>::max();
+	int64_t last = numeric_limits<int64_t>::min();		// blocks of undated records have an empty range
+	for (size_t i = 0; i < reader.blocks().size(); i++){
+		const ArchiveReader::BlockInfo& b = reader.blocks()[i];
+		fixes += b.fixCount;
+		sentences += b.sentenceCount;
+		first = min(first, b.firstTime);
+		last = max(last, b.lastTime);
+		if (!reader.verify(i)){
+			corrupt++;
+		}
+	}
+	cout << reader.blocks().size() << " blocks, " << fixes << " fixes, " << sentences << " sentences" << endl;
+	if (first <= last){
+		cout << "UTC " << first << " .. " << last << " ns" << endl;
+	}
+	else if (!reader.blocks().empty()){
+		cout << "No dated records" << endl;
+	}
+	if (corrupt > 0){
+		cout << corrupt << " corrupt blocks" << endl;
+	}
+	if (reader.isTruncated()){
+		cout << "The last block is incomplete." << endl;
+	}
+	return corrupt > 0 ? 1 : 0;
+}
+
+static void printFix(const FixRecord& f){
+	cout << "FIX " << f.time << " " << f.status << " " << setprecision(7)
+		<< nanoMinutesToDegrees(f.latitude) << " " << nanoMinutesToDegrees(f.longitude) << " "
+		<< setprecision(3) << f.altitude << " m " << f.speed << " km/h " << f.travelAngle << " deg "
+		<< (int)f.satellites << " sats" << endl;
+}
+
+static int dump(int argc, char** argv){
+	if (argc != 3 && argc != 5){
+		return usage();
+	}
+	ArchiveReader reader;
+	string error;
+	if (!reader.open(argv[2], &error)){
+		cerr << error << endl;
+		return 1;
+	}
+	int64_t from = numeric_limits<int64_t>::min();
+	int64_t to = numeric_limits<int64_t>::max();
+	if (argc == 5){
+		from = (int64_t)(strtod(argv[3], nullptr) * 1e9);
+		to = (int64_t)(strtod(argv[4], nullptr) * 1e9);
+	}
+
+	cout << fixed;
+	reader.scan(from, to, printFix, [](const ArchivedSentence& s){
+		cout << "NMEA " << s.time << " " << s.text() << endl;
+	});
+	return 0;
+}
+
+static int index(int argc, char** argv){
+	if (argc < 3){
+		return usage();
+	}
+	uint32_t level = 12;
+	int64_t window = 3600LL * 1000000000;
+	for (int i = 3; i < argc; i++){
+		string arg = argv[i];
+		if (arg == "--level" && i + 1 < argc){
+			level = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--window" && i + 1 < argc){
+			window = (int64_t)(strtod(argv[++i], nullptr) * 1e9);
+		}
+		else {
+			return usage();
+		}
+	}
+
+	ArchiveReader reader;
+	string error;
+	if (!reader.open(argv[2], &error)){
+		cerr << error << endl;
+		return 1;
+	}
+	SpatialIndex index;
+	index.build(reader, level, window);
+	if (!index.save(SpatialIndex::sidecarPath(argv[2]), &error)){
+		cerr << error << endl;
+		return 1;
+	}
+	cout << index.entries.size() << " entries over " << index.blockCount << " blocks" << endl;
+	return 0;
+}
+
+static int within(int argc, char** argv){
+	if (argc != 7 && argc != 9){
+		return usage();
+	}
+	ArchiveReader reader;
+	string error;
+	if (!reader.open(argv[2], &error)){
+		cerr << error << endl;
+		return 1;
+	}
+	SpatialIndex index;
+	string sidecar = SpatialIndex::sidecarPath(argv[2]);
+	if (!index.load(sidecar) || index.blockCount != reader.blocks().size()){
+		index.build(reader);
+		index.save(sidecar);
+	}
+
+	BoundingBox box;
+	box.south = strtod(argv[3], nullptr);
+	box.west = strtod(argv[4], nullptr);
+	box.north = strtod(argv[5], nullptr);
+	box.east = strtod(argv[6], nullptr);
+	int64_t from = numeric_limits<int64_t>::min();
+	int64_t to = numeric_limits<int64_t>::max();
+	if (argc == 9){
+		from = (int64_t)(strtod(argv[7], nullptr) * 1e9);
+		to = (int64_t)(strtod(argv[8], nullptr) * 1e9);
+	}
+
+	cout << fixed;
+	size_t blocks = index.blocks(box, from, to).size();
+	size_t fixes = index.scan(reader, box, from, to, printFix);
+	cerr << fixes << " fixes from " << blocks << " of " << reader.blocks().size() << " blocks" << endl;
+	return 0;
+}
+
+int main(int argc, char** argv){
+	if (argc < 2){
+		return usage();
+	}
+	string command = argv[1];
+	if (command == "convert"){
+		return convert(argc, argv);
+	}
+	if (command == "info"){
+		return info(argc, argv);
+	}
+	if (command == "dump"){
+		return dump(argc, argv);
+	}
+	if (command == "index"){
+		return index(argc, argv);
+	}
+	if (command == "within"){
+		return within(argc, argv);
+	}
+	return usage();
+}
@@ -0,0 +1,122 @@
+/*
+ * nmea_compress.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Compresses raw NMEA streams (see Compressor.h) and restores them byte for byte.
+//
+//     nmea_compress compress <input> <output>      (- for stdin or stdout)
+//     nmea_compress decompress <input> <output>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <nmeaparse/Compressor.h>
+
+
+
+using namespace std;
+using namespace nmea;
+
+static int usage(){
+	cerr << "usage: nmea_compress compress <input> <output>" << endl;
+	cerr << "       nmea_compress decompress <input> <output>" << endl;
+	return 2;
+}
+
+static double secondsSince(chrono::steady_clock::time_point start){
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static int run(int argc, char** argv, bool compress){
+	if (argc != 4){
+		return usage();
+	}
+	ifstream inFile;
+	istream* in = &cin;
+	if (string(argv[2]) != "-"){
+		inFile.open(argv[2], ios::binary);
+		if (!inFile){
+			cerr << "Cannot open " << argv[2] << endl;
+			return 1;
+		}
+		in = &inFile;
+	}
+	ofstream outFile;
+	ostream* out = &cout;
+	bool toStdout = string(argv[3]) == "-";
+	if (!toStdout){
+		outFile.open(argv[3], ios::binary | ios::trunc);
+		if (!outFile){
+			cerr << "Cannot create " << argv[3] << endl;
+			return 1;
+		}
+		out = &outFile;
+	}
+
+	uint64_t read = 0;
+	uint64_t written = 0;
+	auto output = [&](const uint8_t* data, size_t size){
+		out->write((const char*)data, size);
+		written += size;
+	};
+	NMEACompressor compressor(output);
+	NMEADecompressor decompressor(output);
+
+	auto start = chrono::steady_clock::now();
+	string error;
+	char buffer[64 * 1024];
+	while (*in){
+		in->read(buffer, sizeof(buffer));
+		size_t n = (size_t)in->gcount();
+		read += n;
+		if (compress){
+			compressor.write(buffer, n);
+		}
+		else if (!decompressor.write(buffer, n, &error)){
+			cerr << error << endl;
+			return 1;
+		}
+	}
+	if (compress){
+		compressor.finish();
+	}
+	else if (!decompressor.finish(&error)){
+		cerr << error << endl;
+		return 1;
+	}
+	out->flush();
+	double seconds = secondsSince(start);
+
+	if (!toStdout){
+		uint64_t raw = compress ? read : written;
+		uint64_t packed = compress ? written : read;
+		cout << read << " -> " << written << " bytes";
+		if (packed > 0){
+			cout << ", ratio " << (double)raw / packed;
+		}
+		if (seconds > 0){
+			cout << ", " << raw / seconds / 1e6 << " MB/s";
+		}
+		cout << endl;
+	}
+	return 0;
+}
+
+int main(int argc, char** argv){
+	if (argc < 2){
+		return usage();
+	}
+	string command = argv[1];
+	if (command == "compress"){
+		return run(argc, argv, true);
+	}
+	if (command == "decompress"){
+		return run(argc, argv, false);
+	}
+	return usage();
+}
@@ -0,0 +1,390 @@
+/*
+ * nmea_generate.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Writes synthetic NMEA streams (see Generator.h) for benchmarks and load tests.
+//
+//     nmea_generate <output> [options]     output: a file, - for stdout, or pty for pseudo terminals
+//
+//     --devices N                  N streams: files name-1.ext, name-2.ext..., N terminals, or interleaved on stdout
+//     --epochs N                   per device (default 3600; endless for terminals)
+//     --rate HZ  --speed M/S  --turn DEG/S  --satellites N
+//     --sentences GGA,GSA,GSV,RMC,VTG,HDT,PSSN
+//     --talkers GP:3,GN:1
+//     --bad-checksums F  --truncations F  --noise F      fractions of the sentences
+//     --seed N  --lf
+//     --realtime                   paced at the rate, like a device (always for terminals)
+//     --check                      reads the GGA, RMC and VTG sentences back into a GPSService and
+//                                  checks they are written again with the same text
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <nmeaparse/Generator.h>
+#include <nmeaparse/GPSService.h>
+#include <nmeaparse/SentenceWriter.h>
+#include <nmeaparse/NumberConversion.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#endif
+
+
+
+using namespace std;
+using namespace nmea;
+
+static int usage(){
+	cerr << "usage: nmea_generate <output> [--devices N] [--epochs N] [--rate HZ] [--speed M/S] [--turn DEG/S]" << endl;
+	cerr << "                     [--satellites N] [--sentences GGA,GSA,GSV,RMC,VTG,HDT,PSSN] [--talkers GP:3,GN:1]" << endl;
+	cerr << "                     [--bad-checksums F] [--truncations F] [--noise F] [--seed N] [--lf] [--realtime] [--check]" << endl;
+	cerr << "       output: a file, - for stdout, or pty" << endl;
+	return 2;
+}
+
+// name.ext -> name-3.ext
+static string devicePath(const string& path, unsigned device){
+	size_t slash = path.find_last_of("/\\");
+	size_t dot = path.rfind('.');
+	if (dot == string::npos || (slash != string::npos && dot < slash)){
+		dot = path.size();
+	}
+	return path.substr(0, dot) + "-" + to_string(device) + path.substr(dot);
+}
+
+class Sink {
+public:
+	virtual ~Sink(){}
+	virtual bool write(const string& data) = 0;
+};
+
+class StreamSink : public Sink {
+public:
+	ostream* out;
+	ofstream file;
+
+	bool write(const string& data) override {
+		out->write(data.data(), data.size());
+		return (bool)*out;
+	}
+};
+
+#ifndef _WIN32
+// Pseudo terminal: readers open the slave side like a serial port. What they do not read in
+// time is dropped, as on a real line, and what they send is discarded.
+class TerminalSink : public Sink {
+public:
+	int master{-1};
+	int slave{-1};
+	string name;
+
+	~TerminalSink(){
+		if (slave >= 0){
+			close(slave);
+		}
+		if (master >= 0){
+			close(master);
+		}
+	}
+
+	bool open(){
+		master = posix_openpt(O_RDWR | O_NOCTTY);
+		if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0){
+			return false;
+		}
+		fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+		name = ptsname(master);
+		// kept open so the terminal stays up between readers, in raw mode for binary safety
+		slave = ::open(name.c_str(), O_RDWR | O_NOCTTY);
+		if (slave < 0){
+			return false;
+		}
+		termios mode;
+		if (tcgetattr(slave, &mode) == 0){
+			cfmakeraw(&mode);
+			tcsetattr(slave, TCSANOW, &mode);
+		}
+		return true;
+	}
+
+	bool write(const string& data) override {
+		char discard[256];
+		while (read(master, discard, sizeof(discard)) > 0){
+		}
+		if (::write(master, data.data(), data.size()) < 0){
+			// full: nobody is reading
+		}
+		return true;
+	}
+};
+#endif
+
+// Parse then write round trip of one device: the fix read from each sentence must give back
+// its text. Sentences with a bad checksum are left out.
+class RoundTripCheck {
+public:
+	NMEAParser parser;
+	GPSService gps{parser};
+	SentenceWriter writer;
+	uint64_t checked{0};
+	uint64_t differing{0};
+	string firstDifference;
+
+	RoundTripCheck(bool crlf){
+		parser.log = false;
+		writer.crlf = crlf;
+		parser.onSentence += [this](const NMEASentence& nmea){
+			good = nmea.checksumOK() && nmea.name.size() == 5;
+			name = nmea.name;
+			if (good && name.compare(2, 3, "GGA") == 0 && nmea.parameters.size() > 10){
+				tryParseDouble(nmea.parameters[10], writer.geoidSeparation);		// not kept in fixes
+			}
+		};
+	}
+
+	void read(const string& text){
+		size_t pos = 0;
+		while (pos < text.size()){
+			size_t nl = text.find('\n', pos);
+			size_t end = nl == string::npos ? text.size() : nl + 1;
+			readLine(text.substr(pos, end - pos));
+			pos = end;
+		}
+	}
+
+private:
+	string name;			// of the sentence being read
+	bool good{false};
+
+	void readLine(const string& line){
+		good = false;
+		try {
+			parser.readLine(line);
+		}
+		catch (NMEAParseError&){
+			good = false;
+		}
+		if (!good){
+			return;
+		}
+
+		char buffer[SentenceWriter::MAX_LENGTH];
+		size_t length = 0;
+		writer.talker[0] = name[0];
+		writer.talker[1] = name[1];
+		string type = name.substr(2);
+		if (type == "GGA"){
+			length = writer.writeGGA(gps.fix, buffer, sizeof(buffer));
+		}
+		else if (type == "RMC"){
+			length = writer.writeRMC(gps.fix, buffer, sizeof(buffer));
+		}
+		else if (type == "VTG"){
+			length = writer.writeVTG(gps.fix, buffer, sizeof(buffer));
+		}
+		else {
+			return;
+		}
+		checked++;
+		string sent = line.substr(min(line.rfind('$'), line.size()));		// after the noise, if any
+		if (string(buffer, length) != sent){
+			if (differing++ == 0){
+				firstDifference = sent + string(buffer, length);
+			}
+		}
+	}
+};
+
+int main(int argc, char** argv){
+	if (argc < 2){
+		return usage();
+	}
+	string output = argv[1];
+	if (output.compare(0, 2, "--") == 0){
+		return usage();			// an option, "--help"... not a file name
+	}
+	unsigned devices = 1;
+	int64_t epochs = -1;
+	uint64_t seed = 1;
+	bool realtime = false;
+	bool check = false;
+	NMEAGenerator settings;
+
+	for (int i = 2; i < argc; i++){
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--lf"){
+			settings.crlf = false;
+		}
+		else if (arg == "--realtime"){
+			realtime = true;
+		}
+		else if (arg == "--check"){
+			check = true;
+		}
+		else if (!hasValue){
+			return usage();
+		}
+		else if (arg == "--devices"){
+			devices = (unsigned)max(1L, strtol(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--epochs"){
+			epochs = strtoll(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--rate"){
+			settings.rate = strtod(argv[++i], nullptr);
+		}
+		else if (arg == "--speed"){
+			settings.speed = strtod(argv[++i], nullptr);
+		}
+		else if (arg == "--turn"){
+			settings.turnRate = strtod(argv[++i], nullptr);
+		}
+		else if (arg == "--satellites"){
+			settings.satelliteCount = (unsigned)strtoul(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--sentences"){
+			if (!NMEAGenerator::parseSentenceTypes(argv[++i], settings.sentenceTypes)){
+				cerr << "Unknown sentence types: " << argv[i] << " (GGA, GSA, GSV, RMC, VTG, HDT or PSSN)" << endl;
+				return 2;
+			}
+		}
+		else if (arg == "--talkers"){
+			if (!NMEAGenerator::parseTalkers(argv[++i], settings.talkers)){
+				cerr << "Malformed talkers: " << argv[i] << endl;
+				return 2;
+			}
+		}
+		else if (arg == "--bad-checksums"){
+			settings.badChecksums = strtod(argv[++i], nullptr);
+		}
+		else if (arg == "--truncations"){
+			settings.truncations = strtod(argv[++i], nullptr);
+		}
+		else if (arg == "--noise"){
+			settings.noise = strtod(argv[++i], nullptr);
+		}
+		else if (arg == "--seed"){
+			seed = strtoull(argv[++i], nullptr, 10);
+		}
+		else {
+			return usage();
+		}
+	}
+	if (!(settings.rate > 0.)){
+		cerr << "The rate must be positive" << endl;
+		return 2;
+	}
+
+	// the devices, a little apart from each other
+	vector<unique_ptr<NMEAGenerator>> generators;
+	const FixRecord& origin = settings.fix();
+	for (unsigned d = 0; d < devices; d++){
+		unique_ptr<NMEAGenerator> g(new NMEAGenerator(settings));
+		g->start(origin.latitude / 60e9 + 0.01 * d, origin.longitude / 60e9, origin.altitude, origin.time, seed + d);
+		generators.push_back(move(g));
+	}
+
+	vector<unique_ptr<Sink>> sinks;
+	if (output == "pty"){
+#ifdef _WIN32
+		cerr << "Pseudo terminals are not supported on this platform" << endl;
+		return 1;
+#else
+		realtime = true;
+		for (unsigned d = 0; d < devices; d++){
+			unique_ptr<TerminalSink> t(new TerminalSink);
+			if (!t->open()){
+				cerr << "Cannot open a pseudo terminal" << endl;
+				return 1;
+			}
+			cout << "device " << d + 1 << ": " << t->name << endl;
+			sinks.push_back(move(t));
+		}
+#endif
+	}
+	else if (output == "-"){
+		unique_ptr<StreamSink> s(new StreamSink);
+		s->out = &cout;
+		sinks.push_back(move(s));
+	}
+	else {
+		for (unsigned d = 0; d < devices; d++){
+			unique_ptr<StreamSink> s(new StreamSink);
+			string path = devices == 1 ? output : devicePath(output, d + 1);
+			s->file.open(path, ios::binary | ios::trunc);
+			if (!s->file){
+				cerr << "Cannot create " << path << endl;
+				return 1;
+			}
+			s->out = &s->file;
+			sinks.push_back(move(s));
+		}
+	}
+	if (epochs < 0 && output != "pty"){
+		epochs = 3600;
+	}
+
+	vector<unique_ptr<RoundTripCheck>> checks;
+	for (unsigned d = 0; check && d < devices; d++){
+		checks.emplace_back(new RoundTripCheck(settings.crlf));
+	}
+
+	auto start = chrono::steady_clock::now();
+	chrono::nanoseconds period((int64_t)(1e9 / settings.rate));
+	string text;
+	for (int64_t e = 0; epochs < 0 || e < epochs; e++){
+		if (realtime){
+			this_thread::sleep_until(start + e * period);
+		}
+		for (unsigned d = 0; d < devices; d++){
+			text.clear();
+			generators[d]->epoch(text);
+			if (!sinks[sinks.size() == 1 ? 0 : d]->write(text)){
+				cerr << "Write error" << endl;
+				return 1;
+			}
+			if (check){
+				checks[d]->read(text);
+			}
+		}
+	}
+
+	if (check){
+		uint64_t checked = 0;
+		uint64_t differing = 0;
+		for (auto& c : checks){
+			checked += c->checked;
+			differing += c->differing;
+			if (c->differing > 0){
+				cerr << "Written back differently:" << endl << c->firstDifference;
+			}
+		}
+		cerr << checked << " sentences read and written back, " << differing << " differ" << endl;
+		if (differing > 0){
+			return 1;
+		}
+	}
+
+	if (output != "-"){
+		uint64_t sentences = 0;
+		uint64_t errors = 0;
+		for (auto& g : generators){
+			sentences += g->sentenceCount();
+			errors += g->errorCount();
+		}
+		cout << sentences << " sentences, " << errors << " with errors" << endl;
+	}
+	return 0;
+}
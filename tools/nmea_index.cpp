@@ -0,0 +1,136 @@
+/*
+ * nmea_index.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Indexes NMEA logs by time and sentence type (see LogIndex.h) and reads time ranges.
+//
+//     nmea_index build <log.txt> [--granularity seconds] [--threads N]
+//     nmea_index info <log.txt>
+//     nmea_index query <log.txt> <from> <to> [type]      (UTC, seconds since 1970)
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <nmeaparse/nmea.h>
+#include <nmeaparse/LogIndex.h>
+
+
+
+using namespace std;
+using namespace nmea;
+
+static int usage(){
+	cerr << "usage: nmea_index build <log.txt> [--granularity seconds] [--threads N]" << endl;
+	cerr << "       nmea_index info <log.txt>" << endl;
+	cerr << "       nmea_index query <log.txt> <from> <to> [type]" << endl;
+	return 2;
+}
+
+static int build(int argc, char** argv){
+	if (argc < 3){
+		return usage();
+	}
+	int64_t granularity = 1000000000;
+	unsigned threads = 0;
+	for (int i = 3; i < argc; i++){
+		string arg = argv[i];
+		if (arg == "--granularity" && i + 1 < argc){
+			granularity = (int64_t)(strtod(argv[++i], nullptr) * 1e9);
+		}
+		else if (arg == "--threads" && i + 1 < argc){
+			threads = (unsigned)strtoul(argv[++i], nullptr, 10);
+		}
+		else {
+			return usage();
+		}
+	}
+
+	auto start = chrono::steady_clock::now();
+	LogIndex index;
+	string error;
+	if (!index.build(argv[2], granularity, threads, &error) || !index.save(LogIndex::sidecarPath(argv[2]), &error)){
+		cerr << error << endl;
+		return 1;
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout << argv[2] << ": " << index.logSize << " bytes, " << index.entries.size() << " entries, "
+		<< index.types.size() << " sentence types, in " << fixed << setprecision(3) << seconds << " s" << endl;
+	return 0;
+}
+
+static int info(int argc, char** argv){
+	if (argc != 3){
+		return usage();
+	}
+	LogIndex index;
+	string error;
+	if (!index.load(LogIndex::sidecarPath(argv[2]), &error)){
+		cerr << error << endl;
+		return 1;
+	}
+	cout << index.entries.size() << " entries of " << index.granularity << " ns" << endl;
+	cout << "UTC " << index.firstTime() << " .. " << index.lastTime() << " ns" << endl;
+
+	vector<uint64_t> counts(index.types.size(), 0);
+	for (auto& e : index.entries){
+		counts[e.type] += e.count;
+	}
+	for (size_t i = 0; i < index.types.size(); i++){
+		cout << index.types[i] << ": " << counts[i] << endl;
+	}
+	return 0;
+}
+
+static int query(int argc, char** argv){
+	if (argc != 5 && argc != 6){
+		return usage();
+	}
+	IndexedLogReader reader;
+	string error;
+	if (!reader.open(argv[2], &error)){
+		cerr << error << endl;
+		return 1;
+	}
+	int64_t from = (int64_t)(strtod(argv[3], nullptr) * 1e9);
+	int64_t to = (int64_t)(strtod(argv[4], nullptr) * 1e9);
+	string type = argc == 6 ? argv[5] : "";
+
+	NMEAParser parser;
+	GPSService gps(parser);
+	parser.onSentence += [](const NMEASentence& nmea){
+		cout << nmea.text << endl;
+	};
+	size_t lines = reader.read(from, to, parser, type);
+
+	cerr << lines << " lines";
+	if (gps.fix.timestamp.nanos() != 0){
+		cerr << ", last fix: " << gps.fix.timestamp.toString() << " " << fixed << setprecision(6)
+			<< gps.fix.latitude << " " << gps.fix.longitude;
+	}
+	cerr << endl;
+	return 0;
+}
+
+int main(int argc, char** argv){
+	if (argc < 2){
+		return usage();
+	}
+	string command = argv[1];
+	if (command == "build"){
+		return build(argc, argv);
+	}
+	if (command == "info"){
+		return info(argc, argv);
+	}
+	if (command == "query"){
+		return query(argc, argv);
+	}
+	return usage();
+}
@@ -0,0 +1,182 @@
+/*
+ * nmea_journal.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Records raw device data into a black box journal (see Journal.h) and reads it back.
+//
+//     nmea_journal record <journal> <input> [--capacity MB] [--channel N]     (input: file, device or - for stdin)
+//     nmea_journal info <journal>
+//     nmea_journal dump <journal> [channel]        raw bytes to stdout, exactly as received
+//     nmea_journal replay <journal> [channel]      through the parser and a GPS service
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <map>
+#include <cstdlib>
+#include <nmeaparse/nmea.h>
+#include <nmeaparse/Journal.h>
+
+
+
+using namespace std;
+using namespace nmea;
+
+static int usage(){
+	cerr << "usage: nmea_journal record <journal> <input> [--capacity MB] [--channel N]" << endl;
+	cerr << "       nmea_journal info <journal>" << endl;
+	cerr << "       nmea_journal dump <journal> [channel]" << endl;
+	cerr << "       nmea_journal replay <journal> [channel]" << endl;
+	return 2;
+}
+
+static int record(int argc, char** argv){
+	if (argc < 4){
+		return usage();
+	}
+	size_t capacity = 16 * 1024 * 1024;
+	uint16_t channel = 0;
+	for (int i = 4; i < argc; i++){
+		string arg = argv[i];
+		if (arg == "--capacity" && i + 1 < argc){
+			capacity = (size_t)(strtod(argv[++i], nullptr) * 1024 * 1024);
+		}
+		else if (arg == "--channel" && i + 1 < argc){
+			channel = (uint16_t)strtoul(argv[++i], nullptr, 10);
+		}
+		else {
+			return usage();
+		}
+	}
+
+	Journal journal;
+	string error;
+	if (!journal.open(argv[2], capacity, &error)){
+		cerr << error << endl;
+		return 1;
+	}
+	ifstream file;
+	istream* in = &cin;
+	if (string(argv[3]) != "-"){
+		file.open(argv[3], ios::binary);
+		if (!file){
+			cerr << "Cannot open " << argv[3] << endl;
+			return 1;
+		}
+		in = &file;
+	}
+
+	NMEAParser parser;
+	GPSService gps(parser);
+	journal.attachToParser(parser, channel);
+
+	// hand over what has arrived as one chunk, like a serial port read
+	uint64_t total = 0;
+	char buffer[4096];
+	while (in->read(buffer, 1)){
+		size_t n = 1 + (size_t)max((streamsize)0, in->readsome(buffer + 1, sizeof(buffer) - 1));
+		total += n;
+		try {
+			parser.readBuffer((uint8_t*)buffer, (uint32_t)n);
+		}
+		catch (NMEAParseError&){
+			// the rest of the chunk is dropped by the parser, like in any reader
+		}
+	}
+	journal.detach(parser);
+	journal.close();
+	cout << total << " bytes journaled on channel " << channel << endl;
+	return 0;
+}
+
+static int info(int argc, char** argv){
+	if (argc != 3){
+		return usage();
+	}
+	JournalReader reader;
+	string error;
+	if (!reader.open(argv[2], &error)){
+		cerr << error << endl;
+		return 1;
+	}
+	map<uint16_t, pair<uint64_t, uint64_t>> channels;		// records, bytes
+	for (auto& r : reader.records()){
+		channels[r.channel].first++;
+		channels[r.channel].second += r.size;
+	}
+	cout << reader.records().size() << " records" << endl;
+	if (!reader.records().empty()){
+		cout << "sequence " << reader.records().front().sequence << " .. " << reader.records().back().sequence
+			<< ", UTC " << reader.records().front().utc << " .. " << reader.records().back().utc << " ns" << endl;
+	}
+	for (auto& c : channels){
+		cout << "channel " << c.first << ": " << c.second.first << " records, " << c.second.second << " bytes" << endl;
+	}
+	return 0;
+}
+
+static int dump(int argc, char** argv){
+	if (argc != 3 && argc != 4){
+		return usage();
+	}
+	JournalReader reader;
+	string error;
+	if (!reader.open(argv[2], &error)){
+		cerr << error << endl;
+		return 1;
+	}
+	int channel = argc == 4 ? atoi(argv[3]) : -1;
+	for (auto& r : reader.records()){
+		if (channel < 0 || r.channel == channel){
+			cout.write((const char*)r.data, r.size);
+		}
+	}
+	return 0;
+}
+
+static int replay(int argc, char** argv){
+	if (argc != 3 && argc != 4){
+		return usage();
+	}
+	JournalReader reader;
+	string error;
+	if (!reader.open(argv[2], &error)){
+		cerr << error << endl;
+		return 1;
+	}
+	NMEAParser parser;
+	GPSService gps(parser);
+	uint64_t sentences = 0;
+	parser.onSentence += [&sentences](const NMEASentence&){
+		sentences++;
+	};
+	uint64_t bytes = reader.replay(parser, argc == 4 ? atoi(argv[3]) : -1);
+	cout << bytes << " bytes, " << sentences << " sentences" << endl;
+	cout << gps.fix.toString() << endl;
+	return 0;
+}
+
+int main(int argc, char** argv){
+	if (argc < 2){
+		return usage();
+	}
+	string command = argv[1];
+	if (command == "record"){
+		return record(argc, argv);
+	}
+	if (command == "info"){
+		return info(argc, argv);
+	}
+	if (command == "dump"){
+		return dump(argc, argv);
+	}
+	if (command == "replay"){
+		return replay(argc, argv);
+	}
+	return usage();
+}
@@ -0,0 +1,109 @@
+/*
+ * nmea_replay.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ *  See the license file included with this source.
+ */
+
+// Replays NMEA logs into parsers and GPS services, paced like the recording or as fast
+// as possible (see Replay.h), and reports the throughput.
+//
+//     nmea_replay <log.txt>... [--speed X | --fast] [--receive-time] [--parsers N] [--threads N] [--echo]
+//
+// --parsers N replays each log into N parsers. --echo writes the sentences of the first
+// stream to stdout, paced, to feed another program.
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+#include <nmeaparse/nmea.h>
+#include <nmeaparse/Replay.h>
+
+
+
+using namespace std;
+using namespace nmea;
+
+static int usage(){
+	cerr << "usage: nmea_replay <log.txt>... [--speed X | --fast] [--receive-time] [--parsers N] [--threads N] [--echo]" << endl;
+	return 2;
+}
+
+int main(int argc, char** argv){
+	ReplayEngine engine;
+	vector<string> logs;
+	size_t parsersPerLog = 1;
+	bool echo = false;
+	for (int i = 1; i < argc; i++){
+		string arg = argv[i];
+		if (arg == "--speed" && i + 1 < argc){
+			engine.speed = strtod(argv[++i], nullptr);
+		}
+		else if (arg == "--fast"){
+			engine.pacing = ReplayEngine::Pacing::None;
+		}
+		else if (arg == "--receive-time"){
+			engine.pacing = ReplayEngine::Pacing::ReceiveTime;
+		}
+		else if (arg == "--parsers" && i + 1 < argc){
+			parsersPerLog = max((size_t)1, (size_t)strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--threads" && i + 1 < argc){
+			engine.threads = (unsigned)strtoul(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--echo"){
+			echo = true;
+		}
+		else if (arg.size() > 2 && arg.compare(0, 2, "--") == 0){
+			return usage();
+		}
+		else {
+			logs.push_back(arg);
+		}
+	}
+	if (logs.empty()){
+		return usage();
+	}
+
+	vector<unique_ptr<NMEAParser>> parsers;
+	vector<unique_ptr<GPSService>> services;
+	for (auto& log : logs){
+		for (size_t i = 0; i < parsersPerLog; i++){
+			parsers.emplace_back(new NMEAParser);
+			services.emplace_back(new GPSService(*parsers.back()));
+			string error;
+			if (!engine.add(log, *parsers.back(), &error)){
+				cerr << error << endl;
+				return 1;
+			}
+			services.back()->setClock(engine.clock(engine.streams() - 1));
+		}
+	}
+	if (echo){
+		parsers[0]->onSentence += [](const NMEASentence& nmea){
+			cout << nmea.text << endl;
+		};
+	}
+
+	auto start = chrono::steady_clock::now();
+	engine.run();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cerr << engine.streams() << " streams, " << engine.linesReplayed() << " lines, " << engine.bytesReplayed() << " bytes in "
+		<< fixed << setprecision(3) << seconds << " s";
+	if (seconds > 0){
+		cerr << " (" << setprecision(0) << engine.linesReplayed() / seconds << " lines/s, "
+			<< setprecision(1) << engine.bytesReplayed() / seconds / 1e6 << " MB/s)";
+	}
+	cerr << endl;
+
+	GPSFix& fix = services[0]->fix;
+	cerr << "Last fix of the first stream: " << fix.timestamp.toString() << ", "
+		<< fix.timeSinceLastUpdate().count() << " s old at the end of the log" << endl;
+	return 0;
+}